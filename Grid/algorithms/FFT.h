@@ -66,6 +66,12 @@ public:
   inline static void fftw_destroy_plan(const FFTW_plan p) {
     ::fftw_destroy_plan(p);
   }
+  inline static FFTW_scalar *fftw_malloc(size_t n) {
+    return (FFTW_scalar *) ::fftw_malloc(n*sizeof(FFTW_scalar));
+  }
+  inline static void fftw_free(FFTW_scalar *p) {
+    ::fftw_free(p);
+  }
 };
 
 template<> struct FFTW<ComplexF> {
@@ -93,6 +99,54 @@ public:
   inline static void fftw_destroy_plan(const FFTW_plan p) {
     ::fftwf_destroy_plan(p);
   }
+  inline static FFTW_scalar *fftw_malloc(size_t n) {
+    return (FFTW_scalar *) ::fftwf_malloc(n*sizeof(FFTW_scalar));
+  }
+  inline static void fftw_free(FFTW_scalar *p) {
+    ::fftwf_free(p);
+  }
+};
+
+//////////////////////////////////////////////////////////////////////
+// Plans are measured once and reused for every FFT of the same shape.
+// A plan transforms the Ncomp interleaved components of one pencil of
+// length G held in a block of Stride scalars. Blocks are padded to a
+// multiple of 64 bytes so every pencil in a buffer has the alignment
+// the plan was measured with, as required by fftw_execute_dft.
+//////////////////////////////////////////////////////////////////////
+template<class scalar> class FFTPlanCache {
+public:
+  typedef typename FFTW<scalar>::FFTW_scalar FFTW_scalar;
+  typedef typename FFTW<scalar>::FFTW_plan   FFTW_plan;
+
+  static int Stride(int G,int Ncomp) {
+    int pad = 64/sizeof(FFTW_scalar);
+    return ((G*Ncomp+pad-1)/pad)*pad;
+  }
+
+  static FFTW_plan Plan(int G,int Ncomp,int sign) {
+    static std::map<std::vector<int>,FFTW_plan> cache;
+    std::vector<int> key({G,Ncomp,sign});
+    auto it = cache.find(key);
+    if ( it != cache.end() ) return it->second;
+
+    int rank = 1;  /* 1d transforms */
+    int n[] = {G}; /* 1d transforms of length G */
+    int howmany = Ncomp;
+    int idist   = 1, odist   = 1;     /* Distance between consecutive FT's */
+    int istride = Ncomp, ostride = Ncomp; /* distance between two elements in the same FT */
+    int *inembed = n, *onembed = n;
+
+    // FFTW_MEASURE overwrites its arrays, so plan on scratch
+    FFTW_scalar *scratch = FFTW<scalar>::fftw_malloc(Stride(G,Ncomp));
+    FFTW_plan p = FFTW<scalar>::fftw_plan_many_dft(rank,n,howmany,
+						   scratch,inembed,istride,idist,
+						   scratch,onembed,ostride,odist,
+						   sign,FFTW_MEASURE);
+    FFTW<scalar>::fftw_free(scratch);
+    cache[key] = p;
+    return p;
+  }
 };
 
 #endif
@@ -106,7 +160,6 @@ class FFT {
 private:
     
   GridCartesian *vgrid;
-  GridCartesian *sgrid;
     
   int Nd;
   double flops;
@@ -116,6 +169,9 @@ private:
   Coordinate dimensions;
   Coordinate processors;
   Coordinate processor_coor;
+
+  // Communicators along each distributed dimension, made on first use
+  std::vector<CartesianCommunicator *> rowcomm;
     
 public:
     
@@ -131,16 +187,17 @@ public:
     Nd(grid->_ndimension),
     dimensions(grid->_fdimensions),
     processors(grid->_processors),
-    processor_coor(grid->_processor_coor)
+    processor_coor(grid->_processor_coor),
+    rowcomm(grid->_ndimension,nullptr)
   {
     flops=0;
     usec =0;
-    Coordinate layout(Nd,1);
-    sgrid = new GridCartesian(dimensions,layout,processors,*grid);
   };
     
   ~FFT ( void)  {
-    delete sgrid;
+    for(size_t d=0;d<rowcomm.size();d++){
+      if ( rowcomm[d] ) delete rowcomm[d];
+    }
   }
     
   template<class vobj>
@@ -164,7 +221,19 @@ public:
     FFT_dim_mask(result,source,mask,sign);
   }
 
-
+  //////////////////////////////////////////////////////////////////////
+  // Distributed 1d FFT along dim by a pencil transpose.
+  //
+  // The O sites orthogonal to dim on each node are cut into P chunks of
+  // C sites, P = processors[dim]. One all-to-all among the P nodes of a
+  // row leaves each holding the full length G pencils of its own chunk;
+  // these are transformed locally and the same all-to-all returns them.
+  // Each node moves its field once, rather than P times round a barrel
+  // shift, and does 1/P of the transforms rather than all of them.
+  //
+  // Pack/unpack to and from SIMD layout uses the vectorised lexicographic
+  // (un)vectorize; buffers are indexed [rank][chunk site][local coor].
+  //////////////////////////////////////////////////////////////////////
   template<class vobj>
   void FFT_dim(Lattice<vobj> &result,const Lattice<vobj> &source,int dim, int sign){
 #ifndef HAVE_FFTW
@@ -173,120 +242,111 @@ public:
     conformable(result.Grid(),vgrid);
     conformable(source.Grid(),vgrid);
 
-    int L = vgrid->_ldimensions[dim];
-    int G = vgrid->_fdimensions[dim];
-      
-    Coordinate layout(Nd,1);
-    Coordinate pencil_gd(vgrid->_fdimensions);
-      
-    pencil_gd[dim] = G*processors[dim];
-      
-    // Pencil global vol LxLxGxLxL per node
-    GridCartesian pencil_g(pencil_gd,layout,processors,*vgrid);
-      
-    // Construct pencils
     typedef typename vobj::scalar_object sobj;
     typedef typename sobj::scalar_type   scalar;
-      
-    Lattice<sobj> pgbuf(&pencil_g);
-    autoView(pgbuf_v , pgbuf, CpuWrite);
-
     typedef typename FFTW<scalar>::FFTW_scalar FFTW_scalar;
     typedef typename FFTW<scalar>::FFTW_plan   FFTW_plan;
-      
-    int Ncomp = sizeof(sobj)/sizeof(scalar);
+
+    const int L = vgrid->_ldimensions[dim];
+    const int G = vgrid->_fdimensions[dim];
+    const int P = processors[dim];
+    const int Ncomp = sizeof(sobj)/sizeof(scalar);
+
     int Nlow  = 1;
-    for(int d=0;d<dim;d++){
-      Nlow*=vgrid->_ldimensions[d];
-    }
-      
-    int rank = 1;  /* 1d transforms */
-    int n[] = {G}; /* 1d transforms of length G */
-    int howmany = Ncomp;
-    int odist,idist,istride,ostride;
-    idist   = odist   = 1;          /* Distance between consecutive FT's */
-    istride = ostride = Ncomp*Nlow; /* distance between two elements in the same FT */
-    int *inembed = n, *onembed = n;
-      
+    int Nhigh = 1;
+    for(int d=0;d<dim;d++)    Nlow *=vgrid->_ldimensions[d];
+    for(int d=dim+1;d<Nd;d++) Nhigh*=vgrid->_ldimensions[d];
+    const uint64_t O = Nlow*Nhigh;   // orthogonal sites per node
+    const uint64_t C = (O+P-1)/P;    // orthogonal sites per chunk
+    const int me= processor_coor[dim];
+
     scalar div;
     if ( sign == backward ) div = 1.0/G;
     else if ( sign == forward ) div = 1.0;
     else assert(0);
-      
-    FFTW_plan p;
-    {
-      FFTW_scalar *in = (FFTW_scalar *)&pgbuf_v[0];
-      FFTW_scalar *out= (FFTW_scalar *)&pgbuf_v[0];
-      p = FFTW<scalar>::fftw_plan_many_dft(rank,n,howmany,
-					   in,inembed,
-					   istride,idist,
-					   out,onembed,
-					   ostride, odist,
-					   sign,FFTW_ESTIMATE);
+
+    FFTW_plan p   = FFTPlanCache<scalar>::Plan(G,Ncomp,sign);
+    int    Stride = FFTPlanCache<scalar>::Stride(G,Ncomp);
+
+    if ( (P>1) && (rowcomm[dim]==nullptr) ) {
+      Coordinate row(Nd,1);
+      row[dim] = P;
+      int srank;
+      rowcomm[dim] = new CartesianCommunicator(row,*vgrid,srank);
     }
-      
-    // Barrel shift and collect global pencil
-    Coordinate lcoor(Nd), gcoor(Nd);
-    result = source;
-    int pc = processor_coor[dim];
-    for(int p=0;p<processors[dim];p++) {
-      {
-	autoView(r_v,result,CpuRead);
-	autoView(p_v,pgbuf,CpuWrite);
-	thread_for(idx, sgrid->lSites(),{
-          Coordinate cbuf(Nd);
-          sobj s;
-	  sgrid->LocalIndexToLocalCoor(idx,cbuf);
-	  peekLocalSite(s,r_v,cbuf);
-	  cbuf[dim]+=((pc+p) % processors[dim])*L;
-	  pokeLocalSite(s,p_v,cbuf);
-        });
+
+    // SIMD layout -> [chunk][chunk site][l]
+    std::vector<sobj> lex;
+    unvectorizeToLexOrdArray(lex,source);
+
+    std::vector<sobj> sendbuf(P*C*L);
+    std::vector<sobj> recvbuf(P*C*L);
+    thread_for(o, P*C, {
+      if ( o < O ) {
+	int low  = o % Nlow;
+	int high = o / Nlow;
+	for(int l=0;l<L;l++){
+	  sendbuf[o*L+l] = lex[low+Nlow*(l+L*high)];
+	}
       }
-      if (p != processors[dim] - 1) {
-	result = Cshift(result,dim,L);
+    });
+
+    if ( P>1 ) rowcomm[dim]->AllToAll(&sendbuf[0],&recvbuf[0],C*L,sizeof(sobj));
+    else       recvbuf.swap(sendbuf);
+
+    // [rank][chunk site][l] -> padded pencils of length G = P*L
+    FFTW_scalar *pencil = FFTW<scalar>::fftw_malloc((size_t)C*Stride);
+    thread_for(c, C, {
+      sobj *pc = (sobj *)&pencil[(size_t)c*Stride];
+      for(int q=0;q<P;q++){
+	for(int l=0;l<L;l++){
+	  pc[q*L+l] = recvbuf[(q*C+c)*L+l];
+	}
       }
-    }
-      
-    // Loop over orthog coords
-    int NN=pencil_g.lSites();
+    });
+
+    uint64_t Cme = (O > me*C) ? std::min(C,O-me*C) : 0; // the last chunk may be short
     GridStopWatch timer;
     timer.Start();
-    thread_for( idx,NN,{
-        Coordinate cbuf(Nd);
-	pencil_g.LocalIndexToLocalCoor(idx, cbuf);
-	if ( cbuf[dim] == 0 ) {  // restricts loop to plane at lcoor[dim]==0
-	  FFTW_scalar *in = (FFTW_scalar *)&pgbuf_v[idx];
-	  FFTW_scalar *out= (FFTW_scalar *)&pgbuf_v[idx];
-	  FFTW<scalar>::fftw_execute_dft(p,in,out);
-	}
+    thread_for(c, Cme, {
+      FFTW_scalar *pc = &pencil[(size_t)c*Stride];
+      FFTW<scalar>::fftw_execute_dft(p,pc,pc);
+      if ( sign == backward ) {
+	scalar *sc = (scalar *)pc;
+	for(int i=0;i<G*Ncomp;i++) sc[i] = sc[i]*div;
+      }
     });
     timer.Stop();
-      
+
     // performance counting
     double add,mul,fma;
     FFTW<scalar>::fftw_flops(p,&add,&mul,&fma);
     flops_call = add+mul+2.0*fma;
     usec += timer.useconds();
-    flops+= flops_call*NN;
-      
-    // writing out result
-    {
-      autoView(pgbuf_v,pgbuf,CpuRead);
-      autoView(result_v,result,CpuWrite);
-      thread_for(idx,sgrid->lSites(),{
-	Coordinate clbuf(Nd), cgbuf(Nd);
-	sobj s;
-	sgrid->LocalIndexToLocalCoor(idx,clbuf);
-	cgbuf = clbuf;
-	cgbuf[dim] = clbuf[dim]+L*pc;
-	peekLocalSite(s,pgbuf_v,cgbuf);
-	pokeLocalSite(s,result_v,clbuf);
-      });
-    }
-    result = result*div;
-      
-    // destroying plan
-    FFTW<scalar>::fftw_destroy_plan(p);
+    flops+= flops_call*Cme;
+
+    // and back along the same route
+    thread_for(c, C, {
+      sobj *pc = (sobj *)&pencil[(size_t)c*Stride];
+      for(int q=0;q<P;q++){
+	for(int l=0;l<L;l++){
+	  recvbuf[(q*C+c)*L+l] = pc[q*L+l];
+	}
+      }
+    });
+    FFTW<scalar>::fftw_free(pencil);
+
+    if ( P>1 ) rowcomm[dim]->AllToAll(&recvbuf[0],&sendbuf[0],C*L,sizeof(sobj));
+    else       sendbuf.swap(recvbuf);
+
+    thread_for(o, O, {
+      int low  = o % Nlow;
+      int high = o / Nlow;
+      for(int l=0;l<L;l++){
+	lex[low+Nlow*(l+L*high)] = sendbuf[o*L+l];
+      }
+    });
+    vectorizeFromLexOrdArray(lex,result);
 #endif
   }
 };
@@ -0,0 +1,315 @@
+/*************************************************************************************
+
+    Grid physics library, www.github.com/paboyle/Grid
+
+    Source file: CompressedDeflation.h
+
+    Copyright (C) 2023
+
+Author: Peter Boyle <pboyle@bnl.gov>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+    See the full license in the file "LICENSE" in the top level distribution directory
+*************************************************************************************/
+/*  END LEGAL */
+#pragma once
+
+NAMESPACE_BEGIN(Grid);
+
+/* Compressed storage of local coherence eigenvectors
+
+   evec_i(x) = sum_v  c_i^v(X) b_v(x)      X = block containing x
+
+   Basis     b_v  : nbasis fine fields, fp32 or fp16
+   Coeffs    c_i  : N coarse fields, fp32
+
+   Fine eigenvectors are never formed. Deflation works in the coarse space
+
+   guess = P sum_i c_i <c_i|P^dag src> / lambda_i
+
+   with P^dag a block projection and P a block promotion. Both stream the
+   basis one vector at a time, expanding fp16 to fp32 on the fly, so the
+   fine memory is nbasis compressed vectors plus two fp32 work fields.
+   The N coarse inner products share a single GlobalSumVector.
+
+   Write/Read go through BinaryIO in parallel: one file of fp32 basis
+   records, one of coefficient records, and an xml file of evals and
+   checksums.
+*/
+template<class FobjF,class CComplexF,int nbasis>
+class CompressedLocalCoherenceEigenvectors
+{
+public:
+  typedef iVector<CComplexF,nbasis>   CoarseSiteVector;
+  typedef Lattice<CoarseSiteVector>   CoarseField;
+  typedef Lattice<iScalar<CComplexF> > CoarseScalar;
+  typedef Lattice<FobjF>              FineField;
+  typedef typename FobjF::scalar_object sobj;
+  typedef typename CoarseSiteVector::scalar_object csobj;
+
+  GridBase *_FineGrid;
+  GridBase *_CoarseGrid;
+  bool      half;
+  int       _checkerboard;
+
+  std::vector<FineField>   basis;      // fp32 basis, empty if half
+  deviceVector<vRealH>     basis_h;    // nbasis x oSites x words_h fp16 basis
+  std::vector<CoarseField> evec_coarse;
+  std::vector<RealD>       eval;
+
+  static constexpr int words_f = sizeof(FobjF)/sizeof(vRealF);
+  static constexpr int words_h = words_f/2;
+
+  CompressedLocalCoherenceEigenvectors(GridBase *FineGrid,GridBase *CoarseGrid,bool _half=false)
+    : _FineGrid(FineGrid), _CoarseGrid(CoarseGrid), half(_half), _checkerboard(0)
+  {
+    static_assert((words_f&0x1)==0,"fp16 packing requires an even number of SIMD words per site");
+  };
+
+  int Nevec(void) const { return eval.size(); }
+
+  ////////////////////////////////////////////
+  // fp16 <-> fp32 per basis vector
+  ////////////////////////////////////////////
+  void CompressBasisVector(const FineField &b,int v)
+  {
+    uint64_t osites = _FineGrid->oSites();
+    vRealH *h_p = &basis_h[(uint64_t)v*osites*words_h];
+    autoView( b_v, b, AcceleratorRead);
+    accelerator_for(ss,osites,1,{
+      precisionChange(&h_p[ss*words_h],(vRealF *)&b_v[ss],words_f);
+    });
+  }
+  void ExpandBasisVector(FineField &b,int v) const
+  {
+    uint64_t osites = _FineGrid->oSites();
+    const vRealH *h_p = &basis_h[(uint64_t)v*osites*words_h];
+    autoView( b_v, b, AcceleratorWrite);
+    accelerator_for(ss,osites,1,{
+      precisionChange((vRealF *)&b_v[ss],&h_p[ss*words_h],words_f);
+    });
+  }
+  // Reference to basis vector v; in fp16 mode expanded into tmp
+  const FineField & BasisVector(int v,FineField &tmp) const
+  {
+    if ( !half ) return basis[v];
+    ExpandBasisVector(tmp,v);
+    return tmp;
+  }
+
+  ////////////////////////////////////////////
+  // Import from the full precision output of LocalCoherenceLanczos
+  ////////////////////////////////////////////
+  template<class FineFieldD,class CoarseFieldD>
+  void Compress(const std::vector<FineFieldD>   &subspace,
+		const std::vector<CoarseFieldD> &evec,
+		const std::vector<RealD>        &evals)
+  {
+    assert(subspace.size()==nbasis);
+    assert(evec.size()==evals.size());
+    _checkerboard = subspace[0].Checkerboard();
+
+    FineField tmp(_FineGrid);
+    if ( half ) {
+      basis.clear();
+      basis_h.resize((uint64_t)nbasis*_FineGrid->oSites()*words_h);
+    } else {
+      basis.resize(nbasis,_FineGrid);
+    }
+    for(int v=0;v<nbasis;v++){
+      precisionChange(tmp,subspace[v]);
+      if ( half ) CompressBasisVector(tmp,v);
+      else        basis[v] = tmp;
+    }
+    if ( !half ) for(int v=0;v<nbasis;v++) basis[v].Checkerboard() = _checkerboard;
+
+    evec_coarse.resize(evec.size(),_CoarseGrid);
+    for(int i=0;i<evec.size();i++){
+      precisionChange(evec_coarse[i],evec[i]);
+    }
+    eval = evals;
+
+    RealD fine_bytes   = (half ? 2.0 : 4.0)*nbasis*_FineGrid->gSites()*words_f*vRealF::Nsimd();
+    RealD coarse_bytes = 1.0*evec.size()*_CoarseGrid->gSites()*sizeof(csobj);
+    std::cout << GridLogMessage << "CompressedLocalCoherenceEigenvectors: "<<evec.size()<<" evecs in "
+	      << (fine_bytes+coarse_bytes)/1024./1024./1024. <<" GB ("<<(half?"fp16":"fp32")<<" basis)"<<std::endl;
+  }
+
+  ////////////////////////////////////////////
+  // src_c = P^dag src, one streamed pass per basis vector.
+  // The basis is block orthonormal so plain projection suffices.
+  ////////////////////////////////////////////
+  void Project(CoarseField &src_c,const FineField &src) const
+  {
+    FineField    tmp(_FineGrid);
+    CoarseScalar ip(_CoarseGrid);
+    tmp.Checkerboard() = _checkerboard;
+    for(int v=0;v<nbasis;v++){
+      const FineField &b = BasisVector(v,tmp);
+      blockInnerProductD(ip,b,src);
+      autoView( src_c_ , src_c, AcceleratorWrite);
+      autoView( ip_    , ip,    AcceleratorRead);
+      accelerator_for( sc, _CoarseGrid->oSites(), CComplexF::Nsimd(), {
+	convertType(src_c_[sc](v),ip_[sc]);
+      });
+    }
+  }
+  // fine = P guess_c
+  void Promote(const CoarseField &guess_c,FineField &fine) const
+  {
+    FineField tmp(_FineGrid);
+    tmp.Checkerboard()  = _checkerboard;
+    fine.Checkerboard() = _checkerboard;
+    fine = Zero();
+    for(int v=0;v<nbasis;v++){
+      const FineField &b = BasisVector(v,tmp);
+      CoarseScalar ip = PeekIndex<0>(guess_c,v);
+      blockZAXPY(fine,ip,b,fine);
+    }
+  }
+
+  ////////////////////////////////////////////
+  // Deflated guess for a single precision source
+  ////////////////////////////////////////////
+  void Deflate(const FineField &src,FineField &guess) const
+  {
+    int N = Nevec();
+    CoarseField src_c  (_CoarseGrid);
+    CoarseField guess_c(_CoarseGrid);
+
+    Project(src_c,src);
+
+    std::vector<ComplexD> ip(N);
+    for(int i=0;i<N;i++) ip[i] = rankInnerProduct(evec_coarse[i],src_c);
+    _CoarseGrid->GlobalSumVector(&ip[0],N);
+
+    guess_c = Zero();
+    for(int i=0;i<N;i++){
+      ComplexF c(real(ip[i])/eval[i],imag(ip[i])/eval[i]);
+      axpy(guess_c,c,evec_coarse[i],guess_c);
+    }
+
+    guess.Checkerboard() = src.Checkerboard();
+    Promote(guess_c,guess);
+  }
+
+  // Expand eigenvector i, for testing or export
+  void getFineEvecEval(FineField &evec,RealD &_eval,int i) const
+  {
+    Promote(evec_coarse[i],evec);
+    _eval = eval[i];
+  }
+
+  ////////////////////////////////////////////
+  // Parallel I/O
+  ////////////////////////////////////////////
+  void Write(const std::string &stem)
+  {
+    uint32_t nersc_csum,scidac_csuma,scidac_csumb;
+    auto munge = [](sobj &in,sobj &out){ out = in; };
+    auto cmunge= [](csobj &in,csobj &out){ out = in; };
+    std::vector<uint32_t> csum;
+
+    FineField tmp(_FineGrid);
+    uint64_t fine_record = (uint64_t)_FineGrid->gSites()*sizeof(sobj);
+    for(int v=0;v<nbasis;v++){
+      FineField &b = const_cast<FineField &>(BasisVector(v,tmp));
+      BinaryIO::writeLatticeObject<FobjF,sobj>(b,stem+".basis",munge,v*fine_record,"IEEE32BIG",
+					       nersc_csum,scidac_csuma,scidac_csumb);
+      csum.push_back(scidac_csuma);
+      csum.push_back(scidac_csumb);
+    }
+    uint64_t coarse_record = (uint64_t)_CoarseGrid->gSites()*sizeof(csobj);
+    for(int i=0;i<Nevec();i++){
+      BinaryIO::writeLatticeObject<CoarseSiteVector,csobj>(evec_coarse[i],stem+".coarse",cmunge,i*coarse_record,"IEEE32BIG",
+							   nersc_csum,scidac_csuma,scidac_csumb);
+      csum.push_back(scidac_csuma);
+      csum.push_back(scidac_csumb);
+    }
+    if ( _FineGrid->IsBoss() ) {
+      XmlWriter WRx(stem+".xml");
+      write(WRx,"evals",eval);
+      write(WRx,"checksums",csum);
+    }
+    _FineGrid->Barrier();
+  }
+
+  void Read(const std::string &stem,int checkerboard)
+  {
+    _checkerboard = checkerboard;
+    uint32_t nersc_csum,scidac_csuma,scidac_csumb;
+    auto munge = [](sobj &in,sobj &out){ out = in; };
+    auto cmunge= [](csobj &in,csobj &out){ out = in; };
+    std::vector<uint32_t> csum;
+    {
+      XmlReader RDx(stem+".xml");
+      read(RDx,"evals",eval);
+      read(RDx,"checksums",csum);
+    }
+    int N = eval.size();
+    assert(csum.size()==2*(nbasis+N));
+
+    FineField tmp(_FineGrid);
+    tmp.Checkerboard() = checkerboard;
+    if ( half ) {
+      basis.clear();
+      basis_h.resize((uint64_t)nbasis*_FineGrid->oSites()*words_h);
+    } else {
+      basis.resize(nbasis,_FineGrid);
+    }
+    uint64_t fine_record = (uint64_t)_FineGrid->gSites()*sizeof(sobj);
+    for(int v=0;v<nbasis;v++){
+      FineField &b = half ? tmp : basis[v];
+      BinaryIO::readLatticeObject<FobjF,sobj>(b,stem+".basis",munge,v*fine_record,"IEEE32BIG",
+					      nersc_csum,scidac_csuma,scidac_csumb);
+      assert(scidac_csuma==csum[2*v] && scidac_csumb==csum[2*v+1]);
+      b.Checkerboard() = checkerboard;
+      if ( half ) CompressBasisVector(tmp,v);
+    }
+    evec_coarse.resize(N,_CoarseGrid);
+    uint64_t coarse_record = (uint64_t)_CoarseGrid->gSites()*sizeof(csobj);
+    for(int i=0;i<N;i++){
+      BinaryIO::readLatticeObject<CoarseSiteVector,csobj>(evec_coarse[i],stem+".coarse",cmunge,i*coarse_record,"IEEE32BIG",
+							  nersc_csum,scidac_csuma,scidac_csumb);
+      assert(scidac_csuma==csum[2*(nbasis+i)] && scidac_csumb==csum[2*(nbasis+i)+1]);
+    }
+  }
+};
+
+////////////////////////////////////////////
+// Drop in for LocalCoherenceDeflatedGuesser on a compressed store.
+// The source is deflated in single precision.
+////////////////////////////////////////////
+template<class FineField,class Compressed>
+class CompressedLocalCoherenceDeflatedGuesser: public LinearFunction<FineField> {
+private:
+  const Compressed &evecs;
+public:
+  using LinearFunction<FineField>::operator();
+
+  CompressedLocalCoherenceDeflatedGuesser(const Compressed &_evecs) : evecs(_evecs) {};
+
+  void operator()(const FineField &src,FineField &guess) {
+    typename Compressed::FineField src_f(evecs._FineGrid);
+    typename Compressed::FineField guess_f(evecs._FineGrid);
+    precisionChange(src_f,src);
+    evecs.Deflate(src_f,guess_f);
+    precisionChange(guess,guess_f);
+    guess.Checkerboard() = src.Checkerboard();
+  }
+};
+
+NAMESPACE_END(Grid);
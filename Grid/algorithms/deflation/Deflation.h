@@ -52,22 +52,47 @@ public:
 ////////////////////////////////
 // Fine grid deflation
 ////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+// The multi-source form packs the sources once and streams the basis
+// through MultiRHSDeflation EvecBatch vectors at a time: the full
+// N x nrhs matrix evec^dag src is accumulated by GEMM with one global
+// sum, and the guesses are rebuilt by a second GEMM pass. The packed
+// basis lives only for the duration of one call, so it can neither go
+// stale if evec is modified nor hold a second copy of the basis.
+////////////////////////////////////////////////////////////////////////
 template<class Field>
 class DeflatedGuesser: public LinearFunction<Field> {
 private:
+  typedef typename Field::scalar_type scalar;
+
   const std::vector<Field> &evec;
   const std::vector<RealD> &eval;
   const unsigned int       N;
 
+  MultiRHSDeflation<Field> MRD;
+  int                      MRD_ev0; // first evec held in MRD during a call, -1 if none
+
+  void ImportBatch(int ev0,int nev)
+  {
+    if ( (MRD_ev0==ev0) && (MRD.nev==nev) ) return;
+    MRD.Allocate(nev,evec[0].Grid());
+    for(int e=0;e<nev;e++){
+      MRD.ImportEigenVector(evec[ev0+e],eval[ev0+e],e);
+    }
+    MRD_ev0 = ev0;
+  }
+
 public:
   using LinearFunction<Field>::operator();
 
+  int EvecBatch = 128; // evecs packed at a time by the multi-source guess
+
   DeflatedGuesser(const std::vector<Field> & _evec,const std::vector<RealD> & _eval)
   : DeflatedGuesser(_evec, _eval, _evec.size())
   {}
 
   DeflatedGuesser(const std::vector<Field> & _evec, const std::vector<RealD> & _eval, const unsigned int _N)
-  : evec(_evec), eval(_eval), N(_N)
+  : evec(_evec), eval(_eval), N(_N), MRD_ev0(-1)
   {
     assert(evec.size()==eval.size());
     assert(N <= evec.size());
@@ -81,6 +106,71 @@ public:
     }
     guess.Checkerboard() = src.Checkerboard();
   }
+
+  virtual void operator()(const std::vector<Field> &src,std::vector<Field> &guess) {
+    int nrhs = src.size();
+    assert(guess.size()==nrhs);
+    if ( (nrhs==0) || (N==0) ) {
+      for(int r=0;r<nrhs;r++) {
+	guess[r] = Zero();
+	guess[r].Checkerboard() = src[r].Checkerboard();
+      }
+      return;
+    }
+    GridBase *grid = evec[0].Grid();
+    conformable(src[0],evec[0]);
+
+    RealD t0 = usecond();
+    MRD_ev0 = -1;
+    int batch = (EvecBatch > 0) ? std::min((int)N,EvecBatch) : N;
+    int nbatch= (N+batch-1)/batch;
+
+    ////////////////////////////////////////////
+    // C_er = evec^dag src, local then one global sum
+    ////////////////////////////////////////////
+    std::vector<scalar> C(N*nrhs);
+    std::vector<scalar> Cb;
+    for(int b=0;b<nbatch;b++){
+      int ev0 = b*batch;
+      int nev = std::min(batch,(int)N-ev0);
+      ImportBatch(ev0,nev);
+      if ( b==0 ) MRD.ImportSources(src);
+      MRD.LocalCoefficients(Cb,nrhs);
+      for(int r=0;r<nrhs;r++){
+	for(int e=0;e<nev;e++){
+	  C[ev0+e+N*r] = Cb[e+nev*r];
+	}
+      }
+    }
+    RealD t1 = usecond();
+    grid->GlobalSumVector(&C[0],N*nrhs);
+    RealD t2 = usecond();
+
+    ////////////////////////////////////////////
+    // G = evec C / lambda, last batch first to reuse what is packed
+    ////////////////////////////////////////////
+    for(int b=nbatch-1;b>=0;b--){
+      int ev0 = b*batch;
+      int nev = std::min(batch,(int)N-ev0);
+      ImportBatch(ev0,nev);
+      Cb.resize(nev*nrhs);
+      for(int r=0;r<nrhs;r++){
+	for(int e=0;e<nev;e++){
+	  Cb[e+nev*r] = C[ev0+e+N*r] * scalar(1.0/eval[ev0+e]);
+	}
+      }
+      MRD.Reconstruct(Cb,nrhs,(b==nbatch-1) ? scalar(0.0) : scalar(1.0));
+    }
+    MRD.ExportGuess(guess);
+    for(int r=0;r<nrhs;r++) guess[r].Checkerboard() = src[r].Checkerboard();
+
+    // Drop the packed basis; evec may change before the next call
+    MRD.Deallocate();
+    MRD_ev0 = -1;
+    RealD t3 = usecond();
+    std::cout << GridLogPerformance << "DeflatedGuesser "<<nrhs<<" sources, "<<N<<" evecs in "<<nbatch<<" batches: "
+	      << " project "<<(t1-t0)/1e3<<" ms gsum "<<(t2-t1)/1e3<<" ms reconstruct "<<(t3-t2)/1e3<<" ms"<<std::endl;
+  }
 };
 
 template<class FineField, class CoarseField>
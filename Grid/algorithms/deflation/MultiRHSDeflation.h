@@ -95,7 +95,7 @@ public:
     BLAS_E.resize (vol * words * nev );
     std::cout << GridLogMessage << " Allocate for "<<nev<<" eigenvectors and volume "<<vol<<std::endl;
   }
-  void ImportEigenVector(Field &evec,RealD &_eval, int ev)
+  void ImportEigenVector(const Field &evec,const RealD &_eval, int ev)
   {
     //    std::cout << " ev " <<ev<<" eval "<<_eval<< std::endl;
     assert(ev<eval.size());
@@ -106,12 +106,12 @@ public:
     acceleratorCopyDeviceToDevice(&v[0],&BLAS_E[offset],sizeof(scalar_object)*vol);
 
   }
-  void ImportEigenBasis(std::vector<Field> &evec,std::vector<RealD> &_eval)
+  void ImportEigenBasis(const std::vector<Field> &evec,const std::vector<RealD> &_eval)
   {
     ImportEigenBasis(evec,_eval,0,evec.size());
   }
   // Could use to import a batch of eigenvectors
-  void ImportEigenBasis(std::vector<Field> &evec,std::vector<RealD> &_eval, int _ev0, int _nev)
+  void ImportEigenBasis(const std::vector<Field> &evec,const std::vector<RealD> &_eval, int _ev0, int _nev)
   {
     assert(_ev0+_nev<=evec.size());
 
@@ -123,32 +123,6 @@ public:
       ImportEigenVector(evec[_ev0+e],_eval[_ev0+e],e);
     }
   }
-  void DeflateSources(std::vector<Field> &source,std::vector<Field> & guess)
-  {
-    int nrhs = source.size();
-    assert(source.size()==guess.size());
-    assert(grid == guess[0].Grid());
-    conformable(guess[0],source[0]);
-
-    int64_t vw = vol * words;
-
-    RealD t0 = usecond();
-    BLAS_R.resize(nrhs * vw); // cost free if size doesn't change
-    BLAS_G.resize(nrhs * vw); // cost free if size doesn't change
-    BLAS_C.resize(nev * nrhs);// cost free if size doesn't change
-
-    /////////////////////////////////////////////
-    // Copy in the multi-rhs sources
-    /////////////////////////////////////////////
-    //    for(int r=0;r<nrhs;r++){
-    //      std::cout << " source["<<r<<"] = "<<norm2(source[r])<<std::endl;
-    //    }
-    for(int r=0;r<nrhs;r++){
-      int64_t offset = r*vw;
-      autoView(v,source[r],AcceleratorRead);
-      acceleratorCopyDeviceToDevice(&v[0],&BLAS_R[offset],sizeof(scalar_object)*vol);
-    }
-
   /*
    * in Fortran column major notation (cuBlas order)
    *
@@ -159,21 +133,41 @@ public:
    * C_er = E^dag R
    * C_er = C_er / lambda_e 
    * G_xr = Exe Cer
+   *
+   * The steps are exposed separately so that a basis too large to
+   * import at once can be streamed through in batches, accumulating
+   * the local C_er of every batch before a single global sum.
    */
+  void ImportSources(const std::vector<Field> &source)
+  {
+    int nrhs = source.size();
+    assert(grid == source[0].Grid());
+    int64_t vw = vol * words;
+    BLAS_R.resize(nrhs * vw); // cost free if size doesn't change
+    for(int r=0;r<nrhs;r++){
+      int64_t offset = r*vw;
+      autoView(v,source[r],AcceleratorRead);
+      acceleratorCopyDeviceToDevice(&v[0],&BLAS_R[offset],sizeof(scalar_object)*vol);
+    }
+  }
+  // Rank local C_er = E^dag R for the imported basis, nev x nrhs column major
+  void LocalCoefficients(std::vector<scalar> &HOST_C,int nrhs)
+  {
+    int64_t vw = vol * words;
+    assert(BLAS_R.size()==nrhs*vw);
+    BLAS_C.resize(nev * nrhs);// cost free if size doesn't change
+
     deviceVector<scalar *> Ed(1);
     deviceVector<scalar *> Rd(1);
     deviceVector<scalar *> Cd(1);
-    deviceVector<scalar *> Gd(1);
 
     scalar * Eh = & BLAS_E[0];
     scalar * Rh = & BLAS_R[0];
     scalar * Ch = & BLAS_C[0];
-    scalar * Gh = & BLAS_G[0];
 
     acceleratorPut(Ed[0],Eh);
     acceleratorPut(Rd[0],Rh);
     acceleratorPut(Cd[0],Ch);
-    acceleratorPut(Gd[0],Gh);
 
     GridBLAS BLAS;
 
@@ -189,22 +183,32 @@ public:
 		     Cd);
     BLAS.synchronise();
 
-    assert(BLAS_C.size()==nev*nrhs);
-
-    std::vector<scalar> HOST_C(BLAS_C.size());      // nrhs . nev -- the coefficients 
+    HOST_C.resize(BLAS_C.size());      // nrhs . nev -- the coefficients 
     acceleratorCopyFromDevice(&BLAS_C[0],&HOST_C[0],BLAS_C.size()*sizeof(scalar));
-    grid->GlobalSumVector(&HOST_C[0],nev*nrhs);
-    for(int e=0;e<nev;e++){
-      RealD lam(1.0/eval[e]);
-      for(int r=0;r<nrhs;r++){
-	int off = e+nev*r;
-	HOST_C[off]=HOST_C[off] * lam;
-	//	std::cout << "C["<<e<<"]["<<r<<"] ="<<HOST_C[off]<< " eval[e] "<<eval[e] <<std::endl;
-      }
-    }
+  }
+  // G_xr = beta G_xr + Exe Cer for the imported basis
+  void Reconstruct(std::vector<scalar> &HOST_C,int nrhs,scalar beta)
+  {
+    int64_t vw = vol * words;
+    assert(HOST_C.size()==nev*nrhs);
+    BLAS_G.resize(nrhs * vw); // cost free if size doesn't change
+    BLAS_C.resize(nev * nrhs);// cost free if size doesn't change
     acceleratorCopyToDevice(&HOST_C[0],&BLAS_C[0],BLAS_C.size()*sizeof(scalar));
 
-    
+    deviceVector<scalar *> Ed(1);
+    deviceVector<scalar *> Cd(1);
+    deviceVector<scalar *> Gd(1);
+
+    scalar * Eh = & BLAS_E[0];
+    scalar * Ch = & BLAS_C[0];
+    scalar * Gh = & BLAS_G[0];
+
+    acceleratorPut(Ed[0],Eh);
+    acceleratorPut(Cd[0],Ch);
+    acceleratorPut(Gd[0],Gh);
+
+    GridBLAS BLAS;
+
     /////////////////////////////////////////
     // Guess G_xr = Exe Cer
     /////////////////////////////////////////
@@ -213,18 +217,47 @@ public:
 		     scalar(1.0),
 		     Ed, // x . nev
 		     Cd, // nev . nrhs
-		     scalar(0.0),
+		     beta,
 		     Gd);
     BLAS.synchronise();
-
-    ///////////////////////////////////////
-    // Copy out the multirhs
-    ///////////////////////////////////////
+  }
+  void ExportGuess(std::vector<Field> &guess)
+  {
+    int nrhs = guess.size();
+    int64_t vw = vol * words;
+    assert(BLAS_G.size()==nrhs*vw);
     for(int r=0;r<nrhs;r++){
       int64_t offset = r*vw;
       autoView(v,guess[r],AcceleratorWrite);
       acceleratorCopyDeviceToDevice(&BLAS_G[offset],&v[0],sizeof(scalar_object)*vol);
     }
+  }
+  void DeflateSources(const std::vector<Field> &source,std::vector<Field> & guess)
+  {
+    int nrhs = source.size();
+    assert(source.size()==guess.size());
+    assert(grid == guess[0].Grid());
+    conformable(guess[0],source[0]);
+
+    RealD t0 = usecond();
+
+    ImportSources(source);
+
+    std::vector<scalar> HOST_C;
+    LocalCoefficients(HOST_C,nrhs);
+    assert(HOST_C.size()==nev*nrhs);
+    grid->GlobalSumVector(&HOST_C[0],nev*nrhs);
+    for(int e=0;e<nev;e++){
+      RealD lam(1.0/eval[e]);
+      for(int r=0;r<nrhs;r++){
+	int off = e+nev*r;
+	HOST_C[off]=HOST_C[off] * lam;
+      }
+    }
+
+    Reconstruct(HOST_C,nrhs,scalar(0.0)); // wipe out G
+
+    ExportGuess(guess);
     RealD t1 = usecond();
     std::cout << GridLogMessage << "MultiRHSDeflation for "<<nrhs<<" sources with "<<nev<<" eigenvectors took " << (t1-t0)/1e3 <<" ms"<<std::endl;
   }
@@ -63,6 +63,7 @@ class BiCGSTAB : public OperatorFunction<Field>
 
       RealD cp(0), rho(1), rho_prev(0), alpha(1), beta(0), omega(1);
       RealD a(0), bo(0), b(0), ssq(0);
+      ComplexD Crho;
 
       Field p(src);
       Field r(src);
@@ -113,9 +114,11 @@ class BiCGSTAB : public OperatorFunction<Field>
         rho_prev = rho;
 
         LinalgTimer.Start();
-        InnerTimer.Start();
-        ComplexD Crho  = innerProduct(rhat,r);
-        InnerTimer.Stop();
+        if ( k == 1 ) {
+          InnerTimer.Start();
+          Crho = innerProduct(rhat,r);
+          InnerTimer.Stop();
+        }
         rho = Crho.real();
 
         beta = (rho / rho_prev) * (alpha / omega);
@@ -144,20 +147,11 @@ class BiCGSTAB : public OperatorFunction<Field>
         alpha = rho / Calpha.real();
 
         LinearCombTimer.Start();
-	{
-	  autoView( p_v , p, AcceleratorRead);
-	  autoView( r_v , r, AcceleratorRead);
-	  autoView( v_v , v, AcceleratorRead);
-	  autoView( psi_v,psi, AcceleratorRead);
-	  autoView( h_v  ,  h, AcceleratorWrite);
-	  autoView( s_v  ,  s, AcceleratorWrite);
-	  accelerator_for(ss, h_v.size(), Field::vector_object::Nsimd(),{
-	      coalescedWrite(h_v[ss], alpha*p_v(ss) + psi_v(ss));
-	    });
-	  accelerator_for(ss, s_v.size(), Field::vector_object::Nsimd(),{
-	      coalescedWrite(s_v[ss], -alpha*v_v(ss) + r_v(ss));
- 	  });
-        }
+        // h = psi + alpha p ; s = r - alpha v
+        linearCombination(std::vector<Field *>({&h,&s}),
+			  std::vector<const Field *>({&psi,&p,&r,&v}),
+			  std::vector<RealD>({1.0,alpha,0.0,0.0,
+			                      0.0,0.0,1.0,-alpha}));
         LinearCombTimer.Stop();
         LinalgTimer.Stop();
 
@@ -166,26 +160,30 @@ class BiCGSTAB : public OperatorFunction<Field>
         MatrixTimer.Stop();
 
         LinalgTimer.Start();
+        // <t,s> and |t|^2 in one message
         InnerTimer.Start();
-        ComplexD Comega = innerProduct(t,s);
+        GlobalSumBatch red_ts(src.Grid());
+        int ts = innerProductBegin(red_ts,t,s);
+        int tt = norm2Begin(red_ts,t);
+        red_ts.Sum();
         InnerTimer.Stop();
-        omega = Comega.real() / norm2(t);
+        omega = red_ts[ts].real() / red_ts[tt].real();
 
+        // psi = h + omega s ; r = s - omega t with |r|^2 and the next
+        // iteration's <rhat,r> summed in the same sweep and one message
         LinearCombTimer.Start();
-	{
-	  autoView( psi_v,psi, AcceleratorWrite);
-	  autoView( r_v , r, AcceleratorWrite);
-	  autoView( h_v , h, AcceleratorRead);
-	  autoView( s_v , s, AcceleratorRead);
-	  autoView( t_v , t, AcceleratorRead);
-	  accelerator_for(ss, psi_v.size(), Field::vector_object::Nsimd(),{
-	      coalescedWrite(psi_v[ss], h_v(ss) + omega * s_v(ss));
-	      coalescedWrite(r_v[ss], -omega * t_v(ss) + s_v(ss));
-	    });
-	}
+        std::vector<std::pair<int,int> > prods;
+        prods.push_back(std::make_pair(1,1)); // |r|^2
+        prods.push_back(std::make_pair(5,1)); // <rhat,r>
+        std::vector<ComplexD> red_r;
+        linearCombination(std::vector<Field *>({&psi,&r}),
+			  std::vector<const Field *>({&h,&s,&t,&rhat}),
+			  std::vector<RealD>({1.0,omega,0.0,0.0,
+			                      0.0,1.0,-omega,0.0}),
+			  prods,red_r);
         LinearCombTimer.Stop();
-	
-        cp = norm2(r);
+        cp   = red_r[0].real();
+        Crho = red_r[1];
         LinalgTimer.Stop();
 
         std::cout << GridLogIterative << "BiCGSTAB: Iteration " << k << " residual " << sqrt(cp/ssq) << " target " << Tolerance << std::endl;
@@ -53,6 +53,9 @@ NAMESPACE_BEGIN(Grid);
 
     //Option to speed up *inner single precision* solves using a LinearFunction that produces a guess
     LinearFunction<FieldF> *guesser;
+
+    //Option to replace the inner single precision CG, eg by PipelinedConjugateGradient
+    ConjugateGradient<FieldF> *inner_solver;
     
     MixedPrecisionConjugateGradient(RealD tol, 
 				    Integer maxinnerit, 
@@ -62,11 +65,17 @@ NAMESPACE_BEGIN(Grid);
 				    LinearOperatorBase<FieldD> &_Linop_d) :
       Linop_f(_Linop_f), Linop_d(_Linop_d),
       Tolerance(tol), InnerTolerance(tol), MaxInnerIterations(maxinnerit), MaxOuterIterations(maxouterit), SinglePrecGrid(_sp_grid),
-      OuterLoopNormMult(100.), guesser(NULL){ };
+      OuterLoopNormMult(100.), guesser(NULL), inner_solver(NULL){ };
 
     void useGuesser(LinearFunction<FieldF> &g){
       guesser = &g;
     }
+
+    // The inner solver keeps its own MaxIterations and ErrorOnNoConverge;
+    // its Tolerance is set per outer iteration and restored on exit
+    void useInnerSolver(ConjugateGradient<FieldF> &cg){
+      inner_solver = &cg;
+    }
   
   void operator() (const FieldD &src_d_in, FieldD &sol_d){
     std::cout << GridLogMessage << "MixedPrecisionConjugateGradient: Starting mixed precision CG with outer tolerance " << Tolerance << " and inner tolerance " << InnerTolerance << std::endl;
@@ -100,8 +109,13 @@ NAMESPACE_BEGIN(Grid);
     sol_f.Checkerboard() = cb;
     
     std::cout<<GridLogMessage<<"MixedPrecisionConjugateGradient: Starting initial inner CG with tolerance " << inner_tol << std::endl;
-    ConjugateGradient<FieldF> CG_f(inner_tol, MaxInnerIterations);
-    CG_f.ErrorOnNoConverge = false;
+    ConjugateGradient<FieldF> CG_default(inner_tol, MaxInnerIterations, false);
+    ConjugateGradient<FieldF> &CG_f = inner_solver ? *inner_solver : CG_default;
+    RealD user_inner_tol = CG_f.Tolerance;
+    if ( inner_solver ) {
+      std::cout<<GridLogMessage<<"MixedPrecisionConjugateGradient: using supplied inner solver with MaxIterations "
+	       << CG_f.MaxIterations << " ErrorOnNoConverge " << CG_f.ErrorOnNoConverge << std::endl;
+    }
 
     GridStopWatch InnerCGtimer;
 
@@ -150,6 +164,7 @@ NAMESPACE_BEGIN(Grid);
       
       axpy(sol_d, 1.0, tmp_d, sol_d);
     }
+    CG_f.Tolerance = user_inner_tol;
     
     //Final trial CG
     std::cout<<GridLogMessage<<"MixedPrecisionConjugateGradient: Starting final patch-up double-precision solve"<<std::endl;
@@ -203,27 +203,38 @@ public:
     for (k=1;k<=MaxIterations;k++){
     
       a = c /cp;
+
+      // One pass loads r once and updates p and every live ps[s]:
+      //   p = a p + r ; ps[0] = a ps[0] + r ; ps[s] = z[s] r + as ps[s]
     AXPYTimer.Start();
-      axpy(p,a,p,r);
-    AXPYTimer.Stop();
-    
-      // Note to self - direction ps is iterated seperately
-      // for each shift. Does not appear to have any scope
-      // for avoiding linear algebra in "single" case.
-      // 
-      // However SAME r is used. Could load "r" and update
-      // ALL ps[s]. 2/3 Bandwidth saving
-      // New Kernel: Load r, vector of coeffs, vector of pointers ps
-    AXPYTimer.Start();
-      for(int s=0;s<nshift;s++){
-	if ( ! converged[s] ) { 
-	  if (s==0){
-	    axpy(ps[s],a,ps[s],r);
-	  } else{
-	    RealD as =a *z[s][iz]*bs[s] /(z[s][1-iz]*b);
-	    axpby(ps[s],z[s][iz],as,r,ps[s]);
+      {
+	std::vector<Field *>       out({&p});
+	std::vector<const Field *> in ({&p,&r});
+	std::vector<RealD>         A;
+	for(int s=0;s<nshift;s++){
+	  if ( ! converged[s] ) { 
+	    out.push_back(&ps[s]);
+	    in.push_back(&ps[s]);
 	  }
 	}
+	int nin=in.size();
+	A.assign(out.size()*nin,0.0);
+	A[0*nin+0]=a;
+	A[0*nin+1]=1.0;
+	for(int s=0,o=1;s<nshift;s++){
+	  if ( ! converged[s] ) { 
+	    if (s==0){
+	      A[o*nin+1]   =1.0;
+	      A[o*nin+1+o] =a;
+	    } else {
+	      RealD as =a *z[s][iz]*bs[s] /(z[s][1-iz]*b);
+	      A[o*nin+1]   =z[s][iz];
+	      A[o*nin+1+o] =as;
+	    }
+	    o++;
+	  }
+	}
+	linearCombination(out,in,A);
       }
     AXPYTimer.Stop();
     
@@ -232,24 +243,25 @@ public:
     //Linop.HermOpAndNorm(p,mmp,d,qq); // d is used
     // The below is faster on KNL
     Linop.HermOp(p,mmp); 
-    d=real(innerProduct(p,mmp));
-    
     MatrixTimer.Stop();  
 
+      // mmp += m[0] p and d = <p,mmp> in the same pass
     AXPYTimer.Start();
-      axpy(mmp,mass[0],p,mmp);
+      {
+	std::vector<ComplexD> dot;
+	linearCombination(std::vector<Field *>({&mmp}),
+			  std::vector<const Field *>({&mmp,&p}),
+			  std::vector<RealD>({1.0,mass[0]}),
+			  std::vector<std::pair<int,int> >(1,std::make_pair(2,0)),dot);
+	d = real(dot[0]);
+      }
     AXPYTimer.Stop();
-      RealD rn = norm2(p);
-      d += rn*mass[0];
     
       bp=b;
       b=-cp/d;
-    
-    AXPYTimer.Start();
-      c=axpy_norm(r,b,mmp,r);
-    AXPYTimer.Stop();
 
-      // Toggle the recurrence history
+      // Toggle the recurrence history; the shift coefficients need
+      // only a, b, bp so are known before the residual update
       bs[0] = b;
       iz = 1-iz;
     ShiftTimer.Start();
@@ -263,26 +275,37 @@ public:
 	}
       }
     ShiftTimer.Stop();
-    
-      for(int s=0;s<nshift;s++){
-	int ss = s;
-	// Scope for optimisation here in case of "single".
-	// Could load psi[0] and pull all ps[s] in.
-	//      if ( single ) ss=primary;
-	// Bandwith saving in single case is Ls * 3 -> 2+Ls, so ~ 3x saving
-	// Pipelined CG gain:
-	//
-	// New Kernel: Load r, vector of coeffs, vector of pointers ps
-	// New Kernel: Load psi[0], vector of coeffs, vector of pointers ps
-	// If can predict the coefficient bs then we can fuse these and avoid write reread cyce
-	//  on ps[s].
-	// Before:  3 x npole  + 3 x npole
-	// After :  2 x npole (ps[s])        => 3x speed up of multishift CG.
-      
-	if( (!converged[s]) ) { 
-	  axpy(psi[ss],-bs[s]*alpha[s],ps[s],psi[ss]);
+
+      // r += b mmp, c = |r|^2 and psi[s] -= bs[s] alpha[s] ps[s] fused
+      //  Before:  3 x npole (ps)  + 3 x npole (psi)
+      //  After :  2 x npole (ps) + 2 x npole (psi) in one sweep
+    AXPYTimer.Start();
+      {
+	std::vector<Field *>       out({&r});
+	std::vector<const Field *> in ({&r,&mmp});
+	std::vector<int>           live;
+	for(int s=0;s<nshift;s++){
+	  if ( ! converged[s] ) { 
+	    out.push_back(&psi[s]);
+	    in.push_back(&psi[s]);
+	    in.push_back(&ps[s]);
+	    live.push_back(s);
+	  }
 	}
+	int nin=in.size();
+	std::vector<RealD> A(out.size()*nin,0.0);
+	A[0]=1.0;
+	A[1]=b;
+	for(int o=1;o<out.size();o++){
+	  int s = live[o-1];
+	  A[o*nin+2*o]   = 1.0;
+	  A[o*nin+2*o+1] = -bs[s]*alpha[s];
+	}
+	std::vector<ComplexD> rr;
+	linearCombination(out,in,A,std::vector<std::pair<int,int> >(1,std::make_pair(0,0)),rr);
+	c = real(rr[0]);
       }
+    AXPYTimer.Stop();
     
       // Convergence checks
       int all_converged = 1;
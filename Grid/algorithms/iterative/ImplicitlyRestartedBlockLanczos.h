@@ -38,22 +38,6 @@ Author: Chulwoo Jung <chulwoo@bnl.gov>
 #undef USE_LAPACK
 #define Glog std::cout << GridLogMessage 
 
-#ifdef GRID_CUDA
-#include "cublas_v2.h"
-#endif
-
-#if 0
-#define  CUDA_COMPLEX cuDoubleComplex
-#define  CUDA_FLOAT double
-#define  MAKE_CUDA_COMPLEX make_cuDoubleComplex
-#define  CUDA_GEMM cublasZgemm
-#else
-#define  CUDA_COMPLEX cuComplex
-#define  CUDA_FLOAT float
-#define  MAKE_CUDA_COMPLEX make_cuComplex
-#define  CUDA_GEMM cublasCgemm
-#endif
-
 namespace Grid {
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -142,17 +126,25 @@ private:
   /////////////////////////
   // BLAS objects
   /////////////////////////
-#ifdef GRID_CUDA
-  cudaError_t cudaStat;
-  CUDA_COMPLEX *w_acc, *evec_acc, *c_acc;
-#endif
-  int Nevec_acc; // Number of eigenvectors stored in the buffer evec_acc
+  // The Krylov basis is mirrored as Nm packed columns of vw scalars in
+  // SIMD layout, so overlaps with and rotations of the whole basis are
+  // GEMMs through GridBLAS. Columns [0,blas_k) match evec. This doubles
+  // the basis memory, so it is only used when blas_ortho is set.
+  typedef typename Field::scalar_type   scalar;
+  typedef typename Field::scalar_object scalar_object;
+  deviceVector<scalar> BLAS_E;  // Nm x vw -- the basis
+  deviceVector<scalar> BLAS_W;  // Nu x vw -- the new block / rotated block
+  deviceVector<scalar> BLAS_C;  // Nm x Nu -- overlaps / rotation coefficients
+  uint64_t vol;
+  uint64_t vw;
+  int blas_k;
   
   /////////////////////////
   // Constructor
   /////////////////////////
 public:       
  int split_test; //test split in the first iteration
+ int blas_ortho; // reorthogonalise and rotate the basis with GEMMs; mirrors all Nm vectors
  ImplicitlyRestartedBlockLanczos(LinearOperatorBase<Field> &Linop, // op
  				LinearOperatorBase<Field> &SLinop, // op
 				GridRedBlackCartesian * FrbGrid,
@@ -174,7 +166,7 @@ public:
       //eresid(_eresid),  MaxIter(10),
       eresid(_eresid),  MaxIter(_MaxIter),
       diagonalisation(_diagonalisation),split_test(0),
-      Nevec_acc(_Nu)
+      blas_ortho(0), vol(0), vw(0), blas_k(0)
   { assert( (Nk%Nu==0) && (Nm%Nu==0) ); };
 
   ////////////////////////////////
@@ -229,94 +221,140 @@ public:
   }
 
 
+  ////////////////////////////////
+  // BLAS-3 basis operations
+  ////////////////////////////////
+  void AllocateBLAS(GridBase *grid)
+  {
+    vol = grid->lSites();
+    vw  = vol * (sizeof(scalar_object)/sizeof(scalar));
+    BLAS_E.resize(Nm*vw);
+    BLAS_W.resize(Nu*vw);
+    BLAS_C.resize(Nm*Nu);
+    blas_k = 0;
+  }
+  void DeallocateBLAS(void)
+  {
+    BLAS_E.resize(0);
+    BLAS_W.resize(0);
+    BLAS_C.resize(0);
+    blas_k = 0;
+  }
+  void InvalidateBasis(int k) { blas_k = std::min(blas_k,k); }
+  void ImportBasis(std::vector<Field>& evec, int R)
+  {
+    for(int k=blas_k;k<R;k++){
+      autoView(v,evec[k],AcceleratorRead);
+      acceleratorCopyDeviceToDevice(&v[0],&BLAS_E[k*vw],sizeof(scalar_object)*vol);
+    }
+    blas_k = std::max(blas_k,R);
+  }
+  void ImportBlock(std::vector<Field>& w, int n)
+  {
+    for(int u=0;u<n;u++){
+      autoView(v,w[u],AcceleratorRead);
+      acceleratorCopyDeviceToDevice(&v[0],&BLAS_W[u*vw],sizeof(scalar_object)*vol);
+    }
+  }
+  void ExportBlock(std::vector<Field>& w, int w0, int n, int cb)
+  {
+    for(int u=0;u<n;u++){
+      w[w0+u].Checkerboard() = cb;
+      autoView(v,w[w0+u],AcceleratorWrite);
+      acceleratorCopyDeviceToDevice(&BLAS_W[u*vw],&v[0],sizeof(scalar_object)*vol);
+    }
+  }
+
+  // w -= E E^dag w over the first R basis vectors, twice (CGS2).
+  // One GlobalSumVector per pass replaces R*Nu innerProduct reductions.
   void orthogonalize_blas(std::vector<Field>& w, std::vector<Field>& evec, int R, int do_print=0) 
   { 
-#ifdef GRID_CUDA
-    Glog << "cuBLAS orthogonalize" << std::endl;
-    
-    typedef typename Field::vector_object vobj;
-    typedef typename vobj::scalar_type scalar_type;
-    typedef typename vobj::vector_type vector_type;
-    
-    typedef typename Field::scalar_type MyComplex;
-    
     GridBase *grid = w[0].Grid();
-    const uint64_t sites = grid->lSites();
-
-    int Nbatch = R/Nevec_acc;
-    assert( R%Nevec_acc == 0 );
-//    Glog << "nBatch, Nevec_acc, R, Nu = " 
-//         << Nbatch << "," << Nevec_acc << "," << R << "," << Nu << std::endl;
-    
-    for (int col=0; col<Nu; ++col) {
-//      auto w_v = w[col].View();
-      autoView( w_v,w[col], AcceleratorWrite);
-      CUDA_COMPLEX *z = reinterpret_cast<CUDA_COMPLEX*>(&w_v[0]);
-//      Glog << "col= "<<col <<" z= "<<z <<std::endl;
-      for (size_t row=0; row<sites*12; ++row) {
-        w_acc[col*sites*12+row] = z[row];
-      }
-    }
-    cublasHandle_t handle;
-    cublasStatus_t stat;
-    
-    stat = cublasCreate(&handle);
-
-    Glog << "cuBLAS Zgemm"<< std::endl;
-    
-    for (int b=0; b<Nbatch; ++b) {
-      for (int col=0; col<Nevec_acc; ++col) {
-//        auto evec_v = evec[b*Nevec_acc+col].View();
-        autoView( evec_v,evec[b*Nevec_acc+col], AcceleratorWrite);
-        CUDA_COMPLEX *z = reinterpret_cast<CUDA_COMPLEX*>(&evec_v[0]);
-//        Glog << "col= "<<col <<" z= "<<z <<std::endl;
-        for (size_t row=0; row<sites*12; ++row) {
-          evec_acc[col*sites*12+row] = z[row];
-        }
-      }
-      CUDA_COMPLEX alpha = MAKE_CUDA_COMPLEX(1.0,0.0);
-      CUDA_COMPLEX beta = MAKE_CUDA_COMPLEX(0.0,0.0);
-      stat = CUDA_GEMM(handle, CUBLAS_OP_C, CUBLAS_OP_N, Nevec_acc, Nu, 12*sites,
-                         &alpha, 
-                         evec_acc, 12*sites, w_acc, 12*sites,  
-                         &beta, 
-                         c_acc, Nevec_acc);
-      //Glog << stat << std::endl;
-      
-      grid->GlobalSumVector((CUDA_FLOAT*)c_acc,2*Nu*Nevec_acc);
-      alpha = MAKE_CUDA_COMPLEX(-1.0,0.0);
-      beta = MAKE_CUDA_COMPLEX(1.0,0.0);
-      stat = CUDA_GEMM(handle, CUBLAS_OP_N, CUBLAS_OP_N, 12*sites, Nu, Nevec_acc,
-                         &alpha, 
-                         evec_acc, 12*sites, c_acc, Nevec_acc,  
-                         &beta, 
-                         w_acc, 12*sites);
-      //Glog << stat << std::endl;
-    }
-    for (int col=0; col<Nu; ++col) {
-//      auto w_v = w[col].View();
-      autoView( w_v,w[col], AcceleratorWrite);
-      CUDA_COMPLEX *z = reinterpret_cast<CUDA_COMPLEX*>(&w_v[0]);
-      for (size_t row=0; row<sites*12; ++row) {
-        z[row] = w_acc[col*sites*12+row];
-      }
+    ImportBasis(evec,R);
+    ImportBlock(w,Nu);
+
+    deviceVector<scalar *> Ed(1);
+    deviceVector<scalar *> Wd(1);
+    deviceVector<scalar *> Cd(1);
+    scalar * Eh = & BLAS_E[0];
+    scalar * Wh = & BLAS_W[0];
+    scalar * Ch = & BLAS_C[0];
+    acceleratorPut(Ed[0],Eh);
+    acceleratorPut(Wd[0],Wh);
+    acceleratorPut(Cd[0],Ch);
+
+    std::vector<scalar> HOST_C(R*Nu);
+    GridBLAS BLAS;
+    for(int pass=0;pass<2;pass++){
+      // C_ru = E^dag W
+      BLAS.gemmBatched(GridBLAS_OP_C,GridBLAS_OP_N,
+		       R,Nu,vw,
+		       scalar(1.0),
+		       Ed,
+		       Wd,
+		       scalar(0.0),
+		       Cd);
+      BLAS.synchronise();
+      acceleratorCopyFromDevice(&BLAS_C[0],&HOST_C[0],R*Nu*sizeof(scalar));
+      grid->GlobalSumVector(&HOST_C[0],R*Nu);
+      acceleratorCopyToDevice(&HOST_C[0],&BLAS_C[0],R*Nu*sizeof(scalar));
+      // W = W - E C
+      BLAS.gemmBatched(GridBLAS_OP_N,GridBLAS_OP_N,
+		       vw,Nu,R,
+		       scalar(-1.0),
+		       Ed,
+		       Cd,
+		       scalar(1.0),
+		       Wd);
+      BLAS.synchronise();
     }
+    ExportBlock(w,0,Nu,w[0].Checkerboard());
     for (int i=0; i<Nu; ++i) {
       assert(normalize(w[i],do_print)!=0);
     }
-    
-    Glog << "cuBLAS Zgemm done"<< std::endl;
-    
-    cublasDestroy(handle);
-    
-    Glog << "cuBLAS orthogonalize done" << std::endl;
-#else
-    Glog << "BLAS wrapper is not implemented" << std::endl;
-    exit(1);
-#endif
   }
 
-
+  // out[o0+j] = sum_{k<K} evec[k] Q(k,j0+j) for j < J, Nu columns per GEMM.
+  // Reads the packed basis, so out may be evec itself.
+  void basisRotate_blas(std::vector<Field>& out, int o0,
+			std::vector<Field>& evec, Eigen::MatrixXcd& Q,
+			int K, int j0, int J)
+  {
+    ImportBasis(evec,K);
+
+    deviceVector<scalar *> Ed(1);
+    deviceVector<scalar *> Wd(1);
+    deviceVector<scalar *> Cd(1);
+    scalar * Eh = & BLAS_E[0];
+    scalar * Wh = & BLAS_W[0];
+    scalar * Ch = & BLAS_C[0];
+    acceleratorPut(Ed[0],Eh);
+    acceleratorPut(Wd[0],Wh);
+    acceleratorPut(Cd[0],Ch);
+
+    int cb = evec[0].Checkerboard();
+    std::vector<scalar> HOST_C(K*Nu);
+    GridBLAS BLAS;
+    for(int jb=0;jb<J;jb+=Nu){
+      int n = std::min(Nu,J-jb);
+      for(int jj=0;jj<n;jj++){
+	for(int k=0;k<K;k++){
+	  HOST_C[k+K*jj] = Q(k,j0+jb+jj);
+	}
+      }
+      acceleratorCopyToDevice(&HOST_C[0],&BLAS_C[0],K*n*sizeof(scalar));
+      BLAS.gemmBatched(GridBLAS_OP_N,GridBLAS_OP_N,
+		       vw,n,K,
+		       scalar(1.0),
+		       Ed,
+		       Cd,
+		       scalar(0.0),
+		       Wd);
+      BLAS.synchronise();
+      ExportBlock(out,o0+jb,n,cb);
+    }
+    if ( &out == &evec ) InvalidateBasis(o0);
+  }
   
   void orthogonalize_blockhead(Field& w, std::vector<Field>& evec, int k, int Nu)
   {
@@ -334,23 +372,10 @@ public:
             std::vector<Field>& evec, 
             const std::vector<Field>& src, int& Nconv, LanczosType Impl)
   {
-#ifdef GRID_CUDA
     GridBase *grid = src[0].Grid();
     grid->show_decomposition();
+    if ( blas_ortho ) AllocateBLAS(grid);
 
-//    printf("GRID_CUDA\n");
-    
-    // set eigenvector buffers for the cuBLAS calls
-    //const uint64_t nsimd = grid->Nsimd();
-    const uint64_t sites = grid->lSites();
-    
-    cudaStat = cudaMallocManaged((void **)&w_acc, Nu*sites*12*sizeof(CUDA_COMPLEX));
-//    Glog << "w_acc= "<<w_acc << " "<< cudaStat << std::endl;
-cudaStat = cudaMallocManaged((void **)&evec_acc, Nevec_acc*sites*12*sizeof(CUDA_COMPLEX));
-//    Glog << "evec_acc= "<<evec_acc << " "<< cudaStat << std::endl;
-    cudaStat = cudaMallocManaged((void **)&c_acc, Nu*Nevec_acc*sizeof(CUDA_COMPLEX));
-//    Glog << "c_acc= "<<c_acc << " "<< cudaStat << std::endl;
-#endif
     switch (Impl) {
       case LanczosType::irbl: 
         calc_irbl(eval,evec,src,Nconv);
@@ -360,12 +385,7 @@ cudaStat = cudaMallocManaged((void **)&evec_acc, Nevec_acc*sites*12*sizeof(CUDA_
         calc_rbl(eval,evec,src,Nconv);
         break;
     }
-#ifdef GRID_CUDA
-    // free eigenvector buffers for the cuBLAS calls
-    cudaFree(w_acc);
-    cudaFree(evec_acc);
-    cudaFree(c_acc);
-#endif
+    DeallocateBLAS();
   }
 
   void calc_irbl(std::vector<RealD>& eval,  
@@ -472,6 +492,9 @@ cudaStat = cudaMallocManaged((void **)&evec_acc, Nevec_acc*sites*12*sizeof(CUDA_
         
         packHermitBlockTriDiagMatfromEigen(lmd,lme,Nu,Nblock_m,Nm,Nm,BTDM);
 
+        if ( blas_ortho ) {
+          basisRotate_blas(evec,0,evec,Q,Nm,0,k2);
+        } else {
         for(int i=0; i<k2; ++i) B[i] = 0.0;
         for(int j=0; j<k2; ++j){
           for(int k=0; k<Nm; ++k){
@@ -480,6 +503,7 @@ cudaStat = cudaMallocManaged((void **)&evec_acc, Nevec_acc*sites*12*sizeof(CUDA_
           }
         }
         for(int i=0; i<k2; ++i) evec[i] = B[i];
+        }
 
         // reconstruct initial vector for additional pole space
         blockwiseStep(lmd,lme,evec,f,f_copy,Nblock_k-1);
@@ -505,6 +529,9 @@ cudaStat = cudaMallocManaged((void **)&evec_acc, Nevec_acc*sites*12*sizeof(CUDA_
 
       // Convergence test
       Glog <<" #Convergence test: "<<std::endl;
+      if ( blas_ortho ) {
+	basisRotate_blas(B,0,evec,Qt,Nk,0,Nk);
+      } else {
       for(int k = 0; k<Nk; ++k) B[k]=0.0;
       for(int j = 0; j<Nk; ++j){
 	for(int k = 0; k<Nk; ++k){
@@ -512,6 +539,7 @@ cudaStat = cudaMallocManaged((void **)&evec_acc, Nevec_acc*sites*12*sizeof(CUDA_
 	  B[j] += evec[k]*Qt(k,j);
 	}
       }
+      }
       
       Nconv = 0;
       for(int i=0; i<Nk; ++i){
@@ -689,10 +717,14 @@ cudaStat = cudaMallocManaged((void **)&evec_acc, Nevec_acc*sites*12*sizeof(CUDA_
           Glog <<" #rotation for next check point evec" 
                << std::setw(4)<< std::setiosflags(std::ios_base::right) 
                << "["<< j <<"]" <<std::endl;
+          if ( blas_ortho ) {
+            basisRotate_blas(B,0,evec,Qt,Nr,j,1);
+          } else {
           for(int k = 0; k<Nr; ++k){
             B[0].Checkerboard() = evec[k].Checkerboard();
             B[0] += evec[k]*Qt(k,j);
           }
+          }
           
           _Linop.HermOp(B[0],v);
           RealD vnum = real(innerProduct(B[0],v)); // HermOp.
@@ -739,12 +771,15 @@ cudaStat = cudaMallocManaged((void **)&evec_acc, Nevec_acc*sites*12*sizeof(CUDA_
       // Sort convered eigenpairs.
       std::vector<Field>  Btmp(Nstop,grid); // waste of space replicating
 
+      if ( blas_ortho ) basisRotate_blas(Btmp,0,evec,Qt,Nr,0,Nstop);
       for(int i=0; i<Nstop; ++i){
+	if ( !blas_ortho ) {
 	  Btmp[i]=0.;
           for(int k = 0; k<Nr; ++k){
              Btmp[i].Checkerboard() = evec[k].Checkerboard();
              Btmp[i] += evec[k]*Qt(k,i);
           }
+	}
           _Linop.HermOp(Btmp[i],v);
           RealD vnum = real(innerProduct(Btmp[i],v)); // HermOp.
           RealD vden = norm2(Btmp[i]);
@@ -881,13 +916,13 @@ if(split_test){
     }
 
     // re-orthogonalization for numerical stability
-#if 1
-    Glog << "Gram Schmidt"<< std::endl;
-    orthogonalize(w,Nu,evec,R);
-#else
-    Glog << "Gram Schmidt using cublas"<< std::endl;
-    orthogonalize_blas(w,evec,R);
-#endif
+    if ( blas_ortho ) {
+      Glog << "Gram Schmidt using GridBLAS"<< std::endl;
+      orthogonalize_blas(w,evec,R);
+    } else {
+      Glog << "Gram Schmidt"<< std::endl;
+      orthogonalize(w,Nu,evec,R);
+    }
     // QR part
     for (int u=1; u<Nu; ++u) {
       orthogonalize(w[u],w,u);
@@ -914,6 +949,7 @@ if(split_test){
     Glog << "LinAlg done "<< std::endl;
 
     if (b < Nm/Nu-1) {
+      InvalidateBasis(R);
       for (int u=0; u<Nu; ++u) {
         evec[R+u] = w[u];
       }
@@ -1405,8 +1441,4 @@ if (1){
 }
 #undef Glog
 #undef USE_LAPACK
-#undef  CUDA_COMPLEX 
-#undef  CUDA_FLOAT
-#undef  MAKE_CUDA_COMPLEX
-#undef  CUDA_GEMM 
 #endif
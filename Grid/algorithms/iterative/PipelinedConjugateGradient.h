@@ -0,0 +1,244 @@
+/*************************************************************************************
+
+Grid physics library, www.github.com/paboyle/Grid
+
+Source file: ./lib/algorithms/iterative/PipelinedConjugateGradient.h
+
+Copyright (C) 2015
+
+Author: Peter Boyle <paboyle@ph.ed.ac.uk>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+See the full license in the file "LICENSE" in the top level distribution
+directory
+*************************************************************************************/
+			   /*  END LEGAL */
+#ifndef GRID_PIPELINED_CONJUGATE_GRADIENT_H
+#define GRID_PIPELINED_CONJUGATE_GRADIENT_H
+
+NAMESPACE_BEGIN(Grid);
+
+/////////////////////////////////////////////////////////////
+// Pipelined CG, Ghysels & Vanroose, Parallel Computing 40 (2014) 224.
+//
+// Carries w = A r, s = A p, z = A s alongside r and p so that
+//
+//   gamma = <r,r> , delta = <w,r>
+//
+// are the only reductions in an iteration. Both are summed locally
+// in the vector update kernel of the previous iteration and combined
+// in one non-blocking GlobalSumBatch; the HermOp q = A w does not
+// depend on them and hides the reduction latency.
+//
+// The recurrences for w, s, z drift from the true A r, A p, A s;
+// every ReplaceInterval iterations they are recomputed from x.
+// Derives from ConjugateGradient so it can replace it anywhere,
+// e.g. as the inner solver of MixedPrecisionConjugateGradient.
+/////////////////////////////////////////////////////////////
+template <class Field>
+class PipelinedConjugateGradient : public ConjugateGradient<Field> {
+public:
+
+  using ConjugateGradient<Field>::operator();
+
+  Integer ReplaceInterval;  // residual replacement period; 0 disables
+
+  PipelinedConjugateGradient(RealD tol, Integer maxit, bool err_on_no_conv = true, Integer replace = 100)
+    : ConjugateGradient<Field>(tol,maxit,err_on_no_conv),
+      ReplaceInterval(replace)
+  {};
+
+  /////////////////////////////////////////////////////////////
+  // Fused update of the six recurrences; returns the local
+  // (unsummed) <r,r> and <w,r> of the updated vectors.
+  /////////////////////////////////////////////////////////////
+  void Update(RealD alpha,RealD beta,
+	      const Field &q,Field &z,Field &s,Field &p,
+	      Field &x,Field &r,Field &w,ComplexD *local)
+  {
+    typedef typename Field::vector_object vobj;
+    typedef decltype(innerProduct(vobj(),vobj())) inner_t;
+
+    GridBase *grid = x.Grid();
+    const uint64_t nsimd = grid->Nsimd();
+    const uint64_t sites = grid->oSites();
+
+    deviceVector<inner_t> rr_tmp(sites);
+    deviceVector<inner_t> wr_tmp(sites);
+    auto rr_tmp_v = &rr_tmp[0];
+    auto wr_tmp_v = &wr_tmp[0];
+    {
+      autoView( q_v , q, AcceleratorRead);
+      autoView( z_v , z, AcceleratorWrite);
+      autoView( s_v , s, AcceleratorWrite);
+      autoView( p_v , p, AcceleratorWrite);
+      autoView( x_v , x, AcceleratorWrite);
+      autoView( r_v , r, AcceleratorWrite);
+      autoView( w_v , w, AcceleratorWrite);
+      accelerator_for(ss, sites, nsimd, {
+	auto zz = q_v(ss) + beta * z_v(ss);
+	auto sv = w_v(ss) + beta * s_v(ss);
+	auto pp = r_v(ss) + beta * p_v(ss);
+	auto rr = r_v(ss) - alpha * sv;
+	auto ww = w_v(ss) - alpha * zz;
+	coalescedWrite(x_v[ss], x_v(ss) + alpha * pp);
+	coalescedWrite(z_v[ss], zz);
+	coalescedWrite(s_v[ss], sv);
+	coalescedWrite(p_v[ss], pp);
+	coalescedWrite(r_v[ss], rr);
+	coalescedWrite(w_v[ss], ww);
+	coalescedWrite(rr_tmp_v[ss], innerProduct(rr,rr));
+	coalescedWrite(wr_tmp_v[ss], innerProduct(ww,rr));
+      });
+    }
+    local[0] = TensorRemove(sumD(rr_tmp_v,sites));
+    local[1] = TensorRemove(sumD(wr_tmp_v,sites));
+  }
+
+  void operator()(LinearOperatorBase<Field> &Linop, const Field &src, Field &psi) {
+
+    GRID_TRACE("PipelinedConjugateGradient");
+    GridBase *grid = src.Grid();
+    psi.Checkerboard() = src.Checkerboard();
+    conformable(psi, src);
+
+    Field r(grid), w(grid), q(grid);
+    Field z(grid), s(grid), p(grid);
+    r.Checkerboard() = w.Checkerboard() = q.Checkerboard() = src.Checkerboard();
+    z.Checkerboard() = s.Checkerboard() = p.Checkerboard() = src.Checkerboard();
+
+    RealD ssq = norm2(src);
+
+    // Handle trivial case of zero src
+    if (ssq == 0.){
+      psi = Zero();
+      this->IterationsToComplete = 1;
+      this->TrueResidual = 0.;
+      return;
+    }
+
+    RealD rsq = this->Tolerance * this->Tolerance * ssq;
+
+    // r = b - A x ; w = A r ; recurrences start from zero
+    Linop.HermOp(psi, q);
+    r = src - q;
+    Linop.HermOp(r, w);
+    z = Zero();
+    s = Zero();
+    p = Zero();
+
+    ComplexD local[2];
+    GlobalSumBatch red(grid);
+    int rr = norm2Begin(red,r);
+    int wr = innerProductBegin(red,w,r);
+
+    std::cout << GridLogIterative << std::setprecision(8)
+              << "PipelinedConjugateGradient: src " << ssq << " target " << rsq << std::endl;
+
+    GridStopWatch MatrixTimer;
+    GridStopWatch ReduceTimer;
+    GridStopWatch UpdateTimer;
+    GridStopWatch SolverTimer;
+
+    RealD gamma, gamma_old=0.0, delta, alpha=0.0, beta;
+    int replaced=0;
+
+    SolverTimer.Start();
+    int k;
+    for (k = 1; k <= this->MaxIterations; k++) {
+
+      // Single fused reduction for gamma and delta, overlapped with q = A w
+      red.Begin();
+
+      MatrixTimer.Start();
+      Linop.HermOp(w, q);
+      MatrixTimer.Stop();
+
+      ReduceTimer.Start();
+      red.Complete();
+      ReduceTimer.Stop();
+
+      gamma = real(red[rr]);
+      delta = real(red[wr]);
+
+      if ( gamma <= rsq ) break;
+
+      if ( k == 1 ) {
+	beta  = 0.0;
+	alpha = gamma / delta;
+      } else {
+	beta  = gamma / gamma_old;
+	alpha = gamma / (delta - beta * gamma / alpha);
+      }
+      gamma_old = gamma;
+
+      UpdateTimer.Start();
+      Update(alpha,beta,q,z,s,p,psi,r,w,local);
+      UpdateTimer.Stop();
+      red.Reset();
+      rr = red.Add(local[0]);
+      wr = red.Add(local[1]);
+
+      std::cout << GridLogIterative << "PipelinedConjugateGradient: Iteration " << k
+		<< " residual " << std::sqrt(gamma/ssq) << " target " << this->Tolerance << std::endl;
+
+      // Residual replacement: restore r = b - A x, w = A r, s = A p, z = A s
+      if ( ReplaceInterval && (k % ReplaceInterval) == 0 ) {
+	MatrixTimer.Start();
+	Linop.HermOp(psi, q);
+	r = src - q;
+	Linop.HermOp(r, w);
+	Linop.HermOp(p, s);
+	Linop.HermOp(s, z);
+	MatrixTimer.Stop();
+	red.Reset();
+	rr = norm2Begin(red,r);
+	wr = innerProductBegin(red,w,r);
+	replaced++;
+      }
+    }
+    SolverTimer.Stop();
+
+    Linop.HermOp(psi, q);
+    r = src - q;
+    RealD true_residual = std::sqrt(norm2(r) / ssq);
+
+    if ( k <= this->MaxIterations ) {
+      k = k-1; // gamma is that of the previous update
+      std::cout << GridLogMessage << "PipelinedConjugateGradient Converged on iteration " << k
+		<< "\tComputed residual " << std::sqrt(gamma / ssq)
+		<< "\tTrue residual " << true_residual
+		<< "\tTarget " << this->Tolerance
+		<< "\tReplacements " << replaced << std::endl;
+      if (this->ErrorOnNoConverge) assert(true_residual / this->Tolerance < 10000.0);
+    } else {
+      std::cout << GridLogMessage << "PipelinedConjugateGradient did NOT converge "<<k<<" / "<< this->MaxIterations
+		<<" residual "<< true_residual << std::endl;
+      if (this->ErrorOnNoConverge) assert(0);
+    }
+    std::cout << GridLogMessage << "\tSolver Elapsed    " << SolverTimer.Elapsed() <<std::endl;
+    std::cout << GridLogPerformance << "Time breakdown "<<std::endl;
+    std::cout << GridLogPerformance << "\tMatrix     " << MatrixTimer.Elapsed() <<std::endl;
+    std::cout << GridLogPerformance << "\tReduce wait " << ReduceTimer.Elapsed() <<std::endl;
+    std::cout << GridLogPerformance << "\tUpdate     " << UpdateTimer.Elapsed() <<std::endl;
+
+    this->IterationsToComplete = k;
+    this->TrueResidual = true_residual;
+  }
+};
+
+NAMESPACE_END(Grid);
+#endif
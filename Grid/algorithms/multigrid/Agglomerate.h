@@ -0,0 +1,143 @@
+    /*************************************************************************************
+
+    Grid physics library, www.github.com/paboyle/Grid
+
+    Source file: Grid/algorithms/multigrid/Agglomerate.h
+
+    Copyright (C) 2023
+
+Author: Peter Boyle <pboyle@bnl.gov>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+    See the full license in the file "LICENSE" in the top level distribution directory
+    *************************************************************************************/
+    /*  END LEGAL */
+#pragma once
+
+NAMESPACE_BEGIN(Grid);
+
+/////////////////////////////////////////////////////////////////////////////
+// Coarse grid agglomeration.
+//
+// At the bottom of a multigrid hierarchy each rank holds a handful of
+// coarse sites and the stencil exchange is pure latency. The coarse
+// operator is redistributed with Grid_split onto a smaller processor
+// grid; the ranks form _Nprocessors/split replicas, each holding the
+// whole coarse lattice. A single solve runs replicated on every replica,
+// a vector of sources is dealt out one per replica. Results come back
+// with Grid_unsplit.
+/////////////////////////////////////////////////////////////////////////////
+
+// Halve the processor grid, largest dimension first, until each rank
+// holds at least min_sites coarse sites.
+inline Coordinate AgglomerationLayout(GridBase *grid,int64_t min_sites)
+{
+  int nd = grid->Nd();
+  Coordinate mpi  = grid->ProcessorGrid();
+  Coordinate latt = grid->FullDimensions();
+  auto local_sites = [&](void) {
+    int64_t vol=1;
+    for(int d=0;d<nd;d++) vol*= latt[d]/mpi[d];
+    return vol;
+  };
+  while ( local_sites() < min_sites ) {
+    int dmax=-1;
+    for(int d=0;d<nd;d++){
+      if ( (mpi[d]%2==0) && ((dmax<0) || (mpi[d]>mpi[dmax])) ) dmax=d;
+    }
+    if ( dmax<0 ) break; // nothing left to halve
+    mpi[dmax]/=2;
+  }
+  return mpi;
+}
+
+template<class Matrix>
+class AgglomeratedCoarseSolver : public LinearFunction<typename Matrix::CoarseVector>
+{
+public:
+  typedef typename Matrix::CoarseVector Field;
+  typedef typename Matrix::CoarseMatrix CoarseMatrix;
+  using LinearFunction<Field>::operator();
+
+  GridCartesian                                         *FullGrid;
+  std::unique_ptr<GridCartesian>                         SplitGrid;
+  std::unique_ptr<NonLocalStencilGeometry>               SplitGeom;
+  std::unique_ptr<Matrix>                                SplitOp;
+  std::unique_ptr<HermitianLinearOperator<Matrix,Field> > SplitHermOp;
+  ConjugateGradient<Field>                               CG;
+  int nsplit;
+
+  AgglomeratedCoarseSolver(Matrix &FullOp,const Coordinate &split_mpi,RealD tol,Integer maxit) :
+    FullGrid(FullOp.CoarseGrid()),
+    CG(tol,maxit,false)
+  {
+    int split_rank;
+    SplitGrid.reset(new GridCartesian(FullGrid->FullDimensions(),FullGrid->_simd_layout,split_mpi,*FullGrid,split_rank));
+    nsplit = FullGrid->_Nprocessors/SplitGrid->_Nprocessors;
+    SplitGeom.reset(new NonLocalStencilGeometry(SplitGrid.get(),FullOp.geom.hops,FullOp.geom.skip));
+    SplitOp.reset(new Matrix(*SplitGeom,nullptr,SplitGrid.get())); // never coarsened, no fine grid
+    SplitHermOp.reset(new HermitianLinearOperator<Matrix,Field>(*SplitOp));
+    ImportOperator(FullOp);
+    std::cout << GridLogMessage << "AgglomeratedCoarseSolver: processor grid "<<FullGrid->ProcessorGrid()
+	      <<" -> "<<split_mpi<<", "<<nsplit<<" replicas"<<std::endl;
+  };
+
+  // Call again whenever FullOp is recoarsened
+  void ImportOperator(Matrix &FullOp)
+  {
+    CoarseMatrix Asplit(SplitGrid.get());
+    for(int p=0;p<FullOp.geom.npoint;p++){
+      CoarseMatrix Afull = FullOp.Cell.Extract(FullOp._A[p]);
+      Grid_split(Afull,Asplit);
+      SplitOp->_A[p] = SplitOp->Cell.ExchangePeriodic(Asplit);
+    }
+  }
+
+  void operator() (const Field &in, Field &out)
+  {
+    Field full_in = in;
+    Field s_in (SplitGrid.get());
+    Field s_out(SplitGrid.get());
+    std::vector<Field> full_out(nsplit,FullGrid);
+
+    Grid_split(full_in,s_in);
+    s_out = Zero();
+    CG(*SplitHermOp,s_in,s_out);
+    Grid_unsplit(full_out,s_out);
+    out = full_out[0];
+  }
+
+  void operator() (const std::vector<Field> &in, std::vector<Field> &out)
+  {
+    assert(in.size()==out.size());
+    Field s_in (SplitGrid.get());
+    Field s_out(SplitGrid.get());
+    std::vector<Field> full_in (nsplit,FullGrid);
+    std::vector<Field> full_out(nsplit,FullGrid);
+    for(int b=0;b<in.size();b+=nsplit){
+      int nb = std::min(nsplit,(int)in.size()-b);
+      // A short final batch repeats its first source on the spare replicas
+      for(int r=0;r<nsplit;r++) full_in[r] = in[b + (r<nb ? r : 0)];
+      Grid_split(full_in,s_in);
+      s_out = Zero();
+      CG(*SplitHermOp,s_in,s_out);
+      Grid_unsplit(full_out,s_out);
+      for(int r=0;r<nb;r++) out[b+r] = full_out[r];
+    }
+  }
+};
+
+NAMESPACE_END(Grid);
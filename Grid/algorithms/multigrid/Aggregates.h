@@ -488,9 +488,17 @@ public:
   }
   virtual void RefineSubspace(LinearOperatorBase<FineField> &hermop,
 			      double Lo,double tol,int maxit)
+  {
+    std::vector<int> which(nbasis);
+    for(int b=0;b<nbasis;b++) which[b]=b;
+    RefineSubspace(hermop,Lo,tol,maxit,which);
+  }
+  virtual void RefineSubspace(LinearOperatorBase<FineField> &hermop,
+			      double Lo,double tol,int maxit,
+			      const std::vector<int> &which)
   {
     FineField tmp(FineGrid);
-    for(int b =0;b<nbasis;b++)
+    for(int b : which)
     {
       ConjugateGradient<FineField>  CGsloppy(tol,maxit,false);
       ShiftedHermOpLinearOperator<FineField> ShiftedFineHermOp(hermop,Lo);
@@ -505,37 +513,151 @@ public:
   virtual void RefineSubspaceHDCG(LinearOperatorBase<FineField> &hermop,
 				  TwoLevelADEF2mrhs<FineField,CoarseVector> & theHDCG,
 				  int nrhs)
+  {
+    std::vector<int> which(nbasis);
+    for(int b=0;b<nbasis;b++) which[b]=b;
+    RefineSubspaceHDCG(hermop,theHDCG,nrhs,which);
+  }
+  // Refine the listed basis vectors, nrhs per HDCG call
+  virtual void RefineSubspaceHDCG(LinearOperatorBase<FineField> &hermop,
+				  TwoLevelADEF2mrhs<FineField,CoarseVector> & theHDCG,
+				  int nrhs,
+				  const std::vector<int> &which)
   {
     std::vector<FineField> src_mrhs(nrhs,FineGrid);
     std::vector<FineField> res_mrhs(nrhs,FineGrid);
     FineField tmp(FineGrid);
-    for(int b =0;b<nbasis;b+=nrhs)
+    int nw = which.size();
+    for(int c=0;c<nw;c+=nrhs)
     {
-      tmp = subspace[b];
-      RealD scale = std::pow(norm2(tmp),-0.5); 	tmp=tmp*scale;
-      subspace[b] =tmp;
-      hermop.Op(subspace[b],tmp);
-      std::cout<<GridLogMessage << "before filt ["<<b<<"] <n|MdagM|n> "<<norm2(tmp)<<std::endl;
-
-      for(int r=0;r<MIN(nbasis-b,nrhs);r++){
-	src_mrhs[r] = subspace[b+r];
-      }
+      int nr = MIN(nw-c,nrhs);
       for(int r=0;r<nrhs;r++){
+	// Pad a short final batch with copies of its first source
+	src_mrhs[r] = subspace[which[c+(r<nr ? r : 0)]];
+	src_mrhs[r] = src_mrhs[r]*std::pow(norm2(src_mrhs[r]),-0.5);
 	res_mrhs[r] = Zero();
       }
       theHDCG(src_mrhs,res_mrhs);
-
-      for(int r=0;r<MIN(nbasis-b,nrhs);r++){
-	tmp = res_mrhs[r];
-	RealD scale = std::pow(norm2(tmp),-0.5); tmp=tmp*scale;
-	subspace[b+r]=tmp;
+      for(int r=0;r<nr;r++){
+	RealD scale = std::pow(norm2(res_mrhs[r]),-0.5);
+	subspace[which[c+r]] = res_mrhs[r]*scale;
       }
-      hermop.Op(subspace[b],tmp);
-      std::cout<<GridLogMessage << "after filt ["<<b<<"] <n|MdagM|n> "<<norm2(tmp)<<std::endl;
+      hermop.Op(subspace[which[c]],tmp);
+      std::cout<<GridLogMessage << "after filt ["<<which[c]<<"] <n|MdagM|n> "<<norm2(tmp)<<std::endl;
     }
   }
 
-  
+  ////////////////////////////////////////////////////////////////////////
+  // Setup reuse across nearby gauge fields (measurement streams, HMC).
+  //
+  // The subspace is saved with the Rayleigh quotients <v|H|v> of its
+  // block orthonormalised vectors. On a new field the saved subspace is
+  // loaded, the quotients are remeasured, and only vectors whose quotient
+  // grew by more than a factor 1+drift are refined, starting from the
+  // saved vector rather than from noise. The coarse operator depends on
+  // the gauge field through every matrix element and is recoarsened as
+  // usual from the updated subspace.
+  ////////////////////////////////////////////////////////////////////////
+  std::vector<RealD> rayleigh;
+
+  void RayleighQuotients(LinearOperatorBase<FineField> &hermop,std::vector<RealD> &rq)
+  {
+    FineField tmp(FineGrid);
+    rq.resize(nbasis);
+    for(int b=0;b<nbasis;b++){
+      hermop.HermOp(subspace[b],tmp);
+      rq[b] = real(innerProduct(subspace[b],tmp))/norm2(subspace[b]);
+    }
+  }
+  // Call once a subspace is final, before saving it
+  void SetReference(LinearOperatorBase<FineField> &hermop)
+  {
+    Orthogonalise();
+    RayleighQuotients(hermop,rayleigh);
+  }
+  std::vector<int> StaleVectors(LinearOperatorBase<FineField> &hermop,RealD drift)
+  {
+    assert(rayleigh.size()==nbasis);
+    std::vector<RealD> rq;
+    std::vector<int> stale;
+    Orthogonalise();
+    RayleighQuotients(hermop,rq);
+    for(int b=0;b<nbasis;b++){
+      std::cout<<GridLogMessage << "Aggregation: subspace ["<<b<<"] <v|H|v> "<<rq[b]<<" reference "<<rayleigh[b]<<std::endl;
+      if ( rq[b] > rayleigh[b]*(1.0+drift) ) stale.push_back(b);
+    }
+    std::cout<<GridLogMessage << "Aggregation: "<<stale.size()<<" of "<<nbasis<<" subspace vectors need refinement"<<std::endl;
+    return stale;
+  }
+  int UpdateSubspace(LinearOperatorBase<FineField> &hermop,
+		     double Lo,double tol,int maxit,RealD drift=0.1)
+  {
+    std::vector<int> stale = StaleVectors(hermop,drift);
+    if ( stale.size() ) {
+      RefineSubspace(hermop,Lo,tol,maxit,stale);
+      SetReference(hermop);
+    }
+    return stale.size();
+  }
+  int UpdateSubspaceHDCG(LinearOperatorBase<FineField> &hermop,
+			 TwoLevelADEF2mrhs<FineField,CoarseVector> & theHDCG,
+			 int nrhs,RealD drift=0.1)
+  {
+    std::vector<int> stale = StaleVectors(hermop,drift);
+    if ( stale.size() ) {
+      RefineSubspaceHDCG(hermop,theHDCG,nrhs,stale);
+      SetReference(hermop);
+    }
+    return stale.size();
+  }
+
+  ////////////////////////////////////////////////////////////////////////
+  // Parallel I/O: stem.subspace holds the vectors, stem.xml the
+  // Rayleigh quotients and per-vector checksums.
+  ////////////////////////////////////////////////////////////////////////
+  void SaveSubspace(const std::string &stem)
+  {
+    typedef typename Fobj::scalar_object sobj;
+    uint32_t nersc_csum,scidac_csuma,scidac_csumb;
+    auto munge = [](sobj &in,sobj &out){ out = in; };
+    std::string format = (sizeof(typename Fobj::scalar_type)==sizeof(ComplexD)) ? "IEEE64BIG" : "IEEE32BIG";
+    std::vector<uint32_t> csum;
+    uint64_t record = (uint64_t)FineGrid->gSites()*sizeof(sobj);
+    for(int b=0;b<nbasis;b++){
+      BinaryIO::writeLatticeObject<Fobj,sobj>(subspace[b],stem+".subspace",munge,b*record,format,
+					      nersc_csum,scidac_csuma,scidac_csumb);
+      csum.push_back(scidac_csuma);
+      csum.push_back(scidac_csumb);
+    }
+    if ( FineGrid->IsBoss() ) {
+      XmlWriter WRx(stem+".xml");
+      WRx.setPrecision(17); // quotients read back exactly
+      write(WRx,"rayleigh",rayleigh);
+      write(WRx,"checksums",csum);
+    }
+    FineGrid->Barrier();
+  }
+  void LoadSubspace(const std::string &stem)
+  {
+    typedef typename Fobj::scalar_object sobj;
+    uint32_t nersc_csum,scidac_csuma,scidac_csumb;
+    auto munge = [](sobj &in,sobj &out){ out = in; };
+    std::string format = (sizeof(typename Fobj::scalar_type)==sizeof(ComplexD)) ? "IEEE64BIG" : "IEEE32BIG";
+    std::vector<uint32_t> csum;
+    {
+      XmlReader RDx(stem+".xml");
+      read(RDx,"rayleigh",rayleigh);
+      read(RDx,"checksums",csum);
+    }
+    assert(csum.size()==2*nbasis);
+    uint64_t record = (uint64_t)FineGrid->gSites()*sizeof(sobj);
+    for(int b=0;b<nbasis;b++){
+      BinaryIO::readLatticeObject<Fobj,sobj>(subspace[b],stem+".subspace",munge,b*record,format,
+					     nersc_csum,scidac_csuma,scidac_csumb);
+      assert(scidac_csuma==csum[2*b] && scidac_csumb==csum[2*b+1]);
+      subspace[b].Checkerboard() = checkerboard;
+    }
+  }
   
 };
 NAMESPACE_END(Grid);
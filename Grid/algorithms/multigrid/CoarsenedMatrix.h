@@ -559,6 +559,9 @@ public:
     dag_factor(nbasis*nbasis)
   {
     fillFactor();
+    Stencil.SetHaloCompression(Stencil_halo_compression);
+    StencilEven.SetHaloCompression(Stencil_halo_compression);
+    StencilOdd.SetHaloCompression(Stencil_halo_compression);
   };
 
   CoarsenedMatrix(GridCartesian &CoarseGrid, GridRedBlackCartesian &CoarseRBGrid, int hermitian_=0) 	:
@@ -579,6 +582,9 @@ public:
     dag_factor(nbasis*nbasis)
   {
     fillFactor();
+    Stencil.SetHaloCompression(Stencil_halo_compression);
+    StencilEven.SetHaloCompression(Stencil_halo_compression);
+    StencilOdd.SetHaloCompression(Stencil_halo_compression);
   };
 
   void fillFactor() {
@@ -61,6 +61,7 @@ public:
   NonLocalStencilGeometry &geom;
   PaddedCell Cell;
   GeneralLocalStencil Stencil;
+  int HaloCompression; // face compression of the vector exchange; links are always exact
   
   std::vector<CoarseMatrix> _A;
   std::vector<CoarseMatrix> _Adag;
@@ -110,7 +111,8 @@ public:
       _CoarseGrid(CoarseGrid),
       hermitian(1),
       Cell(_geom.Depth(),_CoarseGrid),
-      Stencil(Cell.grids.back(),geom.shifts)
+      Stencil(Cell.grids.back(),geom.shifts),
+      HaloCompression(Stencil_halo_compression)
   {
     {
       int npoint = _geom.npoint;
@@ -141,7 +143,7 @@ public:
     CoarseVector tin=in;
 
     texch-=usecond();
-    CoarseVector pin = Cell.ExchangePeriodic(tin);
+    CoarseVector pin = Cell.ExchangePeriodic(tin,HaloCompression);
     texch+=usecond();
 
     CoarseVector pout(pin.Grid());
@@ -609,6 +611,53 @@ public:
       //      _Adag[p]= Cell.ExchangePeriodic(_Adag[p]);
     }
   }
+  ////////////////////////////////////////////////////////////////
+  // Parallel I/O of the unpadded link matrices, one record per point.
+  // A loaded operator can be copied into MultiGeneralCoarsenedMatrix
+  // with CopyMatrix.
+  ////////////////////////////////////////////////////////////////
+  void SaveOperator(const std::string &file)
+  {
+    typedef typename siteMatrix::scalar_object sobj;
+    uint32_t nersc_csum,scidac_csuma,scidac_csumb;
+    auto munge = [](sobj &in,sobj &out){ out = in; };
+    std::string format = (sizeof(typename siteMatrix::scalar_type)==sizeof(ComplexD)) ? "IEEE64BIG" : "IEEE32BIG";
+    std::vector<uint32_t> csum;
+    uint64_t record = (uint64_t)_CoarseGrid->gSites()*sizeof(sobj);
+    for(int p=0;p<geom.npoint;p++){
+      CoarseMatrix Aup = Cell.Extract(_A[p]);
+      BinaryIO::writeLatticeObject<siteMatrix,sobj>(Aup,file,munge,p*record,format,
+						    nersc_csum,scidac_csuma,scidac_csumb);
+      csum.push_back(scidac_csuma);
+      csum.push_back(scidac_csumb);
+    }
+    if ( _CoarseGrid->IsBoss() ) {
+      XmlWriter WRx(file+".xml");
+      write(WRx,"checksums",csum);
+    }
+    _CoarseGrid->Barrier();
+  }
+  void LoadOperator(const std::string &file)
+  {
+    typedef typename siteMatrix::scalar_object sobj;
+    uint32_t nersc_csum,scidac_csuma,scidac_csumb;
+    auto munge = [](sobj &in,sobj &out){ out = in; };
+    std::string format = (sizeof(typename siteMatrix::scalar_type)==sizeof(ComplexD)) ? "IEEE64BIG" : "IEEE32BIG";
+    std::vector<uint32_t> csum;
+    {
+      XmlReader RDx(file+".xml");
+      read(RDx,"checksums",csum);
+    }
+    assert(csum.size()==2*geom.npoint);
+    uint64_t record = (uint64_t)_CoarseGrid->gSites()*sizeof(sobj);
+    CoarseMatrix Aup(_CoarseGrid);
+    for(int p=0;p<geom.npoint;p++){
+      BinaryIO::readLatticeObject<siteMatrix,sobj>(Aup,file,munge,p*record,format,
+						   nersc_csum,scidac_csuma,scidac_csumb);
+      assert(scidac_csuma==csum[2*p] && scidac_csumb==csum[2*p+1]);
+      _A[p] = Cell.ExchangePeriodic(Aup);
+    }
+  }
   virtual  void Mdiag    (const Field &in, Field &out){ assert(0);};
   virtual  void Mdir     (const Field &in, Field &out,int dir, int disp){assert(0);};
   virtual  void MdirAll  (const Field &in, std::vector<Field> &out){assert(0);};
@@ -62,6 +62,7 @@ public:
   NonLocalStencilGeometry geom_srhs;
   PaddedCell Cell;
   GeneralLocalStencil Stencil;
+  int HaloCompression; // face compression of the vector exchange; links are always exact
 
   deviceVector<calcVector> BLAS_B;
   deviceVector<calcVector> BLAS_C;
@@ -117,7 +118,8 @@ public:
     geom_srhs(_geom),
     geom(_CoarseGridMulti,_geom.hops,_geom.skip+1),
     Cell(geom.Depth(),_CoarseGridMulti),
-    Stencil(Cell.grids.back(),geom.shifts) // padded cell stencil
+    Stencil(Cell.grids.back(),geom.shifts), // padded cell stencil
+    HaloCompression(Stencil_halo_compression)
   {
     int32_t padded_sites   = Cell.grids.back()->lSites();
     int32_t unpadded_sites = CoarseGridMulti->lSites();
@@ -657,7 +659,7 @@ Grid : Message : 328.193436 s : CoarsenOperator mat    122213270 us
     t_tot=-usecond();
     CoarseVector tin=in;
     t_exch=-usecond();
-    CoarseVector pin = Cell.ExchangePeriodic(tin); //padded input
+    CoarseVector pin = Cell.ExchangePeriodic(tin,HaloCompression); //padded input
     t_exch+=usecond();
 
     CoarseVector pout(pin.Grid());
@@ -0,0 +1,263 @@
+    /*************************************************************************************
+
+    Grid physics library, www.github.com/paboyle/Grid
+
+    Source file: Grid/algorithms/multigrid/MultiLevelHDCG.h
+
+    Copyright (C) 2023
+
+Author: Peter Boyle <pboyle@bnl.gov>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+    See the full license in the file "LICENSE" in the top level distribution directory
+    *************************************************************************************/
+    /*  END LEGAL */
+#pragma once
+
+NAMESPACE_BEGIN(Grid);
+
+/////////////////////////////////////////////////////////////////////////////
+// HDCG hierarchy on GeneralCoarsenedMatrix.
+//
+// Level l holds the aggregation of the level l operator, its coarsened
+// operator, and a Chebyshev smoother. The coarse solve inside the ADEF2
+// iteration of level l is the (inexact, flexible) solve of level l+1.
+// The coarsest level is solved with CG, agglomerated onto fewer ranks
+// when coarsest_agglomerate is set.
+//
+// Only one coarsening is supported: GeneralCoarsenedMatrix and the block
+// projectors need a fine object one tensor level below CComplex, which a
+// coarse vector iVector<CComplex,nb> is not. The levels are kept as a
+// parameter pack so deeper hierarchies can be added once the coarse of a
+// coarse operator can be built.
+//
+//   MultiLevelHDCG<vSpinColourVector,vTComplex,nb> HDCG(HermOp,FrbGrid,Params,0,Odd);
+//   HDCG.Setup(RNG);
+//   HDCG(src,sol);
+/////////////////////////////////////////////////////////////////////////////
+struct HDCGLevelParams : Serializable {
+public:
+  GRID_SERIALIZABLE_CLASS_MEMBERS(HDCGLevelParams,
+				  std::vector<int>, blockSize, /*coarsening factor of the level grid*/
+				  int, hops,            /*stencil reach of the coarse operator*/
+				  RealD, subspace_lo,   /*Chebyshev subspace filter*/
+				  RealD, subspace_hi,
+				  int, subspace_order,
+				  RealD, smoother_lo,   /*Chebyshev approximation to 1/x*/
+				  RealD, smoother_hi,
+				  int, smoother_order,
+				  RealD, tol,           /*outer tolerance on level 0, inner solve tolerance otherwise*/
+				  int, maxit);
+};
+
+struct MultiLevelHDCGParams : Serializable {
+public:
+  GRID_SERIALIZABLE_CLASS_MEMBERS(MultiLevelHDCGParams,
+				  std::vector<HDCGLevelParams>, levels,
+				  RealD, coarsest_tol,
+				  int, coarsest_maxit,
+				  int, coarsest_agglomerate); /*min coarsest sites per rank, 0 disables*/
+};
+
+template<class Field> class HDCGChebyshevSmoother : public LinearFunction<Field>
+{
+public:
+  using LinearFunction<Field>::operator();
+  LinearOperatorBase<Field> &_SmootherOperator;
+  Chebyshev<Field> Cheby;
+
+  static RealD Inverse(RealD x) { return 1.0/x; }
+
+  HDCGChebyshevSmoother(RealD _lo,RealD _hi,int _ord,LinearOperatorBase<Field> &SmootherOperator) :
+    _SmootherOperator(SmootherOperator),
+    Cheby(_lo,_hi,_ord,Inverse)
+  {};
+
+  void operator() (const Field &in, Field &out)
+  {
+    Cheby(_SmootherOperator,in,out);
+  }
+};
+
+// Coarse grid of a level: same decomposition, SIMD lanes spread from the
+// slowest dimension as in GridDefaultSimd, skipping dimensions blocked to one site.
+inline GridCartesian *HDCGCoarsenGrid(GridBase *fine,const std::vector<int> &block,int nsimd)
+{
+  int nd = fine->Nd();
+  assert(block.size()==nd);
+  Coordinate clatt = fine->FullDimensions();
+  Coordinate mpi   = fine->ProcessorGrid();
+  Coordinate simd(nd,1);
+  for(int d=0;d<nd;d++){
+    assert(clatt[d]%block[d]==0);
+    clatt[d] = clatt[d]/block[d];
+    assert(clatt[d]%mpi[d]==0);
+  }
+  int nn = nsimd;
+  while ( nn > 1 ) {
+    int placed = 0;
+    for(int d=nd-1;(d>=0) && (nn>1);d--){
+      int local = clatt[d]/mpi[d];
+      if ( local % (2*simd[d]) == 0 ) {
+	simd[d]*=2;
+	nn/=2;
+	placed=1;
+      }
+    }
+    assert(placed); // coarse local volume too small for the SIMD width
+  }
+  return new GridCartesian(clatt,simd,mpi);
+}
+
+template<class Fobj,class CComplex,int... nbasis> class MultiLevelHDCG;
+
+/////////////////////////////////////////////////////////////////////////////
+// Coarsest level
+/////////////////////////////////////////////////////////////////////////////
+template<class Fobj,class CComplex>
+class MultiLevelHDCG<Fobj,CComplex> : public LinearFunction<Lattice<Fobj> >
+{
+public:
+  using LinearFunction<Lattice<Fobj> >::operator();
+  typedef Lattice<Fobj> Field;
+
+  int level;
+  MultiLevelHDCGParams       Params;
+  LinearOperatorBase<Field> &_Linop;
+  ConjugateGradient<Field>   CG;
+  std::unique_ptr<LinearFunction<Field> > Agglomerated;
+
+  MultiLevelHDCG(LinearOperatorBase<Field> &Linop,GridBase *grid,
+		 const MultiLevelHDCGParams &_Params,int _level=0,int checkerboard=0) :
+    level(_level),
+    Params(_Params),
+    _Linop(Linop),
+    CG(_Params.coarsest_tol,_Params.coarsest_maxit,false)
+  {
+    assert(Params.levels.size()==level);
+  };
+
+  void Setup(GridParallelRNG &RNG) {};
+
+  // Matrix is the coarse operator of the level above
+  template<class Matrix> void ImportOperator(Matrix &Op)
+  {
+    Agglomerated.reset();
+    if ( Params.coarsest_agglomerate <= 0 ) return;
+    Coordinate split = AgglomerationLayout(Op.CoarseGrid(),Params.coarsest_agglomerate);
+    if ( split == Op.CoarseGrid()->ProcessorGrid() ) return;
+    Agglomerated.reset(new AgglomeratedCoarseSolver<Matrix>(Op,split,Params.coarsest_tol,Params.coarsest_maxit));
+  }
+
+  void operator() (const Field &in, Field &out)
+  {
+    if ( Agglomerated ) {
+      (*Agglomerated)(in,out);
+      return;
+    }
+    out = Zero();
+    CG(_Linop,in,out);
+  }
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// Level with nb basis vectors, recursing on the remaining nbasis
+/////////////////////////////////////////////////////////////////////////////
+template<class Fobj,class CComplex,int nb,int... nbasis>
+class MultiLevelHDCG<Fobj,CComplex,nb,nbasis...> : public LinearFunction<Lattice<Fobj> >
+{
+public:
+  using LinearFunction<Lattice<Fobj> >::operator();
+
+  typedef Lattice<Fobj>                                      FineField;
+  typedef Aggregation<Fobj,CComplex,nb>                      Aggregates_t;
+  typedef typename Aggregates_t::siteVector                  siteVector;
+  typedef typename Aggregates_t::CoarseVector                CoarseVector;
+  typedef GeneralCoarsenedMatrix<Fobj,CComplex,nb>           CoarseOp_t;
+  typedef HermitianLinearOperator<CoarseOp_t,CoarseVector>   CoarseHermOp_t;
+  typedef MultiLevelHDCG<siteVector,CComplex,nbasis...>      Next_t;
+
+  int level;
+  HDCGLevelParams                    LevelParams;
+  LinearOperatorBase<FineField>     &_FineLinop;
+  GridBase                          *FineGrid;
+  std::unique_ptr<GridCartesian>     CoarseGrid;
+  NonLocalStencilGeometry            geom;
+  Aggregates_t                       Aggregates;
+  CoarseOp_t                         CoarseOp;
+  CoarseHermOp_t                     CoarseHermOp;
+  HDCGChebyshevSmoother<FineField>   Smoother;
+  Next_t                             Next;
+  TwoLevelADEF2<FineField,CoarseVector,Aggregates_t> Solver;
+
+  static_assert(sizeof...(nbasis)==0,"MultiLevelHDCG: GeneralCoarsenedMatrix cannot coarsen a coarse operator; use one coarse level");
+
+  MultiLevelHDCG(LinearOperatorBase<FineField> &FineLinop,GridBase *_FineGrid,
+		 const MultiLevelHDCGParams &Params,int _level=0,int checkerboard=0) :
+    level(_level),
+    LevelParams(Params.levels.at(_level)),
+    _FineLinop(FineLinop),
+    FineGrid(_FineGrid),
+    CoarseGrid(HDCGCoarsenGrid(_FineGrid,Params.levels.at(_level).blockSize,CComplex::Nsimd())),
+    geom(CoarseGrid.get(),Params.levels.at(_level).hops,_FineGrid->Nd()-4),
+    Aggregates(CoarseGrid.get(),_FineGrid,checkerboard),
+    CoarseOp(geom,_FineGrid,CoarseGrid.get()),
+    CoarseHermOp(CoarseOp),
+    Smoother(Params.levels.at(_level).smoother_lo,
+	     Params.levels.at(_level).smoother_hi,
+	     Params.levels.at(_level).smoother_order,
+	     FineLinop),
+    Next(CoarseHermOp,CoarseGrid.get(),Params,_level+1),
+    Solver(Params.levels.at(_level).tol,
+	   Params.levels.at(_level).maxit,
+	   FineLinop,
+	   Smoother,
+	   Next,
+	   Next,
+	   Aggregates)
+  {
+    assert(_FineGrid->Nd()>=4);
+    std::cout << GridLogMessage << "MultiLevelHDCG level "<<level<<" : "<<nb<<" basis vectors, coarse grid "
+	      << CoarseGrid->FullDimensions() << std::endl;
+  };
+
+  // Build the subspace and coarse operator of this level, then recurse
+  void Setup(GridParallelRNG &RNG)
+  {
+    std::cout << GridLogMessage << "MultiLevelHDCG level "<<level<<" : creating subspace"<<std::endl;
+    Aggregates.CreateSubspaceChebyshev(RNG,_FineLinop,nb,
+				       LevelParams.subspace_hi,
+				       LevelParams.subspace_lo,
+				       LevelParams.subspace_order);
+    std::cout << GridLogMessage << "MultiLevelHDCG level "<<level<<" : coarsening operator"<<std::endl;
+    CoarseOp.CoarsenOperator(_FineLinop,Aggregates);
+    Next.ImportOperator(CoarseOp);
+
+    GridParallelRNG CRNG(CoarseGrid.get());
+    CRNG.SeedFixedIntegers(std::vector<int>({level+1,2,3,4}));
+    Next.Setup(CRNG);
+  }
+
+  // Only the coarsest level uses the operator above it
+  template<class Matrix> void ImportOperator(Matrix &Op) {};
+
+  void operator() (const FineField &in, FineField &out)
+  {
+    Solver(in,out);
+  }
+};
+
+NAMESPACE_END(Grid);
@@ -4,14 +4,8 @@ NAMESPACE_BEGIN(Grid);
 
 /*Allocation types, saying which pointer cache should be used*/
 #define Cpu      (0)
-#define CpuHuge  (1)
-#define CpuSmall (2)
-#define Acc      (3)
-#define AccHuge  (4)
-#define AccSmall (5)
-#define Shared   (6)
-#define SharedHuge  (7)
-#define SharedSmall (8)
+#define Acc      (1)
+#define Shared   (2)
 #undef GRID_MM_VERBOSE 
 uint64_t total_shared;
 uint64_t total_device;
@@ -62,13 +56,10 @@ void MemoryManager::PrintBytes(void)
   std::cout << " MemoryManager : "<<(total_shared>>20)<<" shared      Mbytes "<<std::endl;
   std::cout << " MemoryManager : "<<(total_device>>20)<<" accelerator Mbytes "<<std::endl;
   std::cout << " MemoryManager : "<<(total_host>>20)  <<" cpu         Mbytes "<<std::endl;
-  uint64_t cacheBytes;
-  cacheBytes = CacheBytes[Cpu];
-  std::cout << " MemoryManager : "<<(cacheBytes>>20) <<" cpu cache Mbytes "<<std::endl;
-  cacheBytes = CacheBytes[Acc];
-  std::cout << " MemoryManager : "<<(cacheBytes>>20) <<" acc cache Mbytes "<<std::endl;
-  cacheBytes = CacheBytes[Shared];
-  std::cout << " MemoryManager : "<<(cacheBytes>>20) <<" shared cache Mbytes "<<std::endl;
+  std::cout << " MemoryManager : "<<(PoolStats[Cpu].cachedBytes>>20)   <<" cpu cache Mbytes "<<std::endl;
+  std::cout << " MemoryManager : "<<(PoolStats[Acc].cachedBytes>>20)   <<" acc cache Mbytes "<<std::endl;
+  std::cout << " MemoryManager : "<<(PoolStats[Shared].cachedBytes>>20)<<" shared cache Mbytes "<<std::endl;
+  PrintPoolStats();
   
 #ifdef GRID_CUDA
   cuda_mem();
@@ -76,16 +67,52 @@ void MemoryManager::PrintBytes(void)
   DisplayMallinfo();
 }
 
-uint64_t MemoryManager::DeviceCacheBytes() { return CacheBytes[Acc] + CacheBytes[AccHuge] + CacheBytes[AccSmall]; }
-uint64_t MemoryManager::HostCacheBytes()   { return CacheBytes[Cpu] + CacheBytes[CpuHuge] + CacheBytes[CpuSmall]; }
+uint64_t MemoryManager::DeviceCacheBytes() { return PoolStats[Acc].cachedBytes; }
+uint64_t MemoryManager::HostCacheBytes()   { return PoolStats[Cpu].cachedBytes; }
+
+MemoryPoolStats MemoryManager::GetPoolStats(int type)
+{
+  std::lock_guard<std::mutex> guard(PoolMutex);
+  MemoryPoolStats s = PoolStats[type];
+  s.emptySlabs    = SlabEmpty[type].size();
+  s.maxEntries    = Ncache[type];
+  s.maxEmptySlabs = NcacheSlab[type];
+  return s;
+}
+MemoryPoolStats MemoryManager::HostPoolStats(void)   { return GetPoolStats(Cpu); }
+MemoryPoolStats MemoryManager::DevicePoolStats(void) { return GetPoolStats(Acc); }
+MemoryPoolStats MemoryManager::SharedPoolStats(void) { return GetPoolStats(Shared); }
+
+void MemoryManager::PrintPoolStats(void)
+{
+  const char *name[NallocType] = { "cpu   ","acc   ","shared" };
+  for(int type=0;type<NallocType;type++){
+    MemoryPoolStats &s = PoolStats[type];
+    if ( s.hits+s.misses == 0 ) continue;
+    std::cout << " MemoryManager : "<<name[type]<<" pool hits "<<s.hits<<" misses "<<s.misses
+	      <<" released "<<s.releases<<" slabs "<<s.slabs<<std::endl;
+    std::cout << " MemoryManager : "<<name[type]<<" pool in use "<<(s.inuseBytes>>20)<<" Mbytes (max "<<(s.maxInuseBytes>>20)
+	      <<") cached "<<(s.cachedBytes>>20)<<" Mbytes (max "<<(s.maxCachedBytes>>20)<<")"<<std::endl;
+  }
+}
 
 //////////////////////////////////////////////////////////////////////
-// Data tables for recently freed pooiniter caches
+// Data tables for recently freed pointer caches
 //////////////////////////////////////////////////////////////////////
-MemoryManager::AllocationCacheEntry MemoryManager::Entries[MemoryManager::NallocType][MemoryManager::NallocCacheMax];
+std::vector<void *> MemoryManager::FreeList[MemoryManager::NallocType][MemoryManager::NallocClass];
+uint64_t MemoryManager::Ncache[MemoryManager::NallocType] = { 2, 8, 8 };
 int MemoryManager::Victim[MemoryManager::NallocType];
-int MemoryManager::Ncache[MemoryManager::NallocType] = { 2, 0, 8, 8, 0, 16, 8, 0, 16 };
-uint64_t MemoryManager::CacheBytes[MemoryManager::NallocType];
+MemoryManager::AllocationCacheEntry MemoryManager::Entries[MemoryManager::NallocType][MemoryManager::NallocCacheMax];
+int MemoryManager::NcacheHuge[MemoryManager::NallocType] = { 0, 0, 0 };
+int MemoryManager::VictimHuge[MemoryManager::NallocType];
+std::vector<MemoryManager::AllocationSlab> MemoryManager::Slabs[MemoryManager::NallocType];
+std::vector<int> MemoryManager::SlabPartial[MemoryManager::NallocType][MemoryManager::NallocSmallClass];
+std::vector<int> MemoryManager::SlabEmpty[MemoryManager::NallocType];
+std::vector<int> MemoryManager::SlabUnused[MemoryManager::NallocType];
+std::map<uint64_t,int> MemoryManager::SlabIndex[MemoryManager::NallocType];
+uint64_t MemoryManager::NcacheSlab[MemoryManager::NallocType] = { 8, 16, 16 };
+MemoryPoolStats MemoryManager::PoolStats[MemoryManager::NallocType];
+std::mutex      MemoryManager::PoolMutex;
 //////////////////////////////////////////////////////////////////////
 // Actual allocation and deallocation utils
 //////////////////////////////////////////////////////////////////////
@@ -94,7 +121,7 @@ void *MemoryManager::AcceleratorAllocate(size_t bytes)
   total_device+=bytes;
   void *ptr = (void *) Lookup(bytes,Acc);
   if ( ptr == (void *) NULL ) {
-    ptr = (void *) acceleratorAllocDevice(bytes);
+    ptr = (void *) acceleratorAllocDevice(AllocationBytes(bytes));
   }
 #ifdef GRID_MM_VERBOSE
   std::cout <<"AcceleratorAllocate "<<std::endl;
@@ -119,7 +146,7 @@ void *MemoryManager::SharedAllocate(size_t bytes)
   total_shared+=bytes;
   void *ptr = (void *) Lookup(bytes,Shared);
   if ( ptr == (void *) NULL ) {
-    ptr = (void *) acceleratorAllocShared(bytes);
+    ptr = (void *) acceleratorAllocShared(AllocationBytes(bytes));
   }
 #ifdef GRID_MM_VERBOSE
   std::cout <<"SharedAllocate "<<std::endl;
@@ -145,7 +172,7 @@ void *MemoryManager::CpuAllocate(size_t bytes)
   total_host+=bytes;
   void *ptr = (void *) Lookup(bytes,Cpu);
   if ( ptr == (void *) NULL ) {
-    ptr = (void *) acceleratorAllocShared(bytes);
+    ptr = (void *) acceleratorAllocShared(AllocationBytes(bytes));
   }
 #ifdef GRID_MM_VERBOSE
   std::cout <<"CpuAllocate "<<std::endl;
@@ -172,7 +199,7 @@ void *MemoryManager::CpuAllocate(size_t bytes)
   total_host+=bytes;
   void *ptr = (void *) Lookup(bytes,Cpu);
   if ( ptr == (void *) NULL ) {
-    ptr = (void *) acceleratorAllocCpu(bytes);
+    ptr = (void *) acceleratorAllocCpu(AllocationBytes(bytes));
   }
 #ifdef GRID_MM_VERBOSE
   std::cout <<"CpuAllocate "<<std::endl;
@@ -218,9 +245,9 @@ void MemoryManager::Init(void)
   if ( str ) {
     Nc = atoi(str);
     if ( (Nc>=0) && (Nc < NallocCacheMax)) {
-      Ncache[CpuHuge]=Nc;
-      Ncache[AccHuge]=Nc;
-      Ncache[SharedHuge]=Nc;
+      NcacheHuge[Cpu]=Nc;
+      NcacheHuge[Acc]=Nc;
+      NcacheHuge[Shared]=Nc;
     }
   }
 
@@ -228,9 +255,9 @@ void MemoryManager::Init(void)
   if ( str ) {
     Nc = atoi(str);
     if ( (Nc>=0) && (Nc < NallocCacheMax)) {
-      Ncache[CpuSmall]=Nc;
-      Ncache[AccSmall]=Nc;
-      Ncache[SharedSmall]=Nc;
+      NcacheSlab[Cpu]=Nc;
+      NcacheSlab[Acc]=Nc;
+      NcacheSlab[Shared]=Nc;
     }
   }
 
@@ -244,9 +271,11 @@ void MemoryManager::InitMessage(void) {
   
   std::cout << GridLogMessage<< "MemoryManager::Init() setting up"<<std::endl;
 #ifdef ALLOCATION_CACHE
-  std::cout << GridLogMessage<< "MemoryManager::Init() cache pool for recent host   allocations: SMALL "<<Ncache[CpuSmall]<<" LARGE "<<Ncache[Cpu]<<" HUGE "<<Ncache[CpuHuge]<<std::endl;
-  std::cout << GridLogMessage<< "MemoryManager::Init() cache pool for recent device allocations: SMALL "<<Ncache[AccSmall]<<" LARGE "<<Ncache[Acc]<<" Huge "<<Ncache[AccHuge]<<std::endl;
-  std::cout << GridLogMessage<< "MemoryManager::Init() cache pool for recent shared allocations: SMALL "<<Ncache[SharedSmall]<<" LARGE "<<Ncache[Shared]<<" Huge "<<Ncache[SharedHuge]<<std::endl;
+  std::cout << GridLogMessage<< "MemoryManager::Init() cache pool for recent host   allocations: SMALL "<<NcacheSlab[Cpu]<<" LARGE "<<Ncache[Cpu]<<" HUGE "<<NcacheHuge[Cpu]<<std::endl;
+  std::cout << GridLogMessage<< "MemoryManager::Init() cache pool for recent device allocations: SMALL "<<NcacheSlab[Acc]<<" LARGE "<<Ncache[Acc]<<" Huge "<<NcacheHuge[Acc]<<std::endl;
+  std::cout << GridLogMessage<< "MemoryManager::Init() cache pool for recent shared allocations: SMALL "<<NcacheSlab[Shared]<<" LARGE "<<Ncache[Shared]<<" Huge "<<NcacheHuge[Shared]<<std::endl;
+  std::cout << GridLogMessage<< "MemoryManager::Init() "<<NallocClassPerOctave<<" size classes per octave, "
+	    << GRID_ALLOC_SLAB_BYTES<<" byte slabs for allocations below "<<GRID_ALLOC_SMALL_LIMIT<<" bytes"<<std::endl;
 #endif
   
 #ifdef GRID_UVM
@@ -275,17 +304,104 @@ void MemoryManager::InitMessage(void) {
 
 }
 
-void *MemoryManager::Insert(void *ptr,size_t bytes,int type) 
+//////////////////////////////////////////////////////////////////////
+// Size classes
+//   0 ... NallocSmallClass-1 : 64 << c bytes
+//   then NallocClassPerOctave steps between successive powers of two
+//////////////////////////////////////////////////////////////////////
+int MemoryManager::SizeClass(size_t bytes)
+{
+  if ( bytes <= 64 ) return 0;
+  if ( bytes < GRID_ALLOC_SMALL_LIMIT ) {
+    int e = 63 - __builtin_clzll((uint64_t)bytes-1); // 2^e < bytes <= 2^(e+1)
+    return e+1-6;
+  }
+  int e    = 63 - __builtin_clzll((uint64_t)bytes);   // 2^e <= bytes < 2^(e+1)
+  int lstep= e - 3;                                   // log2 of class step, NallocClassPerOctave=8
+  uint64_t sub = (bytes - (1ULL<<e) + (1ULL<<lstep) - 1) >> lstep;
+  int c = NallocSmallClass + (e-12)*NallocClassPerOctave + (int)sub;
+  assert(c < NallocClass);
+  return c;
+}
+size_t MemoryManager::ClassBytes(int c)
+{
+  if ( c < NallocSmallClass ) return ((size_t)64)<<c;
+  int k   = c - NallocSmallClass;
+  int e   = 12 + k / NallocClassPerOctave;
+  int sub = k % NallocClassPerOctave;
+  return (((size_t)1)<<e) + ((size_t)sub<<(e-3));
+}
+// Bytes to request from the system so that the block can be reused for its whole class
+size_t MemoryManager::AllocationBytes(size_t bytes)
 {
 #ifdef ALLOCATION_CACHE
-  int cache;
-  if      (bytes < GRID_ALLOC_SMALL_LIMIT) cache = type + 2;
-  else if (bytes >= GRID_ALLOC_HUGE_LIMIT) cache = type + 1;
-  else                                     cache = type;
+  if ( bytes < GRID_ALLOC_HUGE_LIMIT ) return ClassBytes(SizeClass(bytes));
+#endif
+  return bytes;
+}
+void *MemoryManager::SystemAllocate(size_t bytes,int type)
+{
+  if ( type==Acc    ) return acceleratorAllocDevice(bytes);
+  if ( type==Shared ) return acceleratorAllocShared(bytes);
+#ifdef GRID_UVM
+  return acceleratorAllocShared(bytes);
+#else
+  return acceleratorAllocCpu(bytes);
+#endif
+}
+void MemoryManager::SystemFree(void *ptr,int type)
+{
+  if ( type==Acc    ) { acceleratorFreeDevice(ptr); return; }
+  if ( type==Shared ) { acceleratorFreeShared(ptr); return; }
+#ifdef GRID_UVM
+  acceleratorFreeShared(ptr);
+#else
+  acceleratorFreeCpu(ptr);
+#endif
+}
 
-  return Insert(ptr,bytes,Entries[cache],Ncache[cache],Victim[cache],CacheBytes[cache]);  
+//////////////////////////////////////////////////////////////////////
+// Lookup returns NULL on a miss, and the caller allocates AllocationBytes(bytes).
+// Insert returns a pointer the caller must hand back to the system, or NULL.
+//////////////////////////////////////////////////////////////////////
+void *MemoryManager::Insert(void *ptr,size_t bytes,int type) 
+{
+  std::lock_guard<std::mutex> guard(PoolMutex);
+  MemoryPoolStats &stats = PoolStats[type];
+  stats.inuseBytes -= AllocationBytes(bytes);
+#ifdef ALLOCATION_CACHE
+  void *ret;
+  if      (bytes < GRID_ALLOC_SMALL_LIMIT) ret = SlabInsert(ptr,bytes,type);
+  else if (bytes >= GRID_ALLOC_HUGE_LIMIT) ret = Insert(ptr,bytes,Entries[type],NcacheHuge[type],VictimHuge[type],stats.cachedBytes);
+  else                                     ret = ClassInsert(ptr,bytes,type);
+  if ( ret ) stats.releases++;
+  stats.maxCachedBytes = std::max(stats.maxCachedBytes,stats.cachedBytes);
+  return ret;
 #else
+  stats.releases++;
+  return ptr;
+#endif
+}
+
+void *MemoryManager::Lookup(size_t bytes,int type)
+{
+  std::lock_guard<std::mutex> guard(PoolMutex);
+  MemoryPoolStats &stats = PoolStats[type];
+  stats.inuseBytes   += AllocationBytes(bytes);
+  stats.maxInuseBytes = std::max(stats.maxInuseBytes,stats.inuseBytes);
+#ifdef ALLOCATION_CACHE
+  // Small objects always come from a slab, which counts its own hits
+  if (bytes < GRID_ALLOC_SMALL_LIMIT) return SlabLookup(bytes,type);
+
+  void *ptr;
+  if (bytes >= GRID_ALLOC_HUGE_LIMIT) ptr = Lookup(bytes,Entries[type],NcacheHuge[type],stats.cachedBytes);
+  else                                ptr = ClassLookup(bytes,type);
+  if ( ptr ) stats.hits++;
+  else       stats.misses++;
   return ptr;
+#else
+  stats.misses++;
+  return NULL;
 #endif
 }
 
@@ -328,20 +444,6 @@ void *MemoryManager::Insert(void *ptr,size_t bytes,AllocationCacheEntry *entries
   return ret;
 }
 
-void *MemoryManager::Lookup(size_t bytes,int type)
-{
-#ifdef ALLOCATION_CACHE
-  int cache;
-  if      (bytes < GRID_ALLOC_SMALL_LIMIT) cache = type + 2;
-  else if (bytes >= GRID_ALLOC_HUGE_LIMIT) cache = type + 1;
-  else                                     cache = type;
-
-  return Lookup(bytes,Entries[cache],Ncache[cache],CacheBytes[cache]);
-#else
-  return NULL;
-#endif
-}
-
 void *MemoryManager::Lookup(size_t bytes,AllocationCacheEntry *entries,int ncache,uint64_t & cacheBytes) 
 {
 #ifdef GRID_OMP
@@ -357,6 +459,162 @@ void *MemoryManager::Lookup(size_t bytes,AllocationCacheEntry *entries,int ncach
   return NULL;
 }
 
+//////////////////////////////////////////////////////////////////////
+// Large classes: LIFO free list per class, at most Ncache blocks in total.
+// When full, evict from the class being freed so the most recently used
+// block stays, else round robin over the other classes.
+//////////////////////////////////////////////////////////////////////
+void *MemoryManager::ClassInsert(void *ptr,size_t bytes,int type)
+{
+#ifdef GRID_OMP
+  assert(omp_in_parallel()==0);
+#endif 
+  MemoryPoolStats &stats = PoolStats[type];
+  if ( Ncache[type]==0 ) return ptr;
+
+  int c = SizeClass(bytes);
+  void *ret = NULL;
+  if ( stats.entries >= Ncache[type] ) {
+    int v = c;
+    while ( FreeList[type][v].size()==0 ) {
+      v = Victim[type];
+      Victim[type] = (Victim[type]+1)%NallocClass;
+    }
+    ret = FreeList[type][v].front();
+    FreeList[type][v].erase(FreeList[type][v].begin());
+    stats.cachedBytes -= ClassBytes(v);
+    stats.entries--;
+  }
+  FreeList[type][c].push_back(ptr);
+  stats.cachedBytes += ClassBytes(c);
+  stats.entries++;
+  return ret;
+}
+
+void *MemoryManager::ClassLookup(size_t bytes,int type)
+{
+#ifdef GRID_OMP
+  assert(omp_in_parallel()==0);
+#endif 
+  MemoryPoolStats &stats = PoolStats[type];
+  int c = SizeClass(bytes);
+  std::vector<void *> &list = FreeList[type][c];
+  if ( list.size()==0 ) return NULL;
+  void *ptr = list.back();
+  list.pop_back();
+  stats.cachedBytes -= ClassBytes(c);
+  stats.entries--;
+  return ptr;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Small objects: slabs of GRID_ALLOC_SLAB_BYTES carved into one class.
+// Slabs with a free object sit on their class list; once every object is
+// back the slab coalesces into a whole empty slab, which can be recarved
+// for any class or, beyond NcacheSlab of them, returned to the system.
+// Slab bookkeeping lives on the host so device slabs are never touched.
+//////////////////////////////////////////////////////////////////////
+void MemoryManager::SlabUnlist(int type,int s)
+{
+  std::vector<int> &list = SlabPartial[type][Slabs[type][s].sizeclass];
+  int p    = Slabs[type][s].partial;
+  int last = list.back();
+  list[p] = last;
+  Slabs[type][last].partial = p;
+  list.pop_back();
+  Slabs[type][s].partial = -1;
+}
+
+void *MemoryManager::SlabLookup(size_t bytes,int type)
+{
+#ifdef GRID_OMP
+  assert(omp_in_parallel()==0);
+#endif 
+  MemoryPoolStats &stats = PoolStats[type];
+  int    c      = SizeClass(bytes);
+  size_t cbytes = ClassBytes(c);
+  std::vector<int> &partial = SlabPartial[type][c];
+
+  if ( partial.size()==0 ) {
+    int s;
+    if ( SlabEmpty[type].size() ) {
+      s = SlabEmpty[type].back();
+      SlabEmpty[type].pop_back();
+      stats.hits++;
+    } else {
+      if ( SlabUnused[type].size() ) {
+	s = SlabUnused[type].back();
+	SlabUnused[type].pop_back();
+      } else {
+	s = Slabs[type].size();
+	Slabs[type].push_back(AllocationSlab());
+      }
+      Slabs[type][s].base = (char *)SystemAllocate(GRID_ALLOC_SLAB_BYTES,type);
+      SlabIndex[type][(uint64_t)Slabs[type][s].base] = s;
+      stats.cachedBytes += GRID_ALLOC_SLAB_BYTES;
+      stats.slabs++;
+      stats.misses++;
+    }
+    AllocationSlab &slab = Slabs[type][s];
+    slab.sizeclass = c;
+    slab.nobj      = GRID_ALLOC_SLAB_BYTES/cbytes;
+    slab.free.resize(slab.nobj);
+    for(uint64_t o=0;o<slab.nobj;o++) slab.free[o] = slab.nobj-1-o; // hand out in address order
+    slab.partial = partial.size();
+    partial.push_back(s);
+  } else {
+    stats.hits++;
+  }
+
+  int s = partial.back();
+  AllocationSlab &slab = Slabs[type][s];
+  int o = slab.free.back();
+  slab.free.pop_back();
+  if ( slab.free.size()==0 ) SlabUnlist(type,s);
+  stats.cachedBytes -= cbytes;
+  return (void *)(slab.base + o*cbytes);
+}
+
+void *MemoryManager::SlabInsert(void *ptr,size_t bytes,int type)
+{
+#ifdef GRID_OMP
+  assert(omp_in_parallel()==0);
+#endif 
+  MemoryPoolStats &stats = PoolStats[type];
+  auto it = SlabIndex[type].upper_bound((uint64_t)ptr);
+  assert(it!=SlabIndex[type].begin());
+  it--;
+  int s = it->second;
+  AllocationSlab &slab = Slabs[type][s];
+  size_t cbytes = ClassBytes(slab.sizeclass);
+  uint64_t off  = (uint64_t)ptr - (uint64_t)slab.base;
+  assert(off < GRID_ALLOC_SLAB_BYTES);
+  assert(slab.sizeclass == SizeClass(bytes));
+
+  slab.free.push_back(off/cbytes);
+  stats.cachedBytes += cbytes;
+  if ( slab.free.size()==1 ) {
+    slab.partial = SlabPartial[type][slab.sizeclass].size();
+    SlabPartial[type][slab.sizeclass].push_back(s);
+  }
+  if ( slab.free.size() < slab.nobj ) return NULL;
+
+  // Coalesced: every object is back
+  SlabUnlist(type,s);
+  if ( SlabEmpty[type].size() < NcacheSlab[type] ) {
+    SlabEmpty[type].push_back(s);
+    return NULL;
+  }
+  void *ret = (void *)slab.base;
+  SlabIndex[type].erase(it);
+  slab.base = NULL;
+  slab.free.resize(0);
+  SlabUnused[type].push_back(s);
+  stats.cachedBytes -= GRID_ALLOC_SLAB_BYTES;
+  stats.slabs--;
+  return ret;
+}
+
 
 NAMESPACE_END(Grid);
 
@@ -28,7 +28,9 @@ Author: Peter Boyle <paboyle@ph.ed.ac.uk>
 /*  END LEGAL */
 #pragma once
 #include <list> 
+#include <map>
 #include <unordered_map>  
+#include <mutex>
 
 NAMESPACE_BEGIN(Grid);
 
@@ -36,6 +38,7 @@ NAMESPACE_BEGIN(Grid);
 
 #define GRID_ALLOC_SMALL_LIMIT (4096)
 #define GRID_ALLOC_HUGE_LIMIT  (2147483648)
+#define GRID_ALLOC_SLAB_BYTES  (65536)
 
 #define STRINGIFY(x) #x
 #define TOSTRING(x) STRINGIFY(x)
@@ -83,6 +86,8 @@ struct MemoryStatus {
   uint64_t     DeviceDestroy;
   uint64_t     DeviceAllocCacheBytes;
   uint64_t     HostAllocCacheBytes;
+  uint64_t     DeviceAllocMaxBytes;
+  uint64_t     HostAllocMaxBytes;
 };
 
 
@@ -90,28 +95,75 @@ class MemoryManager {
 private:
 
   ////////////////////////////////////////////////////////////
-  // For caching recently freed allocations
+  // For caching recently freed allocations.
+  //
+  // Requests are rounded up to a size class, so that sizes
+  // differing by a few sites still reuse the same block, and
+  // each class keeps a LIFO free list: lookup is O(1).
+  //
+  //  bytes <  GRID_ALLOC_SMALL_LIMIT : powers of two from 64 bytes, carved out
+  //                                    of GRID_ALLOC_SLAB_BYTES slabs
+  //  bytes <  GRID_ALLOC_HUGE_LIMIT  : NallocClassPerOctave classes per power of two,
+  //                                    so at most 1/NallocClassPerOctave padding
+  //  bytes >= GRID_ALLOC_HUGE_LIMIT  : exact size, short list of recent frees
   ////////////////////////////////////////////////////////////
-  typedef struct { 
+  typedef struct {
     void *address;
     size_t bytes;
     int valid;
   } AllocationCacheEntry;
 
-  static const int NallocCacheMax=128; 
-  static const int NallocType=9;
+  typedef struct {
+    char *base;            // NULL if the record is unused
+    int   sizeclass;
+    uint64_t nobj;
+    int   partial;         // position in SlabPartial, -1 if full or empty
+    std::vector<int> free; // free object indices
+  } AllocationSlab;
+
+  static const int NallocCacheMax=128;
+  static const int NallocType=3;
+  static const int NallocClassPerOctave=8;
+  static const int NallocSmallClass=7;   // 64 ... GRID_ALLOC_SMALL_LIMIT
+  static const int NallocClass=NallocSmallClass+19*NallocClassPerOctave+1; // up to GRID_ALLOC_HUGE_LIMIT
+
+  static std::vector<void *>  FreeList[NallocType][NallocClass];
+  static uint64_t Ncache[NallocType]; // blocks held over all large classes
+  static int Victim[NallocType];      // round robin class to evict from
+
   static AllocationCacheEntry Entries[NallocType][NallocCacheMax];
-  static int Victim[NallocType];
-  static int Ncache[NallocType];
-  static uint64_t CacheBytes[NallocType];
+  static int NcacheHuge[NallocType];
+  static int VictimHuge[NallocType];
+
+  static std::vector<AllocationSlab> Slabs[NallocType];
+  static std::vector<int>            SlabPartial[NallocType][NallocSmallClass];
+  static std::vector<int>            SlabEmpty[NallocType];
+  static std::vector<int>            SlabUnused[NallocType];
+  static std::map<uint64_t,int>      SlabIndex[NallocType];
+  static uint64_t NcacheSlab[NallocType]; // empty slabs held before returning them
+
+  static MemoryPoolStats PoolStats[NallocType];
+  static std::mutex      PoolMutex;  // pools are shared with background I/O threads
+  static MemoryPoolStats GetPoolStats(int type);
 
   /////////////////////////////////////////////////
   // Free pool
   /////////////////////////////////////////////////
+  static int    SizeClass(size_t bytes);
+  static size_t ClassBytes(int sizeclass);
+  static size_t AllocationBytes(size_t bytes);
+  static void  *SystemAllocate(size_t bytes,int type);
+  static void   SystemFree(void *ptr,int type);
+
   static void *Insert(void *ptr,size_t bytes,int type) ;
   static void *Lookup(size_t bytes,int type) ;
   static void *Insert(void *ptr,size_t bytes,AllocationCacheEntry *entries,int ncache,int &victim,uint64_t &cbytes) ;
   static void *Lookup(size_t bytes,AllocationCacheEntry *entries,int ncache,uint64_t &cbytes) ;
+  static void *ClassInsert(void *ptr,size_t bytes,int type);
+  static void *ClassLookup(size_t bytes,int type);
+  static void *SlabInsert(void *ptr,size_t bytes,int type);
+  static void *SlabLookup(size_t bytes,int type);
+  static void  SlabUnlist(int type,int slab);
 
  public:
   static void PrintBytes(void);
@@ -141,6 +193,11 @@ private:
   static uint64_t     DeviceCacheBytes();
   static uint64_t     HostCacheBytes();
 
+  static MemoryPoolStats HostPoolStats(void);
+  static MemoryPoolStats DevicePoolStats(void);
+  static MemoryPoolStats SharedPoolStats(void);
+  static void            PrintPoolStats(void);
+
   static MemoryStatus GetFootprint(void) {
     MemoryStatus stat;
     stat.DeviceBytes       = DeviceBytes;
@@ -154,6 +211,8 @@ private:
     stat.DeviceDestroy     = DeviceDestroy;
     stat.DeviceAllocCacheBytes = DeviceCacheBytes();
     stat.HostAllocCacheBytes   = HostCacheBytes();
+    stat.DeviceAllocMaxBytes   = DevicePoolStats().maxInuseBytes;
+    stat.HostAllocMaxBytes     = HostPoolStats().maxInuseBytes;
     return stat;
   };
   
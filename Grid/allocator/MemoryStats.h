@@ -35,9 +35,24 @@ std::string sizeString(size_t bytes);
 
 struct MemoryStats
 {
-  size_t totalAllocated{0}, maxAllocated{0}, 
+  size_t totalAllocated{0}, maxAllocated{0},
     currentlyAllocated{0}, totalFreed{0};
 };
+
+////////////////////////////////////////////////////////////
+// Per memory space accounting of the MemoryManager pool.
+// Byte counts are rounded up to the size class actually held.
+////////////////////////////////////////////////////////////
+struct MemoryPoolStats
+{
+  uint64_t hits{0}, misses{0};                  // requests served from the pool / from the system
+  uint64_t releases{0};                         // blocks handed back to the system
+  uint64_t entries{0}, slabs{0};                // free blocks and small object slabs held
+  uint64_t emptySlabs{0};                       // slabs held with every object free
+  uint64_t maxEntries{0}, maxEmptySlabs{0};     // limits, GRID_ALLOC_NCACHE_LARGE and _SMALL
+  uint64_t inuseBytes{0},  maxInuseBytes{0};    // handed out, high water mark
+  uint64_t cachedBytes{0}, maxCachedBytes{0};   // held free in the pool, high water mark
+};
     
 class MemoryProfiler
 {
@@ -34,6 +34,7 @@ Author: Peter Boyle <paboyle@ph.ed.ac.uk>
 NAMESPACE_BEGIN(Grid);
 
 bool Stencil_force_mpi = true;
+bool Stencil_persistent_comms = false;
 
 ///////////////////////////////////////////////////////////////
 // Info that is setup once and indept of cartesian layout
@@ -73,6 +74,10 @@ void CartesianCommunicator::GlobalSumVector(ComplexD *c,int N)
 {
   GlobalSumVector((double *)c,2*N);
 }
+void CartesianCommunicator::GlobalSumBegin(ComplexD *c,int N,CommsRequest_t &req)
+{
+  GlobalSumBegin((double *)c,2*N,req);
+}
   
 NAMESPACE_END(Grid);
 
@@ -36,6 +36,7 @@ Author: Peter Boyle <paboyle@ph.ed.ac.uk>
 NAMESPACE_BEGIN(Grid);
 
 extern bool Stencil_force_mpi ;
+extern bool Stencil_persistent_comms ;
 
 class CartesianCommunicator : public SharedMemory {
 
@@ -128,6 +129,14 @@ public:
   void GlobalXOR(uint32_t &);
   void GlobalXOR(uint64_t &);
 
+  ////////////////////////////////////////////////////////////
+  // Non-blocking reduction in place; the buffer must be left
+  // alone until GlobalSumComplete returns
+  ////////////////////////////////////////////////////////////
+  void GlobalSumBegin(RealD *,int N,CommsRequest_t &req);
+  void GlobalSumBegin(ComplexD *c,int N,CommsRequest_t &req);
+  void GlobalSumComplete(CommsRequest_t &req);
+
   template<class obj> void GlobalSumP2P(obj &o)
   {
     std::vector<obj> column;
@@ -197,6 +206,26 @@ public:
   void StencilSendToRecvFromComplete(std::vector<CommsRequest_t> &waitall,int i);
   void StencilBarrier(void);
 
+  ////////////////////////////////////////////////////////////
+  // Persistent halo exchange. Off node legs are registered once
+  // as MPI_Send_init/MPI_Recv_init requests and restarted with
+  // MPI_Startall; intranode legs are replayed as shared memory
+  // copies on every start.
+  ////////////////////////////////////////////////////////////
+  double StencilSendToRecvFromPersistentInit(std::vector<CommsRequest_t> &list,
+					     void *xmit,
+					     int xmit_to_rank,int do_xmit,
+					     void *recv,
+					     int recv_from_rank,int do_recv,
+					     int xbytes,int rbytes,int dir);
+  void StencilSendToRecvFromShm(void *xmit,
+				int xmit_to_rank,int do_xmit,
+				void *recv,
+				int xbytes);
+  void StencilPersistentStart(std::vector<CommsRequest_t> &list);
+  void StencilPersistentComplete(std::vector<CommsRequest_t> &list);
+  void StencilPersistentFree(std::vector<CommsRequest_t> &list);
+
   ////////////////////////////////////////////////////////////
   // Barrier
   ////////////////////////////////////////////////////////////
@@ -231,6 +260,48 @@ public:
 
 }; 
 
+////////////////////////////////////////////////////////////
+// Several pending global sums fused into a single message:
+//
+//   GlobalSumBatch red(grid);
+//   int a = red.Add(local_a);
+//   int b = red.Add(local_b);
+//   red.Begin();
+//   ... work independent of a and b ...
+//   red.Complete();
+//   use red[a], red[b]
+////////////////////////////////////////////////////////////
+class GlobalSumBatch {
+private:
+  CartesianCommunicator *comm;
+  std::vector<ComplexD>  buf;
+  CommsRequest_t         req;
+  int                    pending;
+public:
+  GlobalSumBatch(CartesianCommunicator *_comm) : comm(_comm), pending(0) {};
+  ~GlobalSumBatch() { Complete(); }
+
+  int Add(ComplexD local) {
+    assert(!pending);
+    buf.push_back(local);
+    return buf.size()-1;
+  }
+  void Begin(void) {
+    assert(!pending);
+    if ( buf.size() ) {
+      comm->GlobalSumBegin(&buf[0],buf.size(),req);
+      pending = 1;
+    }
+  }
+  void Complete(void) {
+    if ( pending ) comm->GlobalSumComplete(req);
+    pending = 0;
+  }
+  void Sum(void)   { Begin(); Complete(); }
+  void Reset(void) { assert(!pending); buf.resize(0); }
+  ComplexD operator[](int i) const { assert(!pending); return buf[i]; }
+};
+
 NAMESPACE_END(Grid);
 
 #endif
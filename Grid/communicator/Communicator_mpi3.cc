@@ -49,7 +49,10 @@ void CartesianCommunicator::Init(int *argc, char ***argv)
     // wrong results here too
     // For now: comms-overlap leads to wrong results in Benchmark_wilson even on single node MPI runs
     // other comms schemes are ok
-    MPI_Init_thread(argc,argv,MPI_THREAD_SERIALIZED,&provided);
+    // Background writers (asynchronous HMC checkpoints) call MPI from a second thread
+    int required = MPI_THREAD_SERIALIZED;
+    if ( GridCmdOptionExists(*argv,*argv+*argc,"--comms-thread-multiple") ) required = MPI_THREAD_MULTIPLE;
+    MPI_Init_thread(argc,argv,required,&provided);
 #else
     MPI_Init_thread(argc,argv,MPI_THREAD_MULTIPLE,&provided);
 #endif
@@ -306,6 +309,17 @@ void CartesianCommunicator::GlobalSumVector(double *d,int N)
   int ierr = MPI_Allreduce(MPI_IN_PLACE,d,N,MPI_DOUBLE,MPI_SUM,communicator);
   assert(ierr==0);
 }
+void CartesianCommunicator::GlobalSumBegin(double *d,int N,CommsRequest_t &req)
+{
+  int ierr = MPI_Iallreduce(MPI_IN_PLACE,d,N,MPI_DOUBLE,MPI_SUM,communicator,&req);
+  assert(ierr==0);
+}
+void CartesianCommunicator::GlobalSumComplete(CommsRequest_t &req)
+{
+  MPI_Status status;
+  int ierr = MPI_Wait(&req,&status);
+  assert(ierr==0);
+}
 
 void CartesianCommunicator::SendToRecvFromBegin(std::vector<CommsRequest_t> &list,
 						void *xmit,
@@ -463,6 +477,93 @@ void CartesianCommunicator::StencilBarrier(void)
 {
   MPI_Barrier  (ShmComm);
 }
+double CartesianCommunicator::StencilSendToRecvFromPersistentInit(std::vector<CommsRequest_t> &list,
+								  void *xmit,
+								  int dest,int dox,
+								  void *recv,
+								  int from,int dor,
+								  int xbytes,int rbytes,int dir)
+{
+  int ncomm  =communicator_halo.size();
+  int commdir=dir%ncomm;
+
+  MPI_Request xrq;
+  MPI_Request rrq;
+
+  int ierr;
+  int gdest = ShmRanks[dest];
+  int gfrom = ShmRanks[from];
+
+  assert(dest != _processor);
+  assert(from != _processor);
+  double off_node_bytes=0.0;
+  int tag;
+
+  // Same tags as StencilSendToRecvFromBegin so the two modes interoperate
+  if ( dor ) {
+    if ( (gfrom ==MPI_UNDEFINED) || Stencil_force_mpi ) {
+      tag= dir+from*32;
+      ierr=MPI_Recv_init(recv, rbytes, MPI_CHAR,from,tag,communicator_halo[commdir],&rrq);
+      assert(ierr==0);
+      list.push_back(rrq);
+      off_node_bytes+=rbytes;
+    }
+  }
+  if (dox) {
+    if ( (gdest == MPI_UNDEFINED) || Stencil_force_mpi ) {
+      tag= dir+_processor*32;
+      ierr =MPI_Send_init(xmit, xbytes, MPI_CHAR,dest,tag,communicator_halo[commdir],&xrq);
+      assert(ierr==0);
+      list.push_back(xrq);
+      off_node_bytes+=xbytes;
+    }
+  }
+  return off_node_bytes;
+}
+void CartesianCommunicator::StencilSendToRecvFromShm(void *xmit,
+						     int dest,int dox,
+						     void *recv,
+						     int xbytes)
+{
+  int gdest = ShmRanks[dest];
+  if ( dox && (gdest != MPI_UNDEFINED) && !Stencil_force_mpi ) {
+    void *shm = (void *) this->ShmBufferTranslate(dest,recv);
+    assert(shm!=NULL);
+    acceleratorCopyDeviceToDeviceAsynch(xmit,shm,xbytes);
+  }
+}
+void CartesianCommunicator::StencilPersistentStart(std::vector<CommsRequest_t> &list)
+{
+  int nreq=list.size();
+  if (nreq==0) return;
+  int ierr = MPI_Startall(nreq,&list[0]);
+  assert(ierr==0);
+}
+void CartesianCommunicator::StencilPersistentComplete(std::vector<CommsRequest_t> &list)
+{
+  int nreq=list.size();
+
+  acceleratorCopySynchronise();
+
+  if (nreq==0) return;
+
+  // Persistent requests become inactive, not null, so the list is kept for the next start
+  std::vector<MPI_Status> status(nreq);
+  int ierr = MPI_Waitall(nreq,&list[0],&status[0]);
+  assert(ierr==0);
+}
+void CartesianCommunicator::StencilPersistentFree(std::vector<CommsRequest_t> &list)
+{
+  int finalized;
+  MPI_Finalized(&finalized);
+  if ( !finalized ) {
+    for(int r=0;r<list.size();r++){
+      int ierr = MPI_Request_free(&list[r]);
+      assert(ierr==0);
+    }
+  }
+  list.resize(0);
+}
 //void CartesianCommunicator::SendToRecvFromComplete(std::vector<CommsRequest_t> &list)
 //{
 //}
@@ -75,6 +75,8 @@ void CartesianCommunicator::GlobalSum(float &){}
 void CartesianCommunicator::GlobalSumVector(float *,int N){}
 void CartesianCommunicator::GlobalSum(double &){}
 void CartesianCommunicator::GlobalSumVector(double *,int N){}
+void CartesianCommunicator::GlobalSumBegin(double *,int N,CommsRequest_t &req){}
+void CartesianCommunicator::GlobalSumComplete(CommsRequest_t &req){}
 void CartesianCommunicator::GlobalSum(uint32_t &){}
 void CartesianCommunicator::GlobalSum(uint64_t &){}
 void CartesianCommunicator::GlobalSumVector(uint64_t *,int N){}
@@ -147,6 +149,20 @@ void CartesianCommunicator::StencilSendToRecvFromComplete(std::vector<CommsReque
 
 void CartesianCommunicator::StencilBarrier(void){};
 
+double CartesianCommunicator::StencilSendToRecvFromPersistentInit(std::vector<CommsRequest_t> &list,
+								  void *xmit,
+								  int xmit_to_rank,int dox,
+								  void *recv,
+								  int recv_from_rank,int dor,
+								  int xbytes,int rbytes, int dir)
+{
+  return xbytes+rbytes;
+}
+void CartesianCommunicator::StencilSendToRecvFromShm(void *xmit,int xmit_to_rank,int dox,void *recv,int xbytes){};
+void CartesianCommunicator::StencilPersistentStart(std::vector<CommsRequest_t> &list){};
+void CartesianCommunicator::StencilPersistentComplete(std::vector<CommsRequest_t> &list){};
+void CartesianCommunicator::StencilPersistentFree(std::vector<CommsRequest_t> &list){ list.resize(0); };
+
 NAMESPACE_END(Grid);
 
 
@@ -245,4 +245,114 @@ void basisDeflate(const std::vector<Field> &_v,const std::vector<RealD>& eval,co
   }
 }
 
+//////////////////////////////////////////////////////////////////////////////
+// Fused linear combination and reductions, one pass over memory:
+//
+//   out[i] = sum_j A[i*nin+j] in[j]        i = 0 .. nout-1
+//
+// followed by the inner products <u,v> listed in products, where an index
+// i < nout names out[i] after the update and nout+j names in[j]. The local
+// sums are queued on batch; their slots are returned in slots.
+//
+// Outputs are written in order, so out[i] may alias in[j] provided no
+// later output reads in[j], eg. x = x + a p ; p = r + b p.
+//////////////////////////////////////////////////////////////////////////////
+template<class Field>
+void linearCombinationBegin(GlobalSumBatch &batch,std::vector<int> &slots,
+			    const std::vector<Field *> &out,
+			    const std::vector<const Field *> &in,
+			    const std::vector<RealD> &A,
+			    const std::vector<std::pair<int,int> > &products)
+{
+  GRID_TRACE("linearCombination");
+  typedef typename Field::vector_object vobj;
+  typedef decltype(innerProduct(vobj(),vobj())) inner_t;
+  typedef decltype(in[0]->View(AcceleratorRead)) View;
+
+  int nout  = out.size();
+  int nin   = in.size();
+  int nprod = products.size();
+  assert(nout>=1 && nin>=1);
+  assert(A.size()==nout*nin);
+
+  GridBase *grid = in[0]->Grid();
+  const uint64_t sites = grid->oSites();
+  for(int i=0;i<nout;i++) {
+    conformable(out[i]->Grid(),grid);
+    out[i]->Checkerboard() = in[0]->Checkerboard();
+  }
+
+  // Views of the outputs followed by the inputs, so products index both
+  Vector<View> all_v; all_v.reserve(nout+nin);
+  for(int i=0;i<nout;i++) all_v.push_back(out[i]->View(AcceleratorWrite));
+  for(int j=0;j<nin ;j++) all_v.push_back(in[j]->View(AcceleratorRead));
+  auto all_vp = &all_v[0];
+
+  Vector<RealD> A_v(A.begin(),A.end());
+  auto A_p = &A_v[0];
+
+  Vector<int> prod_v(2*nprod+1);
+  for(int p=0;p<nprod;p++){
+    assert(products[p].first  < nout+nin);
+    assert(products[p].second < nout+nin);
+    prod_v[2*p]   = products[p].first;
+    prod_v[2*p+1] = products[p].second;
+  }
+  auto prod_p = &prod_v[0];
+
+  deviceVector<inner_t> inner_tmp(sites*nprod+1);
+  auto inner_tmp_v = &inner_tmp[0];
+
+  accelerator_for(ss, sites, vobj::Nsimd(), {
+    vobj zzz=Zero();
+    for(int i=0;i<nout;i++){
+      auto B=coalescedRead(zzz);
+      for(int j=0;j<nin;j++){
+	RealD a = A_p[i*nin+j];
+	if ( a != 0.0 ) B = B + a * coalescedRead(all_vp[nout+j][ss]);
+      }
+      coalescedWrite(all_vp[i][ss],B);
+    }
+    for(int p=0;p<nprod;p++){
+      auto u = coalescedRead(all_vp[prod_p[2*p]  ][ss]);
+      auto v = coalescedRead(all_vp[prod_p[2*p+1]][ss]);
+      coalescedWrite(inner_tmp_v[p*sites+ss],innerProduct(u,v));
+    }
+  });
+
+  for(int k=0;k<nout+nin;k++) all_v[k].ViewClose();
+
+  slots.resize(nprod);
+  for(int p=0;p<nprod;p++){
+    ComplexD local = TensorRemove(sumD(&inner_tmp_v[p*sites],sites));
+    slots[p] = batch.Add(local);
+  }
+}
+
+// Blocking form; result[p] is the global value of products[p]
+template<class Field>
+void linearCombination(const std::vector<Field *> &out,
+		       const std::vector<const Field *> &in,
+		       const std::vector<RealD> &A,
+		       const std::vector<std::pair<int,int> > &products,
+		       std::vector<ComplexD> &result)
+{
+  GlobalSumBatch batch(in[0]->Grid());
+  std::vector<int> slots;
+  linearCombinationBegin(batch,slots,out,in,A,products);
+  batch.Sum();
+  result.resize(slots.size());
+  for(int p=0;p<slots.size();p++) result[p] = batch[slots[p]];
+}
+
+template<class Field>
+void linearCombination(const std::vector<Field *> &out,
+		       const std::vector<const Field *> &in,
+		       const std::vector<RealD> &A)
+{
+  std::vector<std::pair<int,int> > none;
+  std::vector<ComplexD> result;
+  linearCombination(out,in,A,none,result);
+}
+
 NAMESPACE_END(Grid);
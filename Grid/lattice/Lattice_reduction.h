@@ -311,6 +311,20 @@ inline ComplexD innerProduct(const Lattice<vobj> &left,const Lattice<vobj> &righ
   return nrm;
 }
 
+/////////////////////////
+// Non-blocking variants: queue the local result on a GlobalSumBatch and
+// read it back from the batch after Complete(); returns the slot.
+/////////////////////////
+template<class vobj>
+inline int innerProductBegin(GlobalSumBatch &batch,const Lattice<vobj> &left,const Lattice<vobj> &right) {
+  conformable(left,right);
+  return batch.Add(rankInnerProduct(left,right));
+}
+template<class vobj>
+inline int norm2Begin(GlobalSumBatch &batch,const Lattice<vobj> &arg) {
+  return batch.Add(rankInnerProduct(arg,arg));
+}
+
 
 /////////////////////////
 // Fast axpby_norm
@@ -438,7 +452,12 @@ inline auto sum(const LatticeTrinaryExpression<Op,T1,T2,T3> & expr)
 // sliceSum, sliceInnerProduct, sliceAxpy, sliceNorm etc...
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-template<class vobj> inline void sliceSum(const Lattice<vobj> &Data,std::vector<typename vobj::scalar_object> &result,int orthogdim)
+//////////////////////////////////////////////////////////////////////////////
+// Node local part of sliceSum: fd entries in global slice order, with zero
+// in the slices owned by other nodes. A GlobalSumVector over the buffer
+// completes the reduction, so many fields can share a single one.
+//////////////////////////////////////////////////////////////////////////////
+template<class vobj> inline void sliceSumLocal(const Lattice<vobj> &Data,typename vobj::scalar_object *result,int orthogdim)
 {
   ///////////////////////////////////////////////////////
   // FIXME precision promoted summation
@@ -446,7 +465,6 @@ template<class vobj> inline void sliceSum(const Lattice<vobj> &Data,std::vector<
   // But easily avoided by using double precision fields
   ///////////////////////////////////////////////////////
   typedef typename vobj::scalar_object sobj;
-  typedef typename vobj::scalar_object::scalar_type scalar_type;
   GridBase  *grid = Data.Grid();
   assert(grid!=NULL);
 
@@ -464,7 +482,6 @@ template<class vobj> inline void sliceSum(const Lattice<vobj> &Data,std::vector<
   Vector<sobj> lsSum(ld,Zero());                    // sum across these down to scalars
   ExtractBuffer<sobj> extracted(Nsimd);                  // splitting the SIMD
 
-  result.resize(fd); // And then global sum to return the same vector to every node 
   for(int r=0;r<rd;r++){
     lvSum[r]=Zero();
   }
@@ -495,7 +512,7 @@ template<class vobj> inline void sliceSum(const Lattice<vobj> &Data,std::vector<
     }
   }
   
-  // sum over nodes.
+  // place in the global slice order, ready to sum over nodes.
   for(int t=0;t<fd;t++){
     int pt = t/ld; // processor plane
     int lt = t%ld;
@@ -504,8 +521,23 @@ template<class vobj> inline void sliceSum(const Lattice<vobj> &Data,std::vector<
     } else {
       result[t]=Zero();
     }
-
   }
+}
+
+template<class vobj> inline void sliceSum(const Lattice<vobj> &Data,std::vector<typename vobj::scalar_object> &result,int orthogdim)
+{
+  typedef typename vobj::scalar_object sobj;
+  typedef typename vobj::scalar_object::scalar_type scalar_type;
+  GridBase  *grid = Data.Grid();
+  assert(grid!=NULL);
+  assert(orthogdim >= 0);
+  assert(orthogdim < grid->_ndimension);
+
+  int fd=grid->_fdimensions[orthogdim];
+
+  result.resize(fd); // And then global sum to return the same vector to every node 
+  sliceSumLocal(Data,&result[0],orthogdim);
+
   scalar_type * ptr = (scalar_type *) &result[0];
   int words = fd*sizeof(sobj)/sizeof(scalar_type);
   grid->GlobalSumVector(ptr, words);
@@ -519,6 +551,105 @@ sliceSum(const Lattice<vobj> &Data,int orthogdim)
   return result;
 }
 
+//////////////////////////////////////////////////////////////////////////////
+// Batched sliceSum: nfield fields on the same grid are reduced locally one
+// after the other into one contiguous buffer, followed by a single
+// GlobalSumVector for all of them. Correlator and A2A codes summing
+// thousands of contractions pay one collective instead of thousands.
+//////////////////////////////////////////////////////////////////////////////
+template<class vobj> inline void sliceSum(const Lattice<vobj> *Data,int nfield,
+					  std::vector<std::vector<typename vobj::scalar_object> > &result,int orthogdim)
+{
+  typedef typename vobj::scalar_object sobj;
+  typedef typename vobj::scalar_object::scalar_type scalar_type;
+  assert(nfield>0);
+  GridBase  *grid = Data[0].Grid();
+  assert(grid!=NULL);
+  assert(orthogdim >= 0);
+  assert(orthogdim < grid->_ndimension);
+
+  int fd=grid->_fdimensions[orthogdim];
+
+  std::vector<sobj> buffer(nfield*fd);
+  for(int f=0;f<nfield;f++){
+    conformable(grid,Data[f].Grid());
+    sliceSumLocal(Data[f],&buffer[f*fd],orthogdim);
+  }
+
+  scalar_type * ptr = (scalar_type *) &buffer[0];
+  int words = nfield*fd*sizeof(sobj)/sizeof(scalar_type);
+  grid->GlobalSumVector(ptr, words);
+
+  result.resize(nfield);
+  for(int f=0;f<nfield;f++){
+    result[f].assign(buffer.begin()+f*fd,buffer.begin()+(f+1)*fd);
+  }
+}
+template<class vobj> inline void sliceSum(const std::vector<Lattice<vobj> > &Data,
+					  std::vector<std::vector<typename vobj::scalar_object> > &result,int orthogdim)
+{
+  sliceSum(&Data[0],Data.size(),result,orthogdim);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Momentum projected batched sliceSum
+//
+//   result[m+Nmom*f][t] = sum_{x in slice t} phase[m](x) Data[f](x)
+//
+// Each phase is applied in the kernel filling a single work field, so
+// Nmom*nfield products are never held at once, and the whole set is
+// still one GlobalSumVector.
+//////////////////////////////////////////////////////////////////////////////
+template<class vobj,class cobj> inline void sliceSum(const Lattice<vobj> *Data,int nfield,
+						     const std::vector<Lattice<cobj> > &phase,
+						     std::vector<std::vector<typename vobj::scalar_object> > &result,int orthogdim)
+{
+  typedef typename vobj::scalar_object sobj;
+  typedef typename vobj::scalar_object::scalar_type scalar_type;
+  assert(nfield>0);
+  GridBase  *grid = Data[0].Grid();
+  assert(grid!=NULL);
+  assert(orthogdim >= 0);
+  assert(orthogdim < grid->_ndimension);
+
+  int fd  =grid->_fdimensions[orthogdim];
+  int Nmom=phase.size();
+  int nres=Nmom*nfield;
+
+  std::vector<sobj> buffer(nres*fd);
+  Lattice<vobj> work(grid);
+  for(int f=0;f<nfield;f++){
+    conformable(grid,Data[f].Grid());
+    for(int m=0;m<Nmom;m++){
+      conformable(grid,phase[m].Grid());
+      {
+	autoView( d_v , Data[f] , AcceleratorRead);
+	autoView( p_v , phase[m], AcceleratorRead);
+	autoView( w_v , work    , AcceleratorWrite);
+	accelerator_for(ss,grid->oSites(),vobj::Nsimd(),{
+	  coalescedWrite(w_v[ss],p_v(ss)*d_v(ss));
+	});
+      }
+      sliceSumLocal(work,&buffer[(m+Nmom*f)*fd],orthogdim);
+    }
+  }
+
+  scalar_type * ptr = (scalar_type *) &buffer[0];
+  int words = nres*fd*sizeof(sobj)/sizeof(scalar_type);
+  grid->GlobalSumVector(ptr, words);
+
+  result.resize(nres);
+  for(int r=0;r<nres;r++){
+    result[r].assign(buffer.begin()+r*fd,buffer.begin()+(r+1)*fd);
+  }
+}
+template<class vobj,class cobj> inline void sliceSum(const std::vector<Lattice<vobj> > &Data,
+						     const std::vector<Lattice<cobj> > &phase,
+						     std::vector<std::vector<typename vobj::scalar_object> > &result,int orthogdim)
+{
+  sliceSum(&Data[0],Data.size(),phase,result,orthogdim);
+}
+
 /*
 Reimplement
 
@@ -599,20 +730,54 @@ static void sliceInnerProductVector( std::vector<ComplexD> & result, const Latti
     }
   }
   
-  // sum over nodes.
-  scalar_type gsum;
+  // sum over nodes, all slices in one message.
   for(int t=0;t<fd;t++){
     int pt = t/ld; // processor plane
     int lt = t%ld;
     if ( pt == grid->_processor_coor[orthogdim] ) {
-      gsum=lsSum[lt];
+      result[t]=lsSum[lt];
     } else {
-      gsum=scalar_type(0.0);
+      result[t]=ComplexD(0.0);
     }
+  }
+  grid->GlobalSumVector(&result[0],fd);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Batched sliceInnerProductVector: result[i][t] = <lhs[i],rhs[i]> on slice t
+// for every pair, with a single GlobalSumVector for the whole set.
+//////////////////////////////////////////////////////////////////////////////
+template<class vobj>
+static void sliceInnerProductVector( std::vector<std::vector<ComplexD> > & result,
+				     const std::vector<Lattice<vobj> > &lhs,
+				     const std::vector<Lattice<vobj> > &rhs,int orthogdim) 
+{
+  typedef typename vobj::tensor_reduced::scalar_object sobj;
+  assert(lhs.size()==rhs.size());
+  assert(lhs.size()>0);
+  GridBase  *grid = lhs[0].Grid();
+  assert(grid!=NULL);
+  assert(orthogdim >= 0);
+  assert(orthogdim < grid->_ndimension);
+
+  int fd  =grid->_fdimensions[orthogdim];
+  int npair=lhs.size();
+
+  std::vector<sobj> lsum(fd);
+  std::vector<ComplexD> buffer(npair*fd);
+  for(int i=0;i<npair;i++){
+    conformable(grid,lhs[i].Grid());
+    conformable(grid,rhs[i].Grid());
+    auto ip = localInnerProduct(lhs[i],rhs[i]);
+    sliceSumLocal(ip,&lsum[0],orthogdim);
+    for(int t=0;t<fd;t++) buffer[i*fd+t] = TensorRemove(lsum[t]);
+  }
 
-    grid->GlobalSum(gsum);
+  grid->GlobalSumVector(&buffer[0],npair*fd);
 
-    result[t]=gsum;
+  result.resize(npair);
+  for(int i=0;i<npair;i++){
+    result[i].assign(buffer.begin()+i*fd,buffer.begin()+(i+1)*fd);
   }
 }
 template<class vobj>
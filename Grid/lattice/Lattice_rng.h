@@ -31,9 +31,8 @@
 
 #include <random>
 
-#ifdef RNG_SITMO
+// Threefish rounds are shared with the counter based parallel fill
 #include <Grid/sitmo_rng/sitmo_prng_engine.hpp>
-#endif 
 
 #if defined(RNG_SITMO)
 #define RNG_FAST_DISCARD
@@ -120,6 +119,124 @@ void fillScalar(ComplexD &s,distribution &dist,generator &gen)
   s.imag(dist(gen));
 }
   
+// Z2 noise, each real component +/-1
+class z2_distribution {
+  std::bernoulli_distribution _flip;
+public:
+  typedef RealD result_type;
+  void reset(void) { _flip.reset(); }
+  template<class generator> RealD operator()(generator &gen) { return _flip(gen) ? 1.0 : -1.0; }
+};
+
+//////////////////////////////////////////////////////////////
+// Counter based generation.
+// Every 256 bit block is the Threefish-256 encryption (13 rounds,
+// identical to sitmo::prng_engine) of the counter
+//   (global site, fill number, block, 0)
+// under a key derived from the seeds. There is no per-site state,
+// seeding is O(1) and the stream at a site does not depend on the
+// MPI or SIMD decomposition.
+//////////////////////////////////////////////////////////////
+enum CounterRNGDistribution { CounterRNGUniform, CounterRNGGaussian, CounterRNGBernoulli, CounterRNGZ2 };
+
+// Threefish mixing, as MIX2/MIXK in sitmo_prng_engine.hpp (which undefines them)
+accelerator_inline uint64_t CounterRNGRotl(uint64_t x,int r) { return (x << r) | (x >> (64-r)); }
+
+accelerator_inline void CounterRNGMix2(uint64_t &x0,uint64_t &x1,int rx,
+				       uint64_t &z0,uint64_t &z1,int rz)
+{
+  x0 += x1;
+  z0 += z1;
+  x1 = CounterRNGRotl(x1,rx) ^ x0;
+  z1 = CounterRNGRotl(z1,rz) ^ z0;
+}
+
+accelerator_inline void CounterRNGMixK(uint64_t &x0,uint64_t &x1,int rx,
+				       uint64_t &z0,uint64_t &z1,int rz,
+				       uint64_t k0,uint64_t k1,uint64_t l0,uint64_t l1)
+{
+  x1 += k1;
+  z1 += l1;
+  x0 += x1+k0;
+  z0 += z1+l0;
+  x1 = CounterRNGRotl(x1,rx) ^ x0;
+  z1 = CounterRNGRotl(z1,rz) ^ z0;
+}
+
+accelerator_inline void CounterRNGEncrypt(const uint64_t *key,uint64_t *b)
+{
+  uint64_t k[5];
+  for(int i=0;i<4;i++) k[i] = key[i];
+  k[4] = 0x1BD11BDAA9FC1A22 ^ k[0] ^ k[1] ^ k[2] ^ k[3];
+
+  CounterRNGMixK(b[0], b[1], 14,   b[2], b[3], 16,   k[0], k[1], k[2], k[3]);
+  CounterRNGMix2(b[0], b[3], 52,   b[2], b[1], 57);
+  CounterRNGMix2(b[0], b[1], 23,   b[2], b[3], 40);
+  CounterRNGMix2(b[0], b[3],  5,   b[2], b[1], 37);
+  CounterRNGMixK(b[0], b[1], 25,   b[2], b[3], 33,   k[1], k[2], k[3], k[4]+1);
+  CounterRNGMix2(b[0], b[3], 46,   b[2], b[1], 12);
+  CounterRNGMix2(b[0], b[1], 58,   b[2], b[3], 22);
+  CounterRNGMix2(b[0], b[3], 32,   b[2], b[1], 32);
+
+  CounterRNGMixK(b[0], b[1], 14,   b[2], b[3], 16,   k[2], k[3], k[4], k[0]+2);
+  CounterRNGMix2(b[0], b[3], 52,   b[2], b[1], 57);
+  CounterRNGMix2(b[0], b[1], 23,   b[2], b[3], 40);
+  CounterRNGMix2(b[0], b[3],  5,   b[2], b[1], 37);
+  CounterRNGMixK(b[0], b[1], 25,   b[2], b[3], 33,   k[3], k[4], k[0], k[1]+3);
+
+  CounterRNGMix2(b[0], b[3], 46,   b[2], b[1], 12);
+  CounterRNGMix2(b[0], b[1], 58,   b[2], b[3], 22);
+  CounterRNGMix2(b[0], b[3], 32,   b[2], b[1], 32);
+
+  CounterRNGMixK(b[0], b[1], 14,   b[2], b[3], 16,   k[4], k[0], k[1], k[2]+4);
+  CounterRNGMix2(b[0], b[3], 52,   b[2], b[1], 57);
+  CounterRNGMix2(b[0], b[1], 23,   b[2], b[3], 40);
+  CounterRNGMix2(b[0], b[3],  5,   b[2], b[1], 37);
+
+  for(int i=0;i<4;i++) b[i] += k[i];
+  b[3] += 5;
+}
+
+// Two reals from two 64 bit words; Box-Muller pairs for the gaussian
+accelerator_inline void CounterRNGPair(int dist,uint64_t x0,uint64_t x1,RealD &r0,RealD &r1)
+{
+  const RealD ulp = 1.0/9007199254740992.0; // 2^-53
+  if ( dist==CounterRNGGaussian ) {
+    RealD u0 = ((x0>>11)+0.5)*ulp;           // (0,1), log is finite
+    RealD th = 2.0*M_PI*(x1>>11)*ulp;
+    RealD r  = sqrt(-2.0*log(u0));
+    r0 = r*cos(th);
+    r1 = r*sin(th);
+  } else if ( dist==CounterRNGBernoulli ) {
+    r0 = (RealD)(x0>>63);
+    r1 = (RealD)(x1>>63);
+  } else if ( dist==CounterRNGZ2 ) {
+    r0 = (x0>>63) ? 1.0 : -1.0;
+    r1 = (x1>>63) ? 1.0 : -1.0;
+  } else {
+    r0 = (x0>>11)*ulp;
+    r1 = (x1>>11)*ulp;
+  }
+}
+
+// Lexicographic global index of outer site ss, lane; the counter word
+accelerator_inline uint64_t CounterRNGSite(uint64_t ss,int lane,int nd,
+					   const Coordinate &rdim,const Coordinate &simd,
+					   const Coordinate &ldim,const Coordinate &fdim,
+					   const Coordinate &pcoor)
+{
+  uint64_t idx=0, stride=1;
+  uint64_t o = ss;
+  int      i = lane;
+  for(int d=0;d<nd;d++){
+    int oc = o % rdim[d]; o = o / rdim[d];
+    int ic = i % simd[d]; i = i / simd[d];
+    idx   += stride*(uint64_t)(pcoor[d]*ldim[d] + ic*rdim[d] + oc);
+    stride*= fdim[d];
+  }
+  return idx;
+}
+
 class GridRNGbase {
 public:
   // One generator per site.
@@ -145,6 +262,7 @@ public:
   std::vector<std::normal_distribution<RealD> >       _gaussian;
   std::vector<std::discrete_distribution<int32_t> >   _bernoulli;
   std::vector<std::uniform_int_distribution<uint32_t> > _uid;
+  std::vector<z2_distribution>                        _z2;
 
   ///////////////////////
   // support for parallel init
@@ -250,6 +368,7 @@ public:
     _gaussian.resize(1,std::normal_distribution<RealD>(0.0,1.0) );
     _bernoulli.resize(1,std::discrete_distribution<int32_t>{1,1});
     _uid.resize(1,std::uniform_int_distribution<uint32_t>() );
+    _z2.resize(1);
   }
 
   template <class sobj,class distribution> inline void fill(sobj &l,std::vector<distribution> &dist){
@@ -349,6 +468,18 @@ private:
   GridBase *_grid;
   unsigned int _vol;
 
+  // Counter based mode, see SeedCounterIntegers
+  bool     _counter_based;
+  uint64_t _key[4];
+  uint64_t _counter;
+
+  static int CounterDistribution(std::vector<std::uniform_real_distribution<RealD> > &dist) { return CounterRNGUniform;  }
+  static int CounterDistribution(std::vector<std::normal_distribution<RealD> > &dist)       { return CounterRNGGaussian; }
+  static int CounterDistribution(std::vector<std::discrete_distribution<int32_t> > &dist)   { return CounterRNGBernoulli;}
+  static int CounterDistribution(std::vector<z2_distribution> &dist)                        { return CounterRNGZ2;       }
+  template<class distribution>
+  static int CounterDistribution(std::vector<distribution> &dist) { assert(0); return -1; } // no counter form
+
 public:
   GridBase *Grid(void) const { return _grid; }
   int generator_idx(int os,int is) {
@@ -364,6 +495,11 @@ public:
     _gaussian.resize(_vol,std::normal_distribution<RealD>(0.0,1.0) );
     _bernoulli.resize(_vol,std::discrete_distribution<int32_t>{1,1});
     _uid.resize(_vol,std::uniform_int_distribution<uint32_t>() );
+    _z2.resize(_vol);
+
+    _counter_based = false;
+    _counter = 0;
+    for(int i=0;i<4;i++) _key[i]=0;
   }
   template <class vobj,class distribution> inline void fill(Lattice<vobj> &l,std::vector<distribution> &dist)
   {
@@ -373,6 +509,10 @@ public:
       pickCheckerboard(l.Checkerboard(),l,tmp);
       return;
     }
+    if ( _counter_based ) {
+      fillCounter(l,CounterDistribution(dist));
+      return;
+    }
     typedef typename vobj::scalar_object scalar_object;
     typedef typename vobj::scalar_type scalar_type;
     typedef typename vobj::vector_type vector_type;
@@ -408,6 +548,91 @@ public:
     _time_counter += usecond()- inner_time_counter;
   }
 
+  ////////////////////////////////////////////////////////////////////////
+  // Counter based fill. Each lane of each SIMD word is written in place
+  // from the cipher output for its global site; no ExtractBuffer/merge.
+  // On CPU the lane loop is innermost so the cipher and Box-Muller run
+  // across a SIMD word at once.
+  ////////////////////////////////////////////////////////////////////////
+  template <class vobj> inline void fillCounter(Lattice<vobj> &l,int dist)
+  {
+    typedef typename vobj::scalar_type scalar_type;
+    typedef typename vobj::vector_type vector_type;
+    typedef typename RealPart<scalar_type>::type real_type;
+
+    double inner_time_counter = usecond();
+
+    GridBase *grid = l.Grid();
+    const int Nsimd = vector_type::Nsimd();
+    const int cplx  = is_complex<scalar_type>::value ? 2 : 1;
+    const int ncomp = cplx*sizeof(vobj)/sizeof(vector_type); // reals per site
+    const int nblock= (ncomp+3)/4;                            // four 64 bit words per block
+    const int nd    = grid->_ndimension;
+    uint64_t osites = grid->oSites();
+
+    Coordinate rdim = grid->_rdimensions;
+    Coordinate simd = grid->_simd_layout;
+    Coordinate ldim = grid->_ldimensions;
+    Coordinate fdim = grid->_fdimensions;
+    Coordinate pcoor= grid->ThisProcessorCoor();
+
+    uint64_t key[4];
+    for(int i=0;i<4;i++) key[i]=_key[i];
+    uint64_t counter = _counter++;
+
+#ifdef GRID_SIMT
+    autoView(l_v, l, AcceleratorWrite);
+    accelerator_for(ss, osites, Nsimd, {
+      int lane = acceleratorSIMTlane(Nsimd);
+      real_type *p = (real_type *)&l_v[ss];
+      uint64_t site = CounterRNGSite(ss,lane,nd,rdim,simd,ldim,fdim,pcoor);
+      for(int b=0;b<nblock;b++){
+	uint64_t x[4] = { site, counter, (uint64_t)b, 0 };
+	CounterRNGEncrypt(key,x);
+	for(int j=0;j<4;j+=2){
+	  RealD r[2];
+	  CounterRNGPair(dist,x[j],x[j+1],r[0],r[1]);
+	  for(int jj=0;jj<2;jj++){
+	    int c = 4*b+j+jj;
+	    if ( c<ncomp ) p[((c/cplx)*Nsimd+lane)*cplx+c%cplx] = r[jj];
+	  }
+	}
+      }
+    });
+#else
+    autoView(l_v, l, CpuWrite);
+    thread_for(ss, osites, {
+      real_type *p = (real_type *)&l_v[ss];
+      uint64_t site[Nsimd];
+      uint64_t x[4][Nsimd];
+      RealD    r[4][Nsimd];
+      for(int lane=0;lane<Nsimd;lane++) site[lane] = CounterRNGSite(ss,lane,nd,rdim,simd,ldim,fdim,pcoor);
+      for(int b=0;b<nblock;b++){
+	for(int lane=0;lane<Nsimd;lane++){
+	  uint64_t xl[4] = { site[lane], counter, (uint64_t)b, 0 };
+	  CounterRNGEncrypt(key,xl);
+	  for(int j=0;j<4;j++) x[j][lane] = xl[j];
+	}
+	for(int j=0;j<4;j+=2){
+	  for(int lane=0;lane<Nsimd;lane++){
+	    CounterRNGPair(dist,x[j][lane],x[j+1][lane],r[j][lane],r[j+1][lane]);
+	  }
+	}
+	for(int j=0;j<4;j++){
+	  int c = 4*b+j;
+	  if ( c<ncomp ) {
+	    for(int lane=0;lane<Nsimd;lane++){
+	      p[((c/cplx)*Nsimd+lane)*cplx+c%cplx] = r[j][lane];
+	    }
+	  }
+	}
+      }
+    });
+#endif
+
+    _time_counter += usecond()- inner_time_counter;
+  }
+
     void SeedUniqueString(const std::string &s){
       std::vector<int> seeds;
       seeds = GridChecksum::sha256_seeds(s);
@@ -416,8 +641,82 @@ public:
       std::cout << GridLogMessage << "Seed SHA256: " << GridChecksum::sha256_string(seeds) << std::endl;
       SeedFixedIntegers(seeds);
     }
+  ////////////////////////////////////////////////////////////////////////
+  // Switch to the counter based generator. The key is formed from the
+  // seeds as sitmo::prng_engine does; no per-site generator is touched.
+  ////////////////////////////////////////////////////////////////////////
+  void SeedCounterIntegers(const std::vector<int> &seeds){
+    CartesianCommunicator::BroadcastWorld(0,(void *)&seeds[0],sizeof(int)*seeds.size());
+    std::seed_seq source(seeds.begin(),seeds.end());
+    uint32_t w[8];
+    source.generate(&w[0],&w[8]);
+    for(int i=0;i<4;i++){
+      _key[i] = ( static_cast<uint64_t>(w[2*i]) << 32) | w[2*i+1];
+    }
+    _counter = 0;
+    _counter_based = true;
+  }
+  void SeedCounterString(const std::string &s){
+    std::vector<int> seeds;
+    seeds = GridChecksum::sha256_seeds(s);
+    std::cout << GridLogMessage << "Intialising counter based parallel RNG with unique string '" 
+	      << s << "'" << std::endl;
+    std::cout << GridLogMessage << "Seed SHA256: " << GridChecksum::sha256_string(seeds) << std::endl;
+    SeedCounterIntegers(seeds);
+  }
+  bool CounterBased(void) const { return _counter_based; }
+
+  // Complete state of the counter based mode: key and fill counter
+  void GetCounterState(std::vector<uint64_t> &saved) const {
+    assert(_counter_based);
+    saved.resize(5);
+    for(int i=0;i<4;i++) saved[i]=_key[i];
+    saved[4] = _counter;
+  }
+  void SetCounterState(const std::vector<uint64_t> &saved){
+    assert(saved.size()==5);
+    for(int i=0;i<4;i++) _key[i]=saved[i];
+    _counter = saved[4];
+    _counter_based = true;
+  }
+  // Back to the per-site generators, e.g. when their states are restored
+  void SiteGenerators(void) { _counter_based = false; }
+
+  // The counter state as one per-site record of an RNG checkpoint, tagged
+  // so that a restore tells it from per-site generator states. Every site
+  // carries the same record; the file layout is unchanged.
+  static constexpr uint64_t CounterRecordTag = 0x436f756e74524e47ULL; // "CountRNG"
+  void GetCounterRecord(std::vector<RngStateType> &rec) const {
+    const int per = sizeof(uint64_t)/sizeof(RngStateType);
+    std::vector<uint64_t> st;
+    GetCounterState(st);
+    st.insert(st.begin(),CounterRecordTag);
+    assert(st.size()*per <= RngStateCount);
+    rec.assign(RngStateCount,0);
+    for(int i=0;i<st.size();i++){
+      for(int p=0;p<per;p++){
+	rec[i*per+p] = (RngStateType)(st[i] >> (8*sizeof(RngStateType)*p));
+      }
+    }
+  }
+  bool SetCounterRecord(const std::vector<RngStateType> &rec) {
+    const int per = sizeof(uint64_t)/sizeof(RngStateType);
+    std::vector<uint64_t> st(6,0);
+    for(int i=0;i<st.size();i++){
+      for(int p=0;p<per;p++){
+	st[i] |= ((uint64_t)rec[i*per+p]) << (8*sizeof(RngStateType)*p);
+      }
+    }
+    if ( st[0] != CounterRecordTag ) return false;
+    st.erase(st.begin());
+    SetCounterState(st);
+    return true;
+  }
+
   void SeedFixedIntegers(const std::vector<int> &seeds, int britney=0){
 
+    _counter_based = false;
+
     // Everyone generates the same seed_seq based on input seeds
     CartesianCommunicator::BroadcastWorld(0,(void *)&seeds[0],sizeof(int)*seeds.size());
 
@@ -532,10 +831,12 @@ public:
 template <class vobj> inline void random(GridParallelRNG &rng,Lattice<vobj> &l)   { rng.fill(l,rng._uniform);  }
 template <class vobj> inline void gaussian(GridParallelRNG &rng,Lattice<vobj> &l) { rng.fill(l,rng._gaussian); }
 template <class vobj> inline void bernoulli(GridParallelRNG &rng,Lattice<vobj> &l){ rng.fill(l,rng._bernoulli);}
+template <class vobj> inline void z2(GridParallelRNG &rng,Lattice<vobj> &l)       { rng.fill(l,rng._z2);       }
 
 template <class sobj> inline void random(GridSerialRNG &rng,sobj &l)   { rng.fill(l,rng._uniform  ); }
 template <class sobj> inline void gaussian(GridSerialRNG &rng,sobj &l) { rng.fill(l,rng._gaussian ); }
 template <class sobj> inline void bernoulli(GridSerialRNG &rng,sobj &l){ rng.fill(l,rng._bernoulli); }
+template <class sobj> inline void z2(GridSerialRNG &rng,sobj &l)       { rng.fill(l,rng._z2       ); }
 
 NAMESPACE_END(Grid);
 #endif
@@ -27,6 +27,7 @@ Author: Peter Boyle pboyle@bnl.gov
 #pragma once
 
 #include<Grid/cshift/Cshift.h>
+#include<Grid/stencil/HaloCompression.h>
 
 NAMESPACE_BEGIN(Grid);
 
@@ -233,6 +234,7 @@ public:
   int dims;
   int depth;
   std::vector<GridCartesian *> grids;
+  mutable HaloCompressionStats HaloCompressionCounters; // face compression in ExchangePeriodic
 
   ~PaddedCell()
   {
@@ -312,13 +314,13 @@ public:
     return tmp;
   }
   template<class vobj>
-  inline Lattice<vobj> ExchangePeriodic(const Lattice<vobj> &in) const
+  inline Lattice<vobj> ExchangePeriodic(const Lattice<vobj> &in,int compression=HaloCompressionNone) const
   {
     GridBase *old_grid = in.Grid();
     int dims = old_grid->Nd();
     Lattice<vobj> tmp = in;
     for(int d=0;d<dims;d++){
-      tmp = ExpandPeriodic(d,tmp); // rvalue && assignment
+      tmp = ExpandPeriodic(d,tmp,compression); // rvalue && assignment
     }
     return tmp;
   }
@@ -396,7 +398,7 @@ public:
   }
 
   template<class vobj>
-  inline Lattice<vobj> ExpandPeriodic(int dim, const Lattice<vobj> &in) const
+  inline Lattice<vobj> ExpandPeriodic(int dim, const Lattice<vobj> &in,int compression=HaloCompressionNone) const
   {
     Coordinate processors=unpadded_grid->_processors;
     GridBase *old_grid = in.Grid();
@@ -417,7 +419,7 @@ public:
     if ( islocal ) {
       padded=in; // slightly different interface could avoid a copy operation
     } else {
-      Face_exchange(in,padded,dim,depth);
+      Face_exchange(in,padded,dim,depth,compression);
       return padded;
     }
     return padded;
@@ -425,11 +427,12 @@ public:
   template<class vobj>
   void Face_exchange(const Lattice<vobj> &from,
 		     Lattice<vobj> &to,
-		     int dimension,int depth) const
+		     int dimension,int depth,int compression=HaloCompressionNone) const
   {
     typedef typename vobj::vector_type vector_type;
     typedef typename vobj::scalar_type scalar_type;
     typedef typename vobj::scalar_object sobj;
+    typedef typename RealPart<scalar_type>::type real;
 
     RealD t_gather=0.0;
     RealD t_scatter=0.0;
@@ -473,6 +476,49 @@ public:
     int words = buffer_size;
     int bytes = words * sizeof(vobj);
 
+    ////////////////////////////////////////////////////////////////////////////
+    // Optional lossy face compression; planes are packed into staging buffers
+    ////////////////////////////////////////////////////////////////////////////
+    if ( !std::is_floating_point<real>::value ) compression = HaloCompressionNone;
+#ifdef ACCELERATOR_CSHIFT
+    const int on_device = 1;
+#else
+    const int on_device = 0;
+#endif
+    static cshiftVector<char> send_comp;
+    static cshiftVector<char> recv_comp;
+    uint64_t cbytes  = HaloCompressor::CompressedBytes<real>(compression,bytes);
+    uint64_t cstride = HaloCompressor::Align(cbytes);
+    if ( compression != HaloCompressionNone ) {
+      if ( send_comp.size() < cstride*2*depth ) { cshiftVector<char> tmp(cstride*2*depth); send_comp.swap(tmp); }
+      if ( recv_comp.size() < cstride*2*depth ) { cshiftVector<char> tmp(cstride*2*depth); recv_comp.swap(tmp); }
+    }
+    auto post = [&](std::vector<CommsRequest_t> &req,int p,int to_rank,int from_rank,int tag) {
+      void *xbuf = (void *)&send_buf[p*buffer_size];
+      void *rbuf = (void *)&recv_buf[p*buffer_size];
+      int   nbytes = bytes;
+      if ( compression != HaloCompressionNone ) {
+	void *comp = (void *)&send_comp[p*cstride];
+	HaloCompressor::Compress<real>(compression,xbuf,comp,bytes,on_device);
+	if ( Stencil_halo_compression_check ) {
+	  HaloCompressor::Measure<real>(compression,xbuf,comp,bytes,HaloCompressionCounters,on_device);
+	}
+	HaloCompressionCounters.calls++;
+	HaloCompressionCounters.raw_bytes += bytes;
+	HaloCompressionCounters.wire_bytes+= cbytes;
+	xbuf   = comp;
+	rbuf   = (void *)&recv_comp[p*cstride];
+	nbytes = cbytes;
+      }
+      grid->SendToRecvFromBegin(req,xbuf,to_rank,rbuf,from_rank,nbytes,tag);
+    };
+    auto expand = [&](int p0,int np) {
+      if ( compression == HaloCompressionNone ) return;
+      for(int p=p0;p<p0+np;p++){
+	HaloCompressor::Decompress<real>(compression,(void *)&recv_comp[p*cstride],(void *)&recv_buf[p*buffer_size],bytes,on_device);
+      }
+    };
+
     ////////////////////////////////////////////////////////////////////////////
     // Communication coords
     ////////////////////////////////////////////////////////////////////////////
@@ -495,9 +541,7 @@ public:
       t_gather+=usecond()-t;
 
       t=usecond();
-      grid->SendToRecvFromBegin(fwd_req,
-				(void *)&send_buf[d*buffer_size], xmit_to_rank,
-				(void *)&recv_buf[d*buffer_size], recv_from_rank, bytes, tag);
+      post(fwd_req,d,xmit_to_rank,recv_from_rank,tag);
       t_comms+=usecond()-t;
      }
     for ( int d=0;d < depth ; d ++ ) {
@@ -508,9 +552,7 @@ public:
       t_gather+= usecond() - t;
 
       t=usecond();
-      grid->SendToRecvFromBegin(bwd_req,
-				(void *)&send_buf[(d+depth)*buffer_size], recv_from_rank,
-				(void *)&recv_buf[(d+depth)*buffer_size], xmit_to_rank, bytes,tag);
+      post(bwd_req,d+depth,recv_from_rank,xmit_to_rank,tag);
       t_comms+=usecond()-t;
     }
 
@@ -533,6 +575,7 @@ public:
 
     t=usecond();
     grid->CommsComplete(fwd_req);
+    expand(0,depth);
     t_comms+= usecond() - t;
 
     t=usecond();
@@ -543,6 +586,7 @@ public:
 
     t=usecond();
     grid->CommsComplete(bwd_req);
+    expand(depth,depth);
     t_comms+= usecond() - t;
     
     t=usecond();
@@ -40,6 +40,7 @@
 
 #include <arpa/inet.h>
 #include <algorithm>
+#include <future>
 
 NAMESPACE_BEGIN(Grid);
 
@@ -81,12 +82,17 @@ class BinaryIO {
  public:
   struct IoPerf
   {
+    // Wall clock of the pipelined call; the stages overlapping the transfer
+    // are timed separately below, so time - waitTime is the exposed work
     uint64_t size{0},time{0};
     double   mbytesPerSecond{0.};
+    // Stage breakdown of the same call, microseconds
+    uint64_t chunks{0},waitTime{0},convertTime{0},mungeTime{0},reduceTime{0};
   };
 
   static IoPerf lastPerf;
   static int latticeWriteMaxRetry;
+  static uint64_t chunkBytes; // pipeline granularity, --io-chunk; 0 for one chunk
 
   /////////////////////////////////////////////////////////////////////////////
   // more byte manipulation helpers
@@ -248,6 +254,94 @@ class BinaryIO {
       fp[i] = Grid_ntohll(g);
     });
   }
+  /////////////////////////////////////////////////////////////////////////////
+  // Fused single pass over a chunk of sites: byte order conversion plus both
+  // checksums. The SciDAC crc is always taken over the file byte order and the
+  // NERSC sum over host order, so reads and writes visit them in opposite order.
+  // Every conversion is its own inverse, so one routine serves both directions.
+  /////////////////////////////////////////////////////////////////////////////
+  static const int BINARYIO_IEEE32BIG = 0;
+  static const int BINARYIO_IEEE32    = 1;
+  static const int BINARYIO_IEEE64BIG = 2;
+  static const int BINARYIO_IEEE64    = 3;
+
+  static inline void ConvertWords(void *site,uint64_t bytes,int fmt)
+  {
+    if ( fmt==BINARYIO_IEEE32BIG || fmt==BINARYIO_IEEE32 ) {
+      uint32_t *f = (uint32_t *)site;
+      for(uint64_t w=0;w<bytes/sizeof(uint32_t);w++){
+	if ( fmt==BINARYIO_IEEE32BIG ) f[w] = ntohl(f[w]);
+	else                           f[w] = ntohl(byte_reverse32(f[w]));
+      }
+    } else {
+      uint64_t *f = (uint64_t *)site;
+      for(uint64_t w=0;w<bytes/sizeof(uint64_t);w++){
+	if ( fmt==BINARYIO_IEEE64BIG ) f[w] = Grid_ntohll(f[w]);
+	else                           f[w] = Grid_ntohll(byte_reverse64(f[w]));
+      }
+    }
+  }
+
+  template<class fobj>
+  static inline void ChecksumConvert(GridBase *grid,std::vector<fobj> &fbuf,uint64_t site0,uint64_t nsite,
+				     int fmt,int reading,
+				     uint32_t &nersc_csum,uint32_t &scidac_csuma,uint32_t &scidac_csumb)
+  {
+    const uint64_t size32 = sizeof(fobj) / sizeof(uint32_t);
+    int nd = grid->_ndimension;
+
+    Coordinate local_vol   =grid->LocalDimensions();
+    Coordinate local_start =grid->LocalStarts();
+    Coordinate global_vol  =grid->FullDimensions();
+
+    thread_region
+    {
+      Coordinate coor(nd);
+      uint32_t nersc_csum_thr=0;
+      uint32_t scidac_csuma_thr=0;
+      uint32_t scidac_csumb_thr=0;
+
+      thread_for_in_region( s, nsite,
+      {
+	uint64_t local_site = site0+s;
+	uint32_t * site_buf = (uint32_t *)&fbuf[local_site];
+
+	int64_t global_site;
+	Lexicographic::CoorFromIndex(coor,local_site,local_vol);
+	for(int d=0;d<nd;d++) {
+	  coor[d] = coor[d]+local_start[d];
+	}
+	Lexicographic::IndexFromCoor(coor,global_site,global_vol);
+	uint64_t gsite29   = global_site%29;
+	uint64_t gsite31   = global_site%31;
+	uint32_t site_crc;
+
+	if ( reading ) {
+	  site_crc = crc32(0,(unsigned char *)site_buf,sizeof(fobj));
+	} else {
+	  for (uint64_t j = 0; j < size32; j++) nersc_csum_thr = nersc_csum_thr + site_buf[j];
+	}
+
+	ConvertWords((void *)site_buf,sizeof(fobj),fmt);
+
+	if ( reading ) {
+	  for (uint64_t j = 0; j < size32; j++) nersc_csum_thr = nersc_csum_thr + site_buf[j];
+	} else {
+	  site_crc = crc32(0,(unsigned char *)site_buf,sizeof(fobj));
+	}
+	scidac_csuma_thr ^= site_crc<<gsite29 | site_crc>>(32-gsite29);
+	scidac_csumb_thr ^= site_crc<<gsite31 | site_crc>>(32-gsite31);
+      });
+
+      thread_critical
+      {
+	nersc_csum  += nersc_csum_thr;
+	scidac_csuma^= scidac_csuma_thr;
+	scidac_csumb^= scidac_csumb_thr;
+      }
+    }
+  }
+
   /////////////////////////////////////////////////////////////////////////////
   // Real action:
   // Read or Write distributed lexico array of ANY object to a specific location in file 
@@ -269,10 +363,34 @@ class BinaryIO {
 			      uint32_t &nersc_csum,
 			      uint32_t &scidac_csuma,
 			      uint32_t &scidac_csumb)
+  {
+    IOobject(w,grid,iodata,file,offset,format,control,
+	     nersc_csum,scidac_csuma,scidac_csumb,
+	     [](uint64_t site0,uint64_t nsite) {});
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  // chunk_munge(site0,nsite) runs on each chunk of sites in the pipeline:
+  // after the byte swap on reading, before it on writing
+  //////////////////////////////////////////////////////////////////////////////
+  template<class word,class fobj,class chunkop>
+  static inline void IOobject(word w,
+			      GridBase *grid,
+			      std::vector<fobj> &iodata,
+			      std::string file,
+			      uint64_t& offset,
+			      const std::string &format, int control,
+			      uint32_t &nersc_csum,
+			      uint32_t &scidac_csuma,
+			      uint32_t &scidac_csumb,
+			      chunkop chunk_munge)
   {
     grid->Barrier();
     GridStopWatch timer; 
     GridStopWatch bstimer;
+    GridStopWatch mungetimer;
+    GridStopWatch waittimer;
+    GridStopWatch reducetimer;
     
     nersc_csum=0;
     scidac_csuma=0;
@@ -307,11 +425,11 @@ class BinaryIO {
     std::vector<int> dargs   (ndim,MPI_DISTRIBUTE_DFLT_DARG);
     MPI_Datatype mpiObject;
     MPI_Datatype fileArray;
-    MPI_Datatype localArray;
     MPI_Datatype mpiword;
     MPI_Offset disp = offset;
     MPI_File fh ;
     MPI_Status status;
+    MPI_Request request;
     int numword;
 
     if ( sizeof( word ) == sizeof(float ) ) {
@@ -335,11 +453,6 @@ class BinaryIO {
     ierr=MPI_Type_create_subarray(ndim,&gLattice[0],&lLattice[0],&gStart[0],MPI_ORDER_FORTRAN, mpiObject,&fileArray);    assert(ierr==0);
     ierr=MPI_Type_commit(&fileArray);    assert(ierr==0);
 
-    //////////////////////////////////////////////////////////////////////////////
-    // local lattice array
-    //////////////////////////////////////////////////////////////////////////////
-    ierr=MPI_Type_create_subarray(ndim,&lLattice[0],&lLattice[0],&lStart[0],MPI_ORDER_FORTRAN, mpiObject,&localArray);    assert(ierr==0);
-    ierr=MPI_Type_commit(&localArray);    assert(ierr==0);
 #endif
 
     //////////////////////////////////////////////////////////////////////////////
@@ -351,75 +464,106 @@ class BinaryIO {
     int ieee64    = (format == std::string("IEEE64") || format == std::string("IEEE64LITTLE"));
     assert(ieee64||ieee32|ieee64big||ieee32big);
     assert((ieee64+ieee32+ieee64big+ieee32big)==1);
+    int fmt = BINARYIO_IEEE64;
+    if (ieee32big) fmt = BINARYIO_IEEE32BIG;
+    if (ieee32)    fmt = BINARYIO_IEEE32;
+    if (ieee64big) fmt = BINARYIO_IEEE64BIG;
+
     //////////////////////////////////////////////////////////////////////////////
-    // Do the I/O
+    // Chunked pipeline: the transfer of one chunk is in flight while the next
+    // (read) or previous (write) chunk is munged, converted and checksummed. Chunks are
+    // disjoint ranges of iodata, so they double buffer each other in place.
+    // Every rank has the same number of sites, hence the same collective calls.
     //////////////////////////////////////////////////////////////////////////////
-    if ( control & BINARYIO_READ ) { 
-
-      timer.Start();
+    int reading = (control & BINARYIO_READ) ? 1 : 0;
+    int use_mpi = (control & BINARYIO_LEXICOGRAPHIC) && (nrank > 1);
+    uint64_t nsites = iodata.size();
+    uint64_t chunk  = nsites;
+    if ( chunkBytes ) chunk = std::min(nsites,std::max((uint64_t)1,chunkBytes/sizeof(fobj)));
+    int nchunk = (nsites+chunk-1)/chunk;
+
+    auto chunk_sites = [&](int c) { return std::min(chunk,nsites-c*chunk); };
+
+    std::ifstream fin;
+    std::ofstream fout;
+    uint64_t base = 0;
+    std::future<void> pending;
+
+    auto io_error = [&](const std::string &what,const std::exception &exc) {
+      std::cout << GridLogError << "IOobject: " << what << " " << file << std::endl;
+      std::cout << GridLogError << "Exception description: " << exc.what() << std::endl;
+#ifdef USE_MPI_IO
+      MPI_Abort(MPI_COMM_WORLD,1);
+#else
+      exit(1);
+#endif
+    };
 
-      if ( (control & BINARYIO_LEXICOGRAPHIC) && (nrank > 1) ) {
+    auto issue = [&](int c) {
+      char   *buf   = (char *)&iodata[c*chunk];
+      uint64_t n    = chunk_sites(c);
+      if ( use_mpi ) {
 #ifdef USE_MPI_IO
-	std::cout<< GridLogMessage<<"IOobject: MPI read I/O "<< file<< std::endl;
-	ierr=MPI_File_open(grid->communicator,(char *) file.c_str(), MPI_MODE_RDONLY, MPI_INFO_NULL, &fh);    assert(ierr==0);
-	ierr=MPI_File_set_view(fh, disp, mpiObject, fileArray, "native", MPI_INFO_NULL);    assert(ierr==0);
-	ierr=MPI_File_read_all(fh, &iodata[0], 1, localArray, &status);    assert(ierr==0);
-	MPI_File_close(&fh);
-	MPI_Type_free(&fileArray);
-	MPI_Type_free(&localArray);
-#else 
-	assert(0);
+	// The view makes this rank's sites contiguous in etype units, in local lexicographic order
+	if ( reading ) ierr = MPI_File_iread_at_all (fh,(MPI_Offset)(c*chunk),buf,n,mpiObject,&request);
+	else           ierr = MPI_File_iwrite_at_all(fh,(MPI_Offset)(c*chunk),buf,n,mpiObject,&request);
+	assert(ierr==0);
 #endif
       } else {
-	std::cout << GridLogMessage <<"IOobject: C++ read I/O " << file << " : "
-                  << iodata.size() * sizeof(fobj) << " bytes and offset " << offset << std::endl;
-        std::ifstream fin;
-	fin.open(file, std::ios::binary | std::ios::in);
-        if (control & BINARYIO_MASTER_APPEND)
-        {
-          fin.seekg(-sizeof(fobj), fin.end);
-        }
-        else
-        {
-          fin.seekg(offset + myrank * lsites * sizeof(fobj));
-        }
-        fin.read((char *)&iodata[0], iodata.size() * sizeof(fobj));
-        assert(fin.fail() == 0);
-        fin.close();
+	uint64_t pos = base + c*chunk*sizeof(fobj);
+	pending = std::async(std::launch::async,[&fin,&fout,reading,buf,n,pos]() {
+	  if ( reading ) {
+	    fin.seekg(pos);
+	    fin.read(buf,n*sizeof(fobj));
+	    assert(fin.fail() == 0);
+	  } else {
+	    fout.seekp(pos);
+	    fout.write(buf,n*sizeof(fobj));
+	  }
+	});
       }
-      timer.Stop();
+    };
 
-      grid->Barrier();
-
-      bstimer.Start();
-      ScidacChecksum(grid,iodata,scidac_csuma,scidac_csumb);
-      if (ieee32big) be32toh_v((void *)&iodata[0], sizeof(fobj)*iodata.size());
-      if (ieee32)    le32toh_v((void *)&iodata[0], sizeof(fobj)*iodata.size());
-      if (ieee64big) be64toh_v((void *)&iodata[0], sizeof(fobj)*iodata.size());
-      if (ieee64)    le64toh_v((void *)&iodata[0], sizeof(fobj)*iodata.size());
-      NerscChecksum(grid,iodata,nersc_csum);
-      bstimer.Stop();
-    }
-    
-    if ( control & BINARYIO_WRITE ) { 
+    auto complete = [&](int c) {
+      waittimer.Start();
+      if ( use_mpi ) {
+#ifdef USE_MPI_IO
+	MPI_Wait(&request,&status);
+#endif
+      } else {
+	try {
+	  pending.get();
+	} catch (const std::fstream::failure& exc) {
+	  io_error(reading ? "Exception in reading file" : "Exception in writing file",exc);
+	}
+      }
+      waittimer.Stop();
+    };
 
+    auto convert = [&](int c) {
       bstimer.Start();
-      NerscChecksum(grid,iodata,nersc_csum);
-      if (ieee32big) htobe32_v((void *)&iodata[0], sizeof(fobj)*iodata.size());
-      if (ieee32)    htole32_v((void *)&iodata[0], sizeof(fobj)*iodata.size());
-      if (ieee64big) htobe64_v((void *)&iodata[0], sizeof(fobj)*iodata.size());
-      if (ieee64)    htole64_v((void *)&iodata[0], sizeof(fobj)*iodata.size());
-      ScidacChecksum(grid,iodata,scidac_csuma,scidac_csumb);
+      ChecksumConvert(grid,iodata,c*chunk,chunk_sites(c),fmt,reading,nersc_csum,scidac_csuma,scidac_csumb);
       bstimer.Stop();
+    };
 
-      grid->Barrier();
+    auto munge = [&](int c) {
+      mungetimer.Start();
+      chunk_munge(c*chunk,chunk_sites(c));
+      mungetimer.Stop();
+    };
 
-      timer.Start();
-      if ( (control & BINARYIO_LEXICOGRAPHIC) && (nrank > 1) ) {
+    //////////////////////////////////////////////////////////////////////////////
+    // Open
+    //////////////////////////////////////////////////////////////////////////////
+    timer.Start();
+    if ( use_mpi ) {
 #ifdef USE_MPI_IO
+      if ( reading ) {
+	std::cout<< GridLogMessage<<"IOobject: MPI read I/O "<< file<< std::endl;
+	ierr=MPI_File_open(grid->communicator,(char *) file.c_str(), MPI_MODE_RDONLY, MPI_INFO_NULL, &fh);    assert(ierr==0);
+      } else {
         std::cout << GridLogMessage <<"IOobject: MPI write I/O " << file << std::endl;
         ierr = MPI_File_open(grid->communicator, (char *)file.c_str(), MPI_MODE_RDWR | MPI_MODE_CREATE, MPI_INFO_NULL, &fh);
-	//        std::cout << GridLogMessage << "Checking for errors" << std::endl;
         if (ierr != MPI_SUCCESS)
         {
           char error_string[BUFSIZ];
@@ -432,106 +576,123 @@ class BinaryIO {
           fprintf(stderr, "%3d: %s\n", myrank, error_string);
           MPI_Abort(MPI_COMM_WORLD, 1); //assert(ierr == 0);
         }
-
-        std::cout << GridLogDebug << "MPI write I/O set view " << file << std::endl;
-        ierr = MPI_File_set_view(fh, disp, mpiObject, fileArray, "native", MPI_INFO_NULL);
-        assert(ierr == 0);
-
-        std::cout << GridLogDebug << "MPI write I/O write all " << file << std::endl;
-        ierr = MPI_File_write_all(fh, &iodata[0], 1, localArray, &status);
-        assert(ierr == 0);
-
-        MPI_Offset os;
-        MPI_File_get_position(fh, &os);
-        MPI_File_get_byte_offset(fh, os, &disp);
-        offset = disp;
-
-
-        MPI_File_close(&fh);
-        MPI_Type_free(&fileArray);
-        MPI_Type_free(&localArray);
-#else 
-	assert(0);
-#endif
-      } else { 
-
-        std::cout << GridLogMessage << "IOobject: C++ write I/O " << file << " : "
-                  << iodata.size() * sizeof(fobj) << " bytes and offset " << offset << std::endl;
-        
-	std::ofstream fout; 
-	fout.exceptions ( std::fstream::failbit | std::fstream::badbit );
-	try {
-	  if (offset) { // Must already exist and contain data
-	    fout.open(file,std::ios::binary|std::ios::out|std::ios::in);
-	  } else {     // Allow create
-	    fout.open(file,std::ios::binary|std::ios::out);
-	  }
-	} catch (const std::fstream::failure& exc) {
-	  std::cout << GridLogError << "Error in opening the file " << file << " for output" <<std::endl;
-	  std::cout << GridLogError << "Exception description: " << exc.what() << std::endl;
-	  //	  std::cout << GridLogError << "Probable cause: wrong path, inaccessible location "<< std::endl;
-#ifdef USE_MPI_IO
-	  MPI_Abort(MPI_COMM_WORLD,1);
+      }
+      std::cout << GridLogDebug << "MPI I/O set view " << file << std::endl;
+      ierr=MPI_File_set_view(fh, disp, mpiObject, fileArray, "native", MPI_INFO_NULL);    assert(ierr==0);
 #else
-	  exit(1);
+      assert(0);
 #endif
+    } else if ( reading ) {
+      std::cout << GridLogMessage <<"IOobject: C++ read I/O " << file << " : "
+		<< iodata.size() * sizeof(fobj) << " bytes and offset " << offset << std::endl;
+      fin.exceptions ( std::fstream::failbit | std::fstream::badbit );
+      try {
+	fin.open(file, std::ios::binary | std::ios::in);
+	if (control & BINARYIO_MASTER_APPEND) {
+	  fin.seekg(-sizeof(fobj), fin.end);
+	  base = fin.tellg();
+	} else {
+	  base = offset + myrank * lsites * sizeof(fobj);
+	}
+      } catch (const std::fstream::failure& exc) {
+	io_error("Error in opening the file for input",exc);
+      }
+    } else {
+      std::cout << GridLogMessage << "IOobject: C++ write I/O " << file << " : "
+		<< iodata.size() * sizeof(fobj) << " bytes and offset " << offset << std::endl;
+      fout.exceptions ( std::fstream::failbit | std::fstream::badbit );
+      try {
+	if (offset) { // Must already exist and contain data
+	  fout.open(file,std::ios::binary|std::ios::out|std::ios::in);
+	} else {     // Allow create
+	  fout.open(file,std::ios::binary|std::ios::out);
 	}
-	
 	if ( control & BINARYIO_MASTER_APPEND )  {
-	  try {
-	    fout.seekp(0,fout.end);
-	  } catch (const std::fstream::failure& exc) {
-	    std::cout << "Exception in seeking file end " << file << std::endl;
-	  }
+	  fout.seekp(0,fout.end);
+	  base = fout.tellp();
 	} else {
-	  try { 
-	    fout.seekp(offset+myrank*lsites*sizeof(fobj));
-	  } catch (const std::fstream::failure& exc) {
-	    std::cout << "Exception in seeking file " << file <<" offset "<< offset << std::endl;
-	  }
+	  base = offset+myrank*lsites*sizeof(fobj);
 	}
+      } catch (const std::fstream::failure& exc) {
+	io_error("Error in opening the file for output",exc);
+      }
+    }
 
-	try {
-	  fout.write((char *)&iodata[0],iodata.size()*sizeof(fobj));//assert( fout.fail()==0);
+    //////////////////////////////////////////////////////////////////////////////
+    // Do the I/O
+    //////////////////////////////////////////////////////////////////////////////
+    if ( reading ) {
+      issue(0);
+      for(int c=0;c<nchunk;c++){
+	complete(c);
+	if ( c+1<nchunk ) issue(c+1);
+	convert(c);
+	munge(c);
+      }
+    } else {
+      munge(0);
+      convert(0);
+      for(int c=0;c<nchunk;c++){
+	issue(c);
+	if ( c+1<nchunk ) {
+	  munge(c+1);
+	  convert(c+1);
 	}
-	catch (const std::fstream::failure& exc) {
-	  std::cout << "Exception in writing file " << file << std::endl;
-	  std::cout << GridLogError << "Exception description: "<< exc.what() << std::endl;
+	complete(c);
+      }
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    // Close
+    //////////////////////////////////////////////////////////////////////////////
+    if ( use_mpi ) {
 #ifdef USE_MPI_IO
-	  MPI_Abort(MPI_COMM_WORLD,1);
-#else
-	  exit(1);
-#endif
-	}
-  offset  = fout.tellp();
-	fout.close();
+      if ( !reading ) {
+	MPI_File_get_byte_offset(fh, (MPI_Offset)nsites, &disp);
+	offset = disp;
       }
-      timer.Stop();
+      MPI_File_close(&fh);
+      MPI_Type_free(&fileArray);
+#endif
+    } else if ( reading ) {
+      fin.close();
+    } else {
+      offset = fout.tellp();
+      fout.close();
     }
-    
+    timer.Stop();
+
     lastPerf.size            = sizeof(fobj)*iodata.size()*nrank;
     lastPerf.time            = timer.useconds();
     lastPerf.mbytesPerSecond = lastPerf.size/1024./1024./(lastPerf.time/1.0e6);
+    lastPerf.chunks          = nchunk;
+    lastPerf.waitTime        = waittimer.useconds();
+    lastPerf.convertTime     = bstimer.useconds();
+    lastPerf.mungeTime       = mungetimer.useconds();
     std::cout<<GridLogMessage<<"IOobject: ";
     if ( control & BINARYIO_READ) std::cout << " read  ";
     else                          std::cout << " write ";
-    uint64_t bytes = sizeof(fobj)*iodata.size()*nrank;
     std::cout<< lastPerf.size <<" bytes in "<< timer.Elapsed() <<" "
 	     << lastPerf.mbytesPerSecond <<" MB/s "<<std::endl;
 
-    std::cout<<GridLogMessage<<"IOobject: endian and checksum overhead "<<bstimer.Elapsed()  <<std::endl;
+    std::cout<<GridLogMessage<<"IOobject: "<<nchunk<<" chunks; munge "<<mungetimer.Elapsed()
+	     <<" endian and checksum "<<bstimer.Elapsed()
+	     <<" waiting on I/O "<<waittimer.Elapsed()<<std::endl;
 
     //////////////////////////////////////////////////////////////////////////////
     // Safety check
     //////////////////////////////////////////////////////////////////////////////
     // if the data size is 1 we do not want to sum over the MPI ranks
     if (iodata.size() != 1){
+      reducetimer.Start();
       grid->Barrier();
       grid->GlobalSum(nersc_csum);
       grid->GlobalXOR(scidac_csuma);
       grid->GlobalXOR(scidac_csumb);
       grid->Barrier();
+      reducetimer.Stop();
     }
+    lastPerf.reduceTime = reducetimer.useconds();
   }
 
   /////////////////////////////////////////////////////////////////////////////
@@ -558,14 +719,17 @@ class BinaryIO {
     std::vector<sobj> scalardata(lsites); 
     std::vector<fobj>     iodata(lsites); // Munge, checksum, byte order in here
     
+    // Munge each chunk as soon as it is byte swapped
     IOobject(w,grid,iodata,file,offset,format,BINARYIO_READ|control,
-	     nersc_csum,scidac_csuma,scidac_csumb);
+	     nersc_csum,scidac_csuma,scidac_csumb,
+	     [&](uint64_t site0,uint64_t nsite) {
+	       thread_for(x,nsite, { munge(iodata[site0+x], scalardata[site0+x]); });
+	     });
 
+    // Vectorizing scatters over the whole local volume, so stays a separate pass
     GridStopWatch timer; 
     timer.Start();
 
-    thread_for(x,lsites, { munge(iodata[x], scalardata[x]); });
-
     vectorizeFromLexOrdArray(scalardata,Umu);    
     grid->Barrier();
 
@@ -597,21 +761,24 @@ class BinaryIO {
     std::vector<sobj> scalardata(lsites); 
     std::vector<fobj>     iodata(lsites); // Munge, checksum, byte order in here
 
-    //////////////////////////////////////////////////////////////////////////////
-    // Munge [ .e.g 3rd row recon ]
-    //////////////////////////////////////////////////////////////////////////////
     GridStopWatch timer; timer.Start();
     unvectorizeToLexOrdArray(scalardata,Umu);    
-
-    thread_for(x, lsites, { munge(scalardata[x],iodata[x]); });
-
     grid->Barrier();
     timer.Stop();
+    std::cout<<GridLogMessage<<"writeLatticeObject: unvectorize overhead "<<timer.Elapsed()  <<std::endl;
+
+    //////////////////////////////////////////////////////////////////////////////
+    // Munge [ .e.g 3rd row recon ] each chunk ahead of its byte swap; a retry
+    // munges again from scalardata
+    //////////////////////////////////////////////////////////////////////////////
+    auto chunk_munge = [&](uint64_t site0,uint64_t nsite) {
+      thread_for(x,nsite, { munge(scalardata[site0+x],iodata[site0+x]); });
+    };
     while (attemptsLeft >= 0)
     {
       grid->Barrier();
       IOobject(w,grid,iodata,file,offset,format,BINARYIO_WRITE|control,
-	             nersc_csum,scidac_csuma,scidac_csumb);
+	             nersc_csum,scidac_csuma,scidac_csumb,chunk_munge);
       if (checkWrite)
       {
         std::vector<fobj> ckiodata(lsites);
@@ -626,7 +793,6 @@ class BinaryIO {
         {
           std::cout << GridLogMessage << "writeLatticeObject: read test checksum failure, re-writing (" << attemptsLeft << " attempt(s) remaining)" << std::endl;
           offset = offsetCopy;
-          thread_for(x,lsites, { munge(scalardata[x],iodata[x]); });
         }
         else
         {
@@ -636,9 +802,6 @@ class BinaryIO {
       }
       attemptsLeft--;
     }
-    
-
-    std::cout<<GridLogMessage<<"writeLatticeObject: unvectorize overhead "<<timer.Elapsed()  <<std::endl;
   }
   
   /////////////////////////////////////////////////////////////////////////////
@@ -676,16 +839,23 @@ class BinaryIO {
 	     nersc_csum,scidac_csuma,scidac_csumb);
 
     timer.Start();
-    thread_for(lidx,lsites,{  // FIX ME, suboptimal implementation
-      std::vector<RngStateType> tmp(RngStateCount);
-      std::copy(iodata[lidx].begin(),iodata[lidx].end(),tmp.begin());
-      Coordinate lcoor;
-      grid->LocalIndexToLocalCoor(lidx, lcoor);
-      int o_idx=grid->oIndex(lcoor);
-      int i_idx=grid->iIndex(lcoor);
-      int gidx=parallel_rng.generator_idx(o_idx,i_idx);
-      parallel_rng.SetState(tmp,gidx);
+    // A counter based generator is restored from its tagged record alone
+    std::vector<RngStateType> rec(iodata[0].begin(),iodata[0].end());
+    if ( parallel_rng.SetCounterRecord(rec) ) {
+      std::cout << GridLogMessage << "RNG file holds the counter based state" << std::endl;
+    } else {
+      parallel_rng.SiteGenerators();
+      thread_for(lidx,lsites,{  // FIX ME, suboptimal implementation
+	std::vector<RngStateType> tmp(RngStateCount);
+	std::copy(iodata[lidx].begin(),iodata[lidx].end(),tmp.begin());
+	Coordinate lcoor;
+	grid->LocalIndexToLocalCoor(lidx, lcoor);
+	int o_idx=grid->oIndex(lcoor);
+	int i_idx=grid->iIndex(lcoor);
+	int gidx=parallel_rng.generator_idx(o_idx,i_idx);
+	parallel_rng.SetState(tmp,gidx);
       });
+    }
     timer.Stop();
 
     iodata.resize(1);
@@ -739,16 +909,25 @@ class BinaryIO {
 
     timer.Start();
     std::vector<RNGstate> iodata(lsites);
-    thread_for(lidx,lsites,{
-      std::vector<RngStateType> tmp(RngStateCount);
-      Coordinate lcoor;
-      grid->LocalIndexToLocalCoor(lidx, lcoor);
-      int o_idx=grid->oIndex(lcoor);
-      int i_idx=grid->iIndex(lcoor);
-      int gidx=parallel_rng.generator_idx(o_idx,i_idx);
-      parallel_rng.GetState(tmp,gidx);
-      std::copy(tmp.begin(),tmp.end(),iodata[lidx].begin());
-    });
+    if ( parallel_rng.CounterBased() ) {
+      // Counter state in every site record, see GridParallelRNG::GetCounterRecord
+      std::vector<RngStateType> rec;
+      parallel_rng.GetCounterRecord(rec);
+      thread_for(lidx,lsites,{
+	std::copy(rec.begin(),rec.end(),iodata[lidx].begin());
+      });
+    } else {
+      thread_for(lidx,lsites,{
+	std::vector<RngStateType> tmp(RngStateCount);
+	Coordinate lcoor;
+	grid->LocalIndexToLocalCoor(lidx, lcoor);
+	int o_idx=grid->oIndex(lcoor);
+	int i_idx=grid->iIndex(lcoor);
+	int gidx=parallel_rng.generator_idx(o_idx,i_idx);
+	parallel_rng.GetState(tmp,gidx);
+	std::copy(tmp.begin(),tmp.end(),iodata[lidx].begin());
+      });
+    }
     timer.Stop();
 
     IOobject(w,grid,iodata,file,offset,format,BINARYIO_WRITE|BINARYIO_LEXICOGRAPHIC,
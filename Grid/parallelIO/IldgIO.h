@@ -632,6 +632,16 @@ class IldgWriter : public ScidacWriter {
   ////////////////////////////////////////////////////////////////
   template <class stats = PeriodicGaugeStatistics>
   void writeConfiguration(Lattice<vLorentzColourMatrixD > &Umu,int sequence,std::string LFN,std::string description) 
+  {
+    FieldMetaData header;
+    stats Stats;
+    Stats(Umu,header);
+    writeConfiguration(Umu,header,sequence,LFN,description);
+  }
+  ////////////////////////////////////////////////////////////////
+  // Header with the plaquette and link trace already filled in
+  ////////////////////////////////////////////////////////////////
+  void writeConfiguration(Lattice<vLorentzColourMatrixD > &Umu,FieldMetaData header,int sequence,std::string LFN,std::string description) 
   {
     GridBase * grid = Umu.Grid();
     typedef Lattice<vLorentzColourMatrixD> GaugeField;
@@ -641,15 +651,11 @@ class IldgWriter : public ScidacWriter {
     ////////////////////////////////////////
     // fill the Grid header
     ////////////////////////////////////////
-    FieldMetaData header;
     scidacRecord  _scidacRecord;
     scidacFile    _scidacFile;
 
     ScidacMetaData(Umu,header,_scidacRecord,_scidacFile);
 
-    stats Stats;
-    Stats(Umu,header);
-    
     std::string format = header.floating_point;
     header.ensemble_id    = description;
     header.ensemble_label = description;
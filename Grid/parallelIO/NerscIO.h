@@ -230,11 +230,25 @@ public:
 					std::string ens_label = std::string("DWF"),
 					std::string ens_id = std::string("UKQCD"),
 					unsigned int sequence_number = 1)
+  {
+    FieldMetaData header;
+    GaugeStats Stats; Stats(Umu,header);
+    writeConfiguration(Umu,header,file,two_row,bits32,ens_label,ens_id,sequence_number);
+  }
+  // Header with the plaquette and link trace already filled in; no
+  // communication beyond the write itself
+  static inline void writeConfiguration(Lattice<vLorentzColourMatrixD > &Umu,
+					FieldMetaData header,
+					std::string file, 
+					int two_row,
+					int bits32,
+					std::string ens_label = std::string("DWF"),
+					std::string ens_id = std::string("UKQCD"),
+					unsigned int sequence_number = 1)
   {
     typedef vLorentzColourMatrixD vobj;
     typedef typename vobj::scalar_object sobj;
 
-    FieldMetaData header;
     header.sequence_number = sequence_number;
     header.ensemble_id     = ens_id;
     header.ensemble_label  = ens_label;
@@ -247,7 +261,6 @@ public:
 
     GridMetaData(grid,header);
     assert(header.nd==4);
-    GaugeStats Stats; Stats(Umu,header);
     MachineCharacteristics(header);
 
     uint64_t offset;
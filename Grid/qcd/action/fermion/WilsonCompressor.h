@@ -247,6 +247,10 @@ class WilsonCompressorTemplate  : public FaceGatherDWFMixedBCs
 {
 public:
   
+  // Face compression assumes the wire carries SiteHalfSpinor reals;
+  // reduced precision comms already change that
+  static constexpr bool FaceCompression = std::is_same<_HCspinor,_Hspinor>::value;
+
   int mu,dag;  
 
   void Point(int p) { mu=p; };
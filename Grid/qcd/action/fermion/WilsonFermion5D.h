@@ -78,6 +78,15 @@ public:
   int Dirichlet;
   Coordinate Block; 
 
+  ///////////////////////////////////////////////////////////////
+  // Kernel plan; populated by Autotune under --dslash-autotune
+  ///////////////////////////////////////////////////////////////
+  WilsonKernelsPlan Plan;
+  int KernelOpt(void)   { return (Plan.Opt  >=0) ? Plan.Opt   : WilsonKernelsStatic::Opt;   }
+  int KernelComms(void) { return (Plan.Comms>=0) ? Plan.Comms : WilsonKernelsStatic::Comms; }
+  void ApplyPlan(const WilsonKernelsPlan &plan);
+  void Autotune(void);
+
   ///////////////////////////////////////////////////////////////
   // Implement the abstract base
   ///////////////////////////////////////////////////////////////
@@ -123,6 +132,21 @@ public:
   void DhopDirAll(const FermionField &in,std::vector<FermionField> &out);
   void DhopDirComms(const FermionField &in);
   void DhopDirCalc(const FermionField &in, FermionField &out,int point);
+
+  ///////////////////////////////////////////////////////////////
+  // Multiple right hand sides, stacked in the s-direction on an
+  // (nrhs*Ls) five-d grid. Each gauge link read and one halo
+  // exchange then serve every source. Stacked fields live on
+  // MRHSGrid / MRHSRedBlackGrid.
+  ///////////////////////////////////////////////////////////////
+  GridCartesian         *MRHSGrid(int nrhs);
+  GridRedBlackCartesian *MRHSRedBlackGrid(int nrhs);
+  void ImportMRHS(const std::vector<FermionField> &in, FermionField &stacked);
+  void ExportMRHS(const FermionField &stacked, std::vector<FermionField> &out);
+  void DhopMRHS  (const FermionField &in, FermionField &out,int dag);
+  void DhopOEMRHS(const FermionField &in, FermionField &out,int dag);
+  void DhopEOMRHS(const FermionField &in, FermionField &out,int dag);
+  void DhopMRHS  (const std::vector<FermionField> &in, std::vector<FermionField> &out,int dag);
     
   ///////////////////////////////////////////////////////////////
   // New methods added 
@@ -163,6 +187,8 @@ public:
 		  GridRedBlackCartesian &FourDimRedBlackGrid,
 		  double _M5,const ImplParams &p= ImplParams());
 
+  virtual ~WilsonFermion5D() { MRHSTeardown(); };
+
   virtual void DirichletBlock(const Coordinate & block)
   {
   }
@@ -205,6 +231,16 @@ public:
     
   LebesgueOrder Lebesgue;
   LebesgueOrder LebesgueEvenOdd;
+
+  // Stacked multi-RHS geometry, built on first use for a given nrhs
+  int                    MRHS_nrhs;
+  GridCartesian         *MRHS_FiveDimGrid;
+  GridRedBlackCartesian *MRHS_FiveDimRedBlackGrid;
+  StencilImpl           *MRHS_Stencil;
+  StencilImpl           *MRHS_StencilEven;
+  StencilImpl           *MRHS_StencilOdd;
+  void MRHSSetup(int nrhs);
+  void MRHSTeardown(void);
     
   // Comms buffer
   //  std::vector<SiteHalfSpinor,alignedAllocator<SiteHalfSpinor> >  comm_buf;
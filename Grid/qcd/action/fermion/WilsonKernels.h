@@ -42,8 +42,47 @@ public:
   enum { CommsAndCompute, CommsThenCompute };
   static int Opt;  
   static int Comms;
+  static int Autotune; // --dslash-autotune
 };
- 
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Autotuned kernel plan: kernel variant, comms overlap and Lebesgue blocking for one lattice geometry.
+// Negative Opt/Comms and empty Block defer to the WilsonKernelsStatic / LebesgueOrder defaults.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+class WilsonKernelsPlan : Serializable {
+public:
+  GRID_SERIALIZABLE_CLASS_MEMBERS(WilsonKernelsPlan,
+				  std::string, key,
+				  int, Opt,
+				  int, Comms,
+				  std::vector<int>, Block,
+				  double, usec);
+  WilsonKernelsPlan() : Opt(-1), Comms(-1), usec(0.0) {};
+};
+
+class WilsonKernelsPlanFile : Serializable {
+public:
+  GRID_SERIALIZABLE_CLASS_MEMBERS(WilsonKernelsPlanFile,
+				  std::vector<WilsonKernelsPlan>, plans);
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// On-disk cache of tuned plans, keyed by fermion implementation, local geometry, Ls, precision and SIMD target.
+// Every rank reads the file; only the boss rank writes it.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+class WilsonKernelsPlanCache {
+public:
+  static std::string filename; // --dslash-plan-cache
+  static std::string SimdTarget(void);
+  static std::string Key(const std::string &impl,GridBase *FourDimGrid,int Ls,int precision,int commsprecision,int Nsimd,int Nrep);
+  static bool Lookup(const std::string &key,WilsonKernelsPlan &plan);
+  static void Insert(GridBase *grid,const WilsonKernelsPlan &plan);
+private:
+  static std::vector<WilsonKernelsPlan> plans;
+  static int loaded;
+  static void Load(void);
+};
+
 template<class Impl> class WilsonKernels : public FermionOperator<Impl> , public WilsonKernelsStatic { 
 public:
 
@@ -139,6 +178,28 @@ private:
  public:
  WilsonKernels(const ImplParams &p = ImplParams()) : Base(p){};
 };
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Which implementations have an assembler specialisation; the autotuner must not try OptInlineAsm elsewhere
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<class Impl> struct WilsonKernelsHaveAsm { static const bool value = false; };
+
+#if (defined(AVX512) || defined(A64FX)) && !defined(GRID_CUDA) && !defined(GRID_HIP) && !defined(GRID_SYCL)
+#define WILSON_KERNELS_HAVE_ASM(IMPL) template<> struct WilsonKernelsHaveAsm<IMPL> { static const bool value = true; };
+// As specialised in WilsonKernelsAsmAvx512.h and WilsonKernelsAsmA64FX.h; the
+// half precision comms (FH/DF) variants are commented out there
+WILSON_KERNELS_HAVE_ASM(WilsonImplF);
+WILSON_KERNELS_HAVE_ASM(WilsonImplD);
+WILSON_KERNELS_HAVE_ASM(ZWilsonImplF);
+WILSON_KERNELS_HAVE_ASM(ZWilsonImplD);
+#if defined(AVX512)
+WILSON_KERNELS_HAVE_ASM(DomainWallVec5dImplF);
+WILSON_KERNELS_HAVE_ASM(DomainWallVec5dImplD);
+WILSON_KERNELS_HAVE_ASM(ZDomainWallVec5dImplF);
+WILSON_KERNELS_HAVE_ASM(ZDomainWallVec5dImplD);
+#endif
+#undef WILSON_KERNELS_HAVE_ASM
+#endif
     
 NAMESPACE_END(Grid);
 
@@ -122,6 +122,10 @@ ImprovedStaggeredFermion5D<Impl>::ImprovedStaggeredFermion5D(GridCartesian
   vol4=FourDimRedBlackGrid.oSites();
   StencilEven.BuildSurfaceList(LLs,vol4);
   StencilOdd.BuildSurfaceList(LLs,vol4);
+
+  Stencil.SetHaloCompression(Stencil_halo_compression);
+  StencilEven.SetHaloCompression(Stencil_halo_compression);
+  StencilOdd.SetHaloCompression(Stencil_halo_compression);
 }
 template <class Impl>
 void ImprovedStaggeredFermion5D<Impl>::CopyGaugeCheckerboards(void)
@@ -68,6 +68,10 @@ ImprovedStaggeredFermion<Impl>::ImprovedStaggeredFermion(GridCartesian &Fgrid, G
   vol4= _cbgrid->oSites();
   StencilEven.BuildSurfaceList(LLs,vol4);
   StencilOdd.BuildSurfaceList(LLs,vol4);
+
+  Stencil.SetHaloCompression(Stencil_halo_compression);
+  StencilEven.SetHaloCompression(Stencil_halo_compression);
+  StencilOdd.SetHaloCompression(Stencil_halo_compression);
 }
 
 template <class Impl>
@@ -64,6 +64,10 @@ NaiveStaggeredFermion<Impl>::NaiveStaggeredFermion(GridCartesian &Fgrid, GridRed
   vol4= _cbgrid->oSites();
   StencilEven.BuildSurfaceList(LLs,vol4);
   StencilOdd.BuildSurfaceList(LLs,vol4);
+
+  Stencil.SetHaloCompression(Stencil_halo_compression);
+  StencilEven.SetHaloCompression(Stencil_halo_compression);
+  StencilOdd.SetHaloCompression(Stencil_halo_compression);
 }
 
 template <class Impl>
@@ -61,7 +61,13 @@ WilsonFermion5D<Impl>::WilsonFermion5D(GaugeField &_Umu,
   Lebesgue(_FourDimGrid),
   LebesgueEvenOdd(_FourDimRedBlackGrid),
   _tmp(&FiveDimRedBlackGrid),
-  Dirichlet(0)
+  Dirichlet(0),
+  MRHS_nrhs(0),
+  MRHS_FiveDimGrid(nullptr),
+  MRHS_FiveDimRedBlackGrid(nullptr),
+  MRHS_Stencil(nullptr),
+  MRHS_StencilEven(nullptr),
+  MRHS_StencilOdd(nullptr)
 {
   Stencil.lo     = &Lebesgue;
   StencilEven.lo = &LebesgueEvenOdd;
@@ -143,6 +149,116 @@ WilsonFermion5D<Impl>::WilsonFermion5D(GaugeField &_Umu,
   StencilEven.BuildSurfaceList(LLs,vol4);
    StencilOdd.BuildSurfaceList(LLs,vol4);
 
+  if ( WilsonKernelsStatic::Autotune ) Autotune();
+}
+
+template<class Impl>
+void WilsonFermion5D<Impl>::ApplyPlan(const WilsonKernelsPlan &plan)
+{
+  Plan = plan;
+  if ( Plan.Block.size() == Nd ) {
+    Lebesgue        = LebesgueOrder(_FourDimGrid,Plan.Block);
+    LebesgueEvenOdd = LebesgueOrder(_FourDimRedBlackGrid,Plan.Block);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// Time every applicable kernel variant, comms overlap mode and (for the assembler
+// kernels, the only ones looping in Lebesgue order) cache blocking on the red-black
+// hopping term. The winner is stored in the plan cache so later jobs skip the sweep.
+////////////////////////////////////////////////////////////////////////////////////
+template<class Impl>
+void WilsonFermion5D<Impl>::Autotune(void)
+{
+  typedef typename getPrecision<SiteSpinor>::real_scalar_type stype;
+  int precision      = sizeof(stype);
+  int commsprecision = (sizeof(stype)*sizeof(typename Impl::SiteHalfCommSpinor))/sizeof(SiteHalfSpinor);
+  std::string key = WilsonKernelsPlanCache::Key(typeid(Impl).name(),_FourDimGrid,Ls,precision,commsprecision,Simd::Nsimd(),Impl::Dimension);
+
+  std::vector<int> opts({WilsonKernelsStatic::OptGeneric});
+  if ( Impl::Dimension == 3 )            opts.push_back(WilsonKernelsStatic::OptHandUnroll);
+  if ( WilsonKernelsHaveAsm<Impl>::value ) opts.push_back(WilsonKernelsStatic::OptInlineAsm);
+
+  WilsonKernelsPlan plan;
+  if ( WilsonKernelsPlanCache::Lookup(key,plan) ) {
+    if ( std::find(opts.begin(),opts.end(),plan.Opt) != opts.end() ) {
+      std::cout << GridLogMessage << "WilsonFermion5D::Autotune cached plan "<<key
+		<< " Opt "<<plan.Opt<<" Comms "<<plan.Comms<<" Block "<<plan.Block<<std::endl;
+      ApplyPlan(plan);
+      return;
+    }
+    std::cout << GridLogMessage << "WilsonFermion5D::Autotune cached plan "<<key
+	      << " has unsupported Opt "<<plan.Opt<<"; retuning"<<std::endl;
+  }
+
+  std::vector<int> comms({WilsonKernelsStatic::CommsAndCompute,WilsonKernelsStatic::CommsThenCompute});
+
+  std::vector<std::vector<int> > blocks({ {0,0,0,0}, {1,0,0,0}, {2,2,2,2}, {4,2,2,2}, {8,2,2,2}, {4,4,2,2}, {4,4,4,4} });
+
+  FermionField src(_FiveDimRedBlackGrid);
+  FermionField res(_FiveDimRedBlackGrid);
+  src = Zero(); src.Checkerboard() = Even;
+  res = Zero();
+
+  WilsonKernelsPlan best;
+  best.key  = key;
+  best.usec = 0.0;
+
+  std::cout << GridLogMessage << "WilsonFermion5D::Autotune tuning "<<key<<std::endl;
+  for(auto opt : opts) {
+    for(auto comm : comms) {
+
+      std::vector<std::vector<int> > candidates({ std::vector<int>() });
+      if ( opt == WilsonKernelsStatic::OptInlineAsm ) {
+	candidates.resize(0);
+	for(auto &b : blocks) {
+	  int fits = 1;
+	  for(int mu=0;mu<Nd;mu++) if ( b[mu] > _FourDimRedBlackGrid->_rdimensions[mu] ) fits = 0;
+	  if ( fits ) candidates.push_back(b);
+	}
+      }
+
+      for(auto &block : candidates) {
+	WilsonKernelsPlan trial;
+	trial.key   = key;
+	trial.Opt   = opt;
+	trial.Comms = comm;
+	trial.Block = block;
+	ApplyPlan(trial);
+
+	// Warm up and calibrate; all ranks must agree on the call count
+	RealD t0=usecond();
+	DhopOE(src,res,DaggerNo);
+	RealD t1=usecond();
+	RealD once = t1-t0;
+	_FourDimGrid->GlobalMax(once);
+	int ncall = std::max(3,std::min(100,(int)(2.0e5/std::max(once,1.0))));
+
+	_FourDimGrid->Barrier();
+	t0=usecond();
+	for(int i=0;i<ncall;i++) DhopOE(src,res,DaggerNo);
+	t1=usecond();
+	RealD usec = (t1-t0)/ncall;
+	_FourDimGrid->GlobalMax(usec);
+
+	std::cout << GridLogMessage << "WilsonFermion5D::Autotune Opt "<<opt<<" Comms "<<comm
+		  <<" Block "<<block<<" : "<<usec<<" us"<<std::endl;
+	if ( (best.usec == 0.0) || (usec < best.usec) ) {
+	  best = trial;
+	  best.usec = usec;
+	}
+      }
+    }
+  }
+
+  std::cout << GridLogMessage << "WilsonFermion5D::Autotune selected Opt "<<best.Opt<<" Comms "<<best.Comms
+	    <<" Block "<<best.Block<<" : "<<best.usec<<" us"<<std::endl;
+
+  // Restore the default orderings before applying the winner
+  Lebesgue        = LebesgueOrder(_FourDimGrid);
+  LebesgueEvenOdd = LebesgueOrder(_FourDimRedBlackGrid);
+  ApplyPlan(best);
+  WilsonKernelsPlanCache::Insert(_FourDimGrid,best);
 }
 
 template<class Impl>
@@ -309,7 +425,7 @@ void WilsonFermion5D<Impl>::DhopInternal(StencilImpl & st, LebesgueOrder &lo,
                                          DoubledGaugeField & U,
                                          const FermionField &in, FermionField &out,int dag)
 {
-  if ( WilsonKernelsStatic::Comms == WilsonKernelsStatic::CommsAndCompute )
+  if ( KernelComms() == WilsonKernelsStatic::CommsAndCompute )
     DhopInternalOverlappedComms(st,lo,U,in,out,dag);
   else 
     DhopInternalSerialComms(st,lo,U,in,out,dag);
@@ -350,7 +466,7 @@ void WilsonFermion5D<Impl>::DhopInternalOverlappedComms(StencilImpl & st, Lebesg
   /////////////////////////////
   // do the compute interior
   /////////////////////////////
-  int Opt = WilsonKernelsStatic::Opt; // Why pass this. Kernels should know
+  int Opt = KernelOpt(); // Why pass this. Kernels should know
   if (dag == DaggerYes) {
     GRID_TRACE("DhopDagInterior");
     Kernels::DhopDagKernel(Opt,st,U,st.CommBuf(),LLs,U.oSites(),in,out,1,0);
@@ -400,7 +516,7 @@ void WilsonFermion5D<Impl>::DhopInternalSerialComms(StencilImpl & st, LebesgueOr
     st.HaloExchangeOpt(in,compressor);
   }
   
-  int Opt = WilsonKernelsStatic::Opt;
+  int Opt = KernelOpt();
   if (dag == DaggerYes) {
     GRID_TRACE("DhopDag");
     Kernels::DhopDagKernel(Opt,st,U,st.CommBuf(),LLs,U.oSites(),in,out);
@@ -443,6 +559,168 @@ void WilsonFermion5D<Impl>::Dhop(const FermionField &in, FermionField &out,int d
 
   DhopInternal(Stencil,Lebesgue,Umu,in,out,dag);
 }
+
+////////////////////////////////////////////////////////////////////////////////////
+// Multi-RHS: the kernels loop over the (inner) s-direction for each 4d site and
+// take the gauge link from the 4d site, so stacking nrhs sources along s reuses
+// each link nrhs*Ls times and the stacked stencil sends all faces in one exchange.
+////////////////////////////////////////////////////////////////////////////////////
+template<class Impl>
+void WilsonFermion5D<Impl>::MRHSTeardown(void)
+{
+  if ( MRHS_nrhs ) {
+    delete MRHS_Stencil;
+    delete MRHS_StencilEven;
+    delete MRHS_StencilOdd;
+    delete MRHS_FiveDimGrid;
+    delete MRHS_FiveDimRedBlackGrid;
+  }
+  MRHS_nrhs = 0;
+  MRHS_Stencil = MRHS_StencilEven = MRHS_StencilOdd = nullptr;
+  MRHS_FiveDimGrid = nullptr;
+  MRHS_FiveDimRedBlackGrid = nullptr;
+}
+template<class Impl>
+void WilsonFermion5D<Impl>::MRHSSetup(int nrhs)
+{
+  assert(!Impl::LsVectorised); // stacking would interleave sources across SIMD lanes
+  assert(nrhs>0);
+  if ( nrhs == MRHS_nrhs ) return;
+  MRHSTeardown();
+
+  GridCartesian *UGrid = dynamic_cast<GridCartesian *>(_FourDimGrid);
+  assert(UGrid!=nullptr);
+  MRHS_FiveDimGrid         = SpaceTimeGrid::makeFiveDimGrid(nrhs*Ls,UGrid);
+  MRHS_FiveDimRedBlackGrid = SpaceTimeGrid::makeFiveDimRedBlackGrid(nrhs*Ls,UGrid);
+
+  MRHS_Stencil     = new StencilImpl(MRHS_FiveDimGrid        ,npoint,Even,directions,displacements,this->Params);
+  MRHS_StencilEven = new StencilImpl(MRHS_FiveDimRedBlackGrid,npoint,Even,directions,displacements,this->Params);
+  MRHS_StencilOdd  = new StencilImpl(MRHS_FiveDimRedBlackGrid,npoint,Odd ,directions,displacements,this->Params);
+  MRHS_Stencil->lo     = &Lebesgue;
+  MRHS_StencilEven->lo = &LebesgueEvenOdd;
+  MRHS_StencilOdd->lo  = &LebesgueEvenOdd;
+
+  int LLs = MRHS_FiveDimGrid->_rdimensions[0];
+  int vol4;
+  vol4=_FourDimGrid->oSites();
+  MRHS_Stencil->BuildSurfaceList(LLs,vol4);
+  vol4=_FourDimRedBlackGrid->oSites();
+  MRHS_StencilEven->BuildSurfaceList(LLs,vol4);
+  MRHS_StencilOdd->BuildSurfaceList(LLs,vol4);
+
+  MRHS_nrhs = nrhs;
+}
+template<class Impl>
+GridCartesian *WilsonFermion5D<Impl>::MRHSGrid(int nrhs)
+{
+  MRHSSetup(nrhs);
+  return MRHS_FiveDimGrid;
+}
+template<class Impl>
+GridRedBlackCartesian *WilsonFermion5D<Impl>::MRHSRedBlackGrid(int nrhs)
+{
+  MRHSSetup(nrhs);
+  return MRHS_FiveDimRedBlackGrid;
+}
+template<class Impl>
+void WilsonFermion5D<Impl>::ImportMRHS(const std::vector<FermionField> &in, FermionField &stacked)
+{
+  int nrhs = in.size();
+  int LLs  = in[0].Grid()->_rdimensions[0];
+  int SLs  = stacked.Grid()->_rdimensions[0];
+  assert(SLs == nrhs*LLs);
+  uint64_t Nsite = in[0].Grid()->oSites();
+
+  stacked.Checkerboard() = in[0].Checkerboard();
+  autoView(st_v,stacked,AcceleratorWrite);
+  for(int r=0;r<nrhs;r++){
+    assert(in[r].Checkerboard()==in[0].Checkerboard());
+    autoView(in_v,in[r],AcceleratorRead);
+    accelerator_for(sF,Nsite,Simd::Nsimd(),{
+      uint64_t s  = sF%LLs;
+      uint64_t sU = sF/LLs;
+      coalescedWrite(st_v[sU*SLs+r*LLs+s],in_v(sF));
+    });
+  }
+}
+template<class Impl>
+void WilsonFermion5D<Impl>::ExportMRHS(const FermionField &stacked, std::vector<FermionField> &out)
+{
+  int nrhs = out.size();
+  int LLs  = out[0].Grid()->_rdimensions[0];
+  int SLs  = stacked.Grid()->_rdimensions[0];
+  assert(SLs == nrhs*LLs);
+  uint64_t Nsite = out[0].Grid()->oSites();
+
+  autoView(st_v,stacked,AcceleratorRead);
+  for(int r=0;r<nrhs;r++){
+    out[r].Checkerboard() = stacked.Checkerboard();
+    autoView(out_v,out[r],AcceleratorWrite);
+    accelerator_for(sF,Nsite,Simd::Nsimd(),{
+      uint64_t s  = sF%LLs;
+      uint64_t sU = sF/LLs;
+      coalescedWrite(out_v[sF],st_v(sU*SLs+r*LLs+s));
+    });
+  }
+}
+template<class Impl>
+void WilsonFermion5D<Impl>::DhopMRHS(const FermionField &in, FermionField &out,int dag)
+{
+  int nrhs = in.Grid()->_fdimensions[0]/Ls;
+  conformable(in.Grid(),MRHSGrid(nrhs)); // verifies full grid
+  conformable(in.Grid(),out.Grid());
+
+  out.Checkerboard() = in.Checkerboard();
+
+  DhopInternal(*MRHS_Stencil,Lebesgue,Umu,in,out,dag);
+}
+template<class Impl>
+void WilsonFermion5D<Impl>::DhopOEMRHS(const FermionField &in, FermionField &out,int dag)
+{
+  int nrhs = in.Grid()->_fdimensions[0]/Ls;
+  conformable(in.Grid(),MRHSRedBlackGrid(nrhs)); // verifies half grid
+  conformable(in.Grid(),out.Grid()); // drops the cb check
+
+  assert(in.Checkerboard()==Even);
+  out.Checkerboard() = Odd;
+
+  DhopInternal(*MRHS_StencilEven,LebesgueEvenOdd,UmuOdd,in,out,dag);
+}
+template<class Impl>
+void WilsonFermion5D<Impl>::DhopEOMRHS(const FermionField &in, FermionField &out,int dag)
+{
+  int nrhs = in.Grid()->_fdimensions[0]/Ls;
+  conformable(in.Grid(),MRHSRedBlackGrid(nrhs)); // verifies half grid
+  conformable(in.Grid(),out.Grid()); // drops the cb check
+
+  assert(in.Checkerboard()==Odd);
+  out.Checkerboard() = Even;
+
+  DhopInternal(*MRHS_StencilOdd,LebesgueEvenOdd,UmuEven,in,out,dag);
+}
+template<class Impl>
+void WilsonFermion5D<Impl>::DhopMRHS(const std::vector<FermionField> &in, std::vector<FermionField> &out,int dag)
+{
+  int nrhs = in.size();
+  assert(out.size()==nrhs);
+
+  GridBase *grid = in[0].Grid();
+  GridBase *sgrid;
+  if ( grid == FermionGrid() ) sgrid = MRHSGrid(nrhs);
+  else {
+    conformable(grid,FermionRedBlackGrid());
+    sgrid = MRHSRedBlackGrid(nrhs);
+  }
+  FermionField sin (sgrid);
+  FermionField sout(sgrid);
+
+  ImportMRHS(in,sin);
+  if ( grid == FermionGrid() )        DhopMRHS  (sin,sout,dag);
+  else if ( sin.Checkerboard()==Even ) DhopOEMRHS(sin,sout,dag);
+  else                                 DhopEOMRHS(sin,sout,dag);
+  ExportMRHS(sout,out);
+}
+
 template<class Impl>
 void WilsonFermion5D<Impl>::DW(const FermionField &in, FermionField &out,int dag)
 {
@@ -35,6 +35,110 @@ NAMESPACE_BEGIN(Grid);
 // Move these
 int WilsonKernelsStatic::Opt   = WilsonKernelsStatic::OptGeneric;
 int WilsonKernelsStatic::Comms = WilsonKernelsStatic::CommsAndCompute;
+int WilsonKernelsStatic::Autotune = 0;
+
+std::string                    WilsonKernelsPlanCache::filename("WilsonKernelsPlans.xml");
+std::vector<WilsonKernelsPlan> WilsonKernelsPlanCache::plans;
+int                            WilsonKernelsPlanCache::loaded = 0;
+
+std::string WilsonKernelsPlanCache::SimdTarget(void)
+{
+#if defined(GRID_CUDA)
+  return std::string("CUDA");
+#elif defined(GRID_HIP)
+  return std::string("HIP");
+#elif defined(GRID_SYCL)
+  return std::string("SYCL");
+#elif defined(AVX512)
+  return std::string("AVX512");
+#elif defined(AVX2)
+  return std::string("AVX2");
+#elif defined(AVXFMA4)
+  return std::string("AVXFMA4");
+#elif defined(AVXFMA)
+  return std::string("AVXFMA");
+#elif defined(AVX1)
+  return std::string("AVX");
+#elif defined(SSE4)
+  return std::string("SSE4");
+#elif defined(A64FX) || defined(A64FXFIXEDSIZE)
+  return std::string("A64FX");
+#elif defined(NEONV8)
+  return std::string("NEONV8");
+#elif defined(GEN)
+  return std::string("GEN")+std::to_string(GEN_SIMD_WIDTH);
+#else
+  return std::string("UNKNOWN");
+#endif
+}
+
+std::string WilsonKernelsPlanCache::Key(const std::string &impl,GridBase *FourDimGrid,int Ls,int precision,int commsprecision,int Nsimd,int Nrep)
+{
+  auto dotted = [](const Coordinate &c) {
+    std::stringstream ss;
+    for(int d=0;d<c.size();d++) ss << (d ? "." : "") << c[d];
+    return ss.str();
+  };
+  std::stringstream key;
+  key << SimdTarget();
+  key << "_" << impl;
+  key << "_L"  << dotted(FourDimGrid->LocalDimensions());
+  key << "_P"  << dotted(FourDimGrid->ProcessorGrid());
+  key << "_Ls" << Ls;
+  key << "_Prec" << precision;
+  key << "_Comms" << commsprecision;
+  key << "_Nsimd" << Nsimd;
+  key << "_Nrep" << Nrep;
+  return key.str();
+}
+
+void WilsonKernelsPlanCache::Load(void)
+{
+  if ( loaded ) return;
+  loaded = 1;
+  std::ifstream probe(filename);
+  if ( !probe.good() ) return;
+  probe.close();
+
+  WilsonKernelsPlanFile file;
+  XmlReader RD(filename);
+  read(RD,"WilsonKernelsPlanFile",file);
+  plans = file.plans;
+  std::cout << GridLogMessage << "WilsonKernelsPlanCache: loaded "<<plans.size()<<" plans from "<<filename<<std::endl;
+}
+
+bool WilsonKernelsPlanCache::Lookup(const std::string &key,WilsonKernelsPlan &plan)
+{
+  Load();
+  for(auto &p : plans) {
+    if ( p.key == key ) {
+      plan = p;
+      return true;
+    }
+  }
+  return false;
+}
+
+void WilsonKernelsPlanCache::Insert(GridBase *grid,const WilsonKernelsPlan &plan)
+{
+  Load();
+  bool found = false;
+  for(auto &p : plans) {
+    if ( p.key == plan.key ) {
+      p = plan;
+      found = true;
+    }
+  }
+  if ( !found ) plans.push_back(plan);
+
+  if ( grid->IsBoss() ) {
+    WilsonKernelsPlanFile file;
+    file.plans = plans;
+    XmlWriter WR(filename);
+    write(WR,"WilsonKernelsPlanFile",file);
+  }
+  grid->Barrier();
+}
 
 NAMESPACE_END(Grid);
 
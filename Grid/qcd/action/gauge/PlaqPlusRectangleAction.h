@@ -43,9 +43,16 @@ public:
 private:
   RealD c_plaq;
   RealD c_rect;
-  typename WilsonLoops<Gimpl>::StapleAndRectStapleAllWorkspace workspace;
+  GaugePaths<Gimpl> force_paths; // weighted 1x1 and 1x2 staples in one fused kernel
 public:
-  PlaqPlusRectangleAction(RealD b,RealD c): c_plaq(b),c_rect(c){};
+  PlaqPlusRectangleAction(RealD b,RealD c): c_plaq(b),c_rect(c){
+    RealD factor_p = c_plaq/RealD(Nc)*0.5;
+    RealD factor_r = c_rect/RealD(Nc)*0.5;
+    for(int mu=0;mu<Nd;mu++){
+      force_paths.AddStaples(mu,mu,factor_p);
+      force_paths.AddRectStaples(mu,mu,factor_r);
+    }
+  };
 
   virtual std::string action_name(){return "PlaqPlusRectangleAction";}
       
@@ -73,24 +80,20 @@ public:
 
   virtual void deriv(const GaugeField &Umu,GaugeField & dSdU) {
     //extend Ta to include Lorentz indexes
-    RealD factor_p = c_plaq/RealD(Nc)*0.5;
-    RealD factor_r = c_rect/RealD(Nc)*0.5;
-
     GridBase *grid = Umu.Grid();
 
     std::vector<GaugeLinkField> U (Nd,grid);
     for(int mu=0;mu<Nd;mu++){
       U[mu] = PeekIndex<LorentzIndex>(Umu,mu);
     }
-    std::vector<GaugeLinkField> RectStaple(Nd,grid), Staple(Nd,grid);
-    WilsonLoops<Gimpl>::StapleAndRectStapleAll(Staple, RectStaple, U, workspace);
+    // c_plaq and c_rect weights are folded into the paths
+    std::vector<GaugeLinkField> Staple(Nd,grid);
+    force_paths(Staple, U);
 
     GaugeLinkField dSdU_mu(grid);
-    GaugeLinkField staple(grid);
 
     for (int mu=0; mu < Nd; mu++){
-      dSdU_mu = Ta(U[mu]*Staple[mu])*factor_p;
-      dSdU_mu = dSdU_mu + Ta(U[mu]*RectStaple[mu])*factor_r;
+      dSdU_mu = Ta(U[mu]*Staple[mu]);
 	  
       PokeIndex<LorentzIndex>(dSdU, dSdU_mu, mu);
     }
@@ -54,6 +54,10 @@ public:
 
   HMCparameters Parameters;
   std::string ParameterFile;
+
+  // Retune the step sizes over the thermalisation trajectories
+  bool TuneIntegrator = false;
+  IntegratorTuneParameters TuneParameters;
   HMCResourceManager<Implementation> Resources;
 
   // The set of actions (keep here for lower level users, for now)
@@ -116,6 +120,16 @@ public:
       Parameters.NoMetropolisUntil = ivec[0];
       std::cout << GridLogMessage<<" GenericHMCrunner --Thermalizations "<<ivec[0]<<std::endl;
     }
+    if (GridCmdOptionExists(argv, argv + argc, "--TuneIntegrator")) {
+      TuneIntegrator = true;
+      std::cout << GridLogMessage<<" GenericHMCrunner --TuneIntegrator"<<std::endl;
+    }
+
+    if (GridCmdOptionExists(argv, argv + argc, "--TargetAcceptance")) {
+      arg = GridCmdOptionPayload(argv, argv + argc, "--TargetAcceptance");
+      TuneParameters.TargetAcceptance = std::stod(arg);
+      std::cout << GridLogMessage<<" GenericHMCrunner --TargetAcceptance "<<arg<<std::endl;
+    }
     if (GridCmdOptionExists(argv, argv + argc, "--ParameterFile")) {
       arg = GridCmdOptionPayload(argv, argv + argc, "--ParameterFile");
       ParameterFile = arg;
@@ -200,8 +214,14 @@ private:
                                         Resources.GetParallelRNG(), 
                                         Resources.GetObservables(), U);
 
+    IntegratorStepTuner<TheIntegrator> Tuner(TuneParameters);
+    if (TuneIntegrator) HMC.setStepTuner(Tuner);
+
     // Run it
     HMC.evolve();
+
+    // A checkpoint may still be written in the background
+    if (Resources.HasCheckPointer()) Resources.GetCheckPointer()->CheckpointWait();
   }
 };
 
@@ -44,6 +44,7 @@ directory
 
 #include <Grid/qcd/hmc/integrators/Integrator.h>
 #include <Grid/qcd/hmc/integrators/Integrator_algorithm.h>
+#include <Grid/qcd/hmc/integrators/IntegratorTuner.h>
 
 NAMESPACE_BEGIN(Grid);
 
@@ -110,6 +111,9 @@ private:
   IntegratorType &TheIntegrator;
   ObsListType Observables;
 
+  // Optional step size tuning during thermalisation
+  IntegratorStepTuner<IntegratorType> *StepTuner = nullptr;
+
   /////////////////////////////////////////////////////////
   // Metropolis step
   /////////////////////////////////////////////////////////
@@ -245,6 +249,8 @@ public:
     : Params(_Pams), TheIntegrator(_Int), sRNG(_sRNG), pRNG(_pRNG), Observables(_Obs), Ucur(_U) {}
   ~HybridMonteCarlo(){};
 
+  void setStepTuner(IntegratorStepTuner<IntegratorType> &Tuner) { StepTuner = &Tuner; }
+
   void evolve(void) {
     Real DeltaH;
 
@@ -253,6 +259,12 @@ public:
     Params.print_parameters();
     TheIntegrator.print_actions();
 
+    if (Params.MetropolisTest && !TheIntegrator.exactly_reversible()) {
+      std::cout << GridLogWarning << "Integrator " << TheIntegrator.integrator_name()
+		<< " is reversible only to O(eps^" << TheIntegrator.integrator_order()
+		<< "); the Metropolis test is not exact. Check the reversibility violation" << std::endl;
+    }
+
     // Actual updates (evolve a copy Ucopy then copy back eventually)
     unsigned int FinalTrajectory = Params.Trajectories + Params.NoMetropolisUntil + Params.StartTrajectory;
 
@@ -278,6 +290,10 @@ public:
 
       if (accept)
         Ucur = Ucopy; 
+
+      if (StepTuner && traj < Params.StartTrajectory + Params.NoMetropolisUntil) {
+	StepTuner->Record(TheIntegrator, DeltaH);
+      }
       
       double t1=usecond();
       std::cout << GridLogHMC << "Total time for trajectory (s): " << (t1-t0)/1e6 << std::endl;
@@ -275,6 +275,8 @@ public:
   // Checkpointers
   //////////////////////////////////////////////////////
 
+  bool HasCheckPointer() const { return have_CheckPointer; }
+
   BaseHmcCheckpointer<ImplementationPolicy>* GetCheckPointer() {
     if (have_CheckPointer)
       return CP->getPtr();
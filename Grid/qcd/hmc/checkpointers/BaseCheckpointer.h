@@ -29,6 +29,8 @@ directory
 #ifndef BASE_CHECKPOINTER
 #define BASE_CHECKPOINTER
 
+#include <thread>
+
 NAMESPACE_BEGIN(Grid);
 
 class CheckpointerParameters : Serializable {
@@ -39,15 +41,17 @@ public:
 				  std::string, rng_prefix, 
 				  int, saveInterval, 
 				  bool, saveSmeared, 
-				  std::string, format, );
+				  std::string, format,
+				  bool, asyncWrite, );
 
   CheckpointerParameters(std::string cf = "cfg", std::string sf="cfg_smr" , std::string rn = "rng",
-			 int savemodulo = 1, const std::string &f = "IEEE64BIG")
+			 int savemodulo = 1, const std::string &f = "IEEE64BIG", bool async = false)
     : config_prefix(cf),
       smeared_prefix(sf),
       rng_prefix(rn),
       saveInterval(savemodulo),
-      format(f){};
+      format(f),
+      asyncWrite(async){};
 
 
   template <class ReaderClass >
@@ -85,7 +89,9 @@ public:
       conf_file = os.str();
     }
   } 
-  virtual ~BaseHmcCheckpointer(){};
+  // Derived checkpointers wait in their own destructor, while the members
+  // their writer uses are still alive; this only covers those that do not
+  virtual ~BaseHmcCheckpointer(){ CheckpointWait(); };
   void check_filename(const std::string &filename){
     std::ifstream f(filename.c_str());
     if(!f.good()){
@@ -104,6 +110,116 @@ public:
                                  GridSerialRNG &sRNG,
                                  GridParallelRNG &pRNG) = 0;
 
+  // Block until a checkpoint being written in the background is on disk
+  void CheckpointWait(void) {
+    if ( Writer.joinable() ) {
+      GridStopWatch timer;
+      timer.Start();
+      Writer.join();
+      timer.Stop();
+      std::cout << GridLogMessage << "Background checkpoint completed; waited " << timer.Elapsed() << std::endl;
+    }
+  }
+
+protected:
+  typedef typename Impl::Field CheckpointField;
+  typedef std::function<void(CheckpointField &U, CheckpointField &Usmr,
+			     GridSerialRNG &sRNG, GridParallelRNG &pRNG)> CheckpointWriter;
+
+  ////////////////////////////////////////////////////////////////////////////
+  // Hand the configuration (and the smeared one if requested) with the RNG
+  // state to a writer. In async mode they are first copied to a staging grid
+  // with its own communicator, so the writer thread's collective I/O cannot
+  // interleave with the next trajectory's communications. The writer must
+  // only do I/O: anything using Cshift or stencils (e.g. the plaquette for a
+  // header) shares static buffers with the HMC and is computed by the caller.
+  ////////////////////////////////////////////////////////////////////////////
+  void CheckpointWrite(bool async, bool smeared,
+		       ConfigurationBase<CheckpointField> &SmartConfig,
+		       GridSerialRNG &sRNG, GridParallelRNG &pRNG,
+		       CheckpointWriter write)
+  {
+    CheckpointWait();
+
+    CheckpointField &U    = SmartConfig.get_U(false);
+    CheckpointField &Usmr = smeared ? SmartConfig.get_U(true) : U;
+
+    if ( async && !AsyncSupported() ) {
+      std::cout << GridLogWarning << "Asynchronous checkpoints need MPI_THREAD_MULTIPLE (--comms-thread-multiple) "
+		<< "and unified memory; writing synchronously" << std::endl;
+      async = false;
+    }
+    if ( !async ) {
+      write(U, Usmr, sRNG, pRNG);
+      return;
+    }
+
+    GridStopWatch timer;
+    timer.Start();
+    GridBase *grid = U.Grid();
+    if ( !StagingGrid ) {
+      GridCartesian *parent = dynamic_cast<GridCartesian *>(grid); assert(parent);
+      StagingGrid.reset(new GridCartesian(grid->FullDimensions(), grid->_simd_layout,
+					  grid->ProcessorGrid(), *parent));
+      assert(StagingGrid->ThisRank() == grid->ThisRank());
+      StagingU.reset(new CheckpointField(StagingGrid.get()));
+      StagingUsmr.reset(new CheckpointField(StagingGrid.get()));
+      StagingpRNG.reset(new GridParallelRNG(StagingGrid.get()));
+    }
+    assert(pRNG.Grid()->lSites() == StagingGrid->lSites());
+
+    StagingCopy(*StagingU, U);
+    if ( smeared ) StagingCopy(*StagingUsmr, Usmr);
+    StagingsRNG = sRNG;
+    StagingpRNG->_generators = pRNG._generators;
+    if ( pRNG.CounterBased() ) {
+      std::vector<uint64_t> counter;
+      pRNG.GetCounterState(counter);
+      StagingpRNG->SetCounterState(counter);
+    } else {
+      StagingpRNG->SiteGenerators();
+    }
+    timer.Stop();
+    std::cout << GridLogMessage << "Checkpoint staged in " << timer.Elapsed()
+	      << "; writing in the background" << std::endl;
+
+    CheckpointField &Uw    = *StagingU;
+    CheckpointField &Usmrw = smeared ? *StagingUsmr : *StagingU;
+    Writer = std::thread([this, write, &Uw, &Usmrw]() {
+      write(Uw, Usmrw, StagingsRNG, *StagingpRNG);
+    });
+  }
+
+private:
+  std::unique_ptr<GridCartesian>   StagingGrid;
+  std::unique_ptr<CheckpointField> StagingU;
+  std::unique_ptr<CheckpointField> StagingUsmr;
+  std::unique_ptr<GridParallelRNG> StagingpRNG;
+  GridSerialRNG                    StagingsRNG;
+  std::thread                      Writer;
+
+  static void StagingCopy(CheckpointField &to, const CheckpointField &from) {
+    autoView(to_v  , to  , CpuWrite);
+    autoView(from_v, from, CpuRead);
+    thread_for(ss, from.Grid()->oSites(), {
+      to_v[ss] = from_v[ss];
+    });
+    to.Checkerboard() = from.Checkerboard();
+  }
+
+  // The writer thread issues MPI calls and allocates while the HMC runs
+  static bool AsyncSupported(void) {
+#ifdef GRID_COMMS_MPI3
+    int provided;
+    MPI_Query_thread(&provided);
+    if ( provided != MPI_THREAD_MULTIPLE ) return false;
+#endif
+#ifndef GRID_UVM
+    return false; // the device view table is not thread safe
+#endif
+    return true;
+  }
+
 };  // class BaseHmcCheckpointer
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -53,6 +53,7 @@ public:
   BinaryHmcCheckpointer(const CheckpointerParameters &Params_) {
     initialize(Params_);
   }
+  ~BinaryHmcCheckpointer() { this->CheckpointWait(); } // the writer uses Params
 
   void initialize(const CheckpointerParameters &Params_) { Params = Params_; }
 
@@ -67,6 +68,8 @@ public:
   {
 
     if ((traj % Params.saveInterval) == 0) {
+      this->CheckpointWrite(Params.asyncWrite, Params.saveSmeared, SmartConfig, sRNG, pRNG,
+			    [this, traj](Field &U, Field &Usmr, GridSerialRNG &sRNG, GridParallelRNG &pRNG) {
       std::string config, rng, smr;
       this->build_filenames(traj, Params, config, smr, rng);
 
@@ -85,7 +88,7 @@ public:
 		<< std::dec << std::endl;
 
       truncate(config);
-      BinaryIO::writeLatticeObject<vobj, sobj_double>(SmartConfig.get_U(false), config, munge, 0, Params.format,
+      BinaryIO::writeLatticeObject<vobj, sobj_double>(U, config, munge, 0, Params.format,
 						      nersc_csum,scidac_csuma,scidac_csumb);
 
       std::cout << GridLogMessage << "Written Binary Configuration " << config
@@ -97,7 +100,7 @@ public:
 
       if ( Params.saveSmeared ) {
 	truncate(smr);
-	BinaryIO::writeLatticeObject<vobj, sobj_double>(SmartConfig.get_U(true), smr, munge, 0, Params.format,
+	BinaryIO::writeLatticeObject<vobj, sobj_double>(Usmr, smr, munge, 0, Params.format,
 							nersc_csum,scidac_csuma,scidac_csumb);
 	std::cout << GridLogMessage << "Written Binary Smeared Configuration " << smr
                 << " checksum " << std::hex 
@@ -106,13 +109,15 @@ public:
 		<< scidac_csumb 
 		<< std::dec << std::endl;
       }
+      });
     }
 
   };
 
   void CheckpointRestore(int traj, Field &U, GridSerialRNG &sRNG, GridParallelRNG &pRNG) {
-    std::string config, rng;
-    this->build_filenames(traj, Params, config, rng);
+    this->CheckpointWait();
+    std::string config, rng, smr;
+    this->build_filenames(traj, Params, config, smr, rng);
     this->check_filename(rng);
     this->check_filename(config);
 
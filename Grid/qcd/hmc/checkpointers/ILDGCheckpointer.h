@@ -48,6 +48,7 @@ public:
   typedef GaugeStatistics<Implementation> GaugeStats;
 
   ILDGHmcCheckpointer(const CheckpointerParameters &Params_) { initialize(Params_); }
+  ~ILDGHmcCheckpointer() { this->CheckpointWait(); } // the writer uses Params
 
   void initialize(const CheckpointerParameters &Params_) {
     Params = Params_;
@@ -74,9 +75,17 @@ public:
 			  GridSerialRNG &sRNG,
                           GridParallelRNG &pRNG) {
     if ((traj % Params.saveInterval) == 0) {
+      // Plaquette and link trace need Cshift, so are taken on this thread
+      FieldMetaData header, header_smr;
+      GaugeStats Stats;
+      Stats(SmartConfig.get_U(false), header);
+      if ( Params.saveSmeared ) Stats(SmartConfig.get_U(true), header_smr);
+
+      this->CheckpointWrite(Params.asyncWrite, Params.saveSmeared, SmartConfig, sRNG, pRNG,
+			    [this, traj, header, header_smr](GaugeField &U, GaugeField &Usmr, GridSerialRNG &sRNG, GridParallelRNG &pRNG) {
       std::string config, rng, smr;
-      this->build_filenames(traj, Params, config, rng);
-      GridBase *grid = SmartConfig.get_U(false).Grid();
+      this->build_filenames(traj, Params, config, smr, rng);
+      GridBase *grid = U.Grid();
       uint32_t nersc_csum,scidac_csuma,scidac_csumb;
       BinaryIO::writeRNG(sRNG, pRNG, rng, 0,nersc_csum,scidac_csuma,scidac_csumb);
       std::cout << GridLogMessage << "Written BINARY RNG " << rng
@@ -89,7 +98,7 @@ public:
       
       IldgWriter _IldgWriter(grid->IsBoss());
       _IldgWriter.open(config);
-      _IldgWriter.writeConfiguration<GaugeStats>(SmartConfig.get_U(false), traj, config, config);
+      _IldgWriter.writeConfiguration(U, header, traj, config, config);
       _IldgWriter.close();
 
       std::cout << GridLogMessage << "Written ILDG Configuration on " << config
@@ -102,7 +111,7 @@ public:
       if ( Params.saveSmeared ) { 
 	IldgWriter _IldgWriter(grid->IsBoss());
 	_IldgWriter.open(smr);
-	_IldgWriter.writeConfiguration<GaugeStats>(SmartConfig.get_U(true), traj, config, config);
+	_IldgWriter.writeConfiguration(Usmr, header_smr, traj, config, config);
 	_IldgWriter.close();
 
 	std::cout << GridLogMessage << "Written ILDG Configuration on " << smr
@@ -112,14 +121,15 @@ public:
 		<< scidac_csumb
 		<< std::dec << std::endl;
       }
-
+      });
     }
   };
 
   void CheckpointRestore(int traj, GaugeField &U, GridSerialRNG &sRNG,
                          GridParallelRNG &pRNG) {
-    std::string config, rng;
-    this->build_filenames(traj, Params, config, rng);
+    this->CheckpointWait();
+    std::string config, rng, smr;
+    this->build_filenames(traj, Params, config, smr, rng);
     this->check_filename(rng);
     this->check_filename(config);
 
@@ -46,6 +46,7 @@ public:
   typedef GaugeStatistics<Gimpl> GaugeStats;
   
   NerscHmcCheckpointer(const CheckpointerParameters &Params_) { initialize(Params_); }
+  ~NerscHmcCheckpointer() { this->CheckpointWait(); } // the writer uses Params
 
   void initialize(const CheckpointerParameters &Params_) {
     Params = Params_;
@@ -58,21 +59,31 @@ public:
                                   GridParallelRNG &pRNG)
   {
     if ((traj % Params.saveInterval) == 0) {
+      // Plaquette and link trace need Cshift, so are taken on this thread
+      FieldMetaData header, header_smr;
+      GaugeStats Stats;
+      Stats(SmartConfig.get_U(false), header);
+      if ( Params.saveSmeared ) Stats(SmartConfig.get_U(true), header_smr);
+
+      this->CheckpointWrite(Params.asyncWrite, Params.saveSmeared, SmartConfig, sRNG, pRNG,
+			    [this, traj, header, header_smr](GaugeField &U, GaugeField &Usmr, GridSerialRNG &sRNG, GridParallelRNG &pRNG) {
       std::string config, rng, smr;
       this->build_filenames(traj, Params, config, smr, rng);
       
       int precision32 = 1;
       int tworow = 0;
       NerscIO::writeRNGState(sRNG, pRNG, rng);
-      NerscIO::writeConfiguration<GaugeStats>(SmartConfig.get_U(false), config, tworow, precision32);
+      NerscIO::writeConfiguration(U, header, config, tworow, precision32);
       if ( Params.saveSmeared ) {
-	NerscIO::writeConfiguration<GaugeStats>(SmartConfig.get_U(true), smr, tworow, precision32);
+	NerscIO::writeConfiguration(Usmr, header_smr, smr, tworow, precision32);
       }
+      });
     }
   };
 
   void CheckpointRestore(int traj, GaugeField &U, GridSerialRNG &sRNG,
                          GridParallelRNG &pRNG) {
+    this->CheckpointWait();
     std::string config, rng, smr;
     this->build_filenames(traj, Params, config, smr, rng );
     this->check_filename(rng);
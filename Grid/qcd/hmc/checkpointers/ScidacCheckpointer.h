@@ -49,6 +49,7 @@ class ScidacHmcCheckpointer : public BaseHmcCheckpointer<Implementation> {
 
   ScidacHmcCheckpointer(const CheckpointerParameters &Params_) { initialize(Params_); }
   ScidacHmcCheckpointer(const CheckpointerParameters &Params_, const Metadata& M_):MData(M_) { initialize(Params_); }
+  ~ScidacHmcCheckpointer() { this->CheckpointWait(); } // the writer uses Params and MData
 
   void initialize(const CheckpointerParameters &Params_) {
     Params = Params_;
@@ -75,9 +76,11 @@ class ScidacHmcCheckpointer : public BaseHmcCheckpointer<Implementation> {
 			  GridSerialRNG &sRNG,
                           GridParallelRNG &pRNG) {
     if ((traj % Params.saveInterval) == 0) {
+      this->CheckpointWrite(Params.asyncWrite, Params.saveSmeared, SmartConfig, sRNG, pRNG,
+			    [this, traj](Field &U, Field &Usmr, GridSerialRNG &sRNG, GridParallelRNG &pRNG) {
       std::string config, rng,smr;
       this->build_filenames(traj, Params, config, smr, rng);
-      GridBase *grid = SmartConfig.get_U(false).Grid();
+      GridBase *grid = U.Grid();
       uint32_t nersc_csum,scidac_csuma,scidac_csumb;
       BinaryIO::writeRNG(sRNG, pRNG, rng, 0,nersc_csum,scidac_csuma,scidac_csumb);
       std::cout << GridLogMessage << "Written Binary RNG " << rng
@@ -91,24 +94,26 @@ class ScidacHmcCheckpointer : public BaseHmcCheckpointer<Implementation> {
       {
 	ScidacWriter _ScidacWriter(grid->IsBoss());
 	_ScidacWriter.open(config);
-	_ScidacWriter.writeScidacFieldRecord(SmartConfig.get_U(false), MData);
+	_ScidacWriter.writeScidacFieldRecord(U, MData);
 	_ScidacWriter.close();
       }
       
       if ( Params.saveSmeared ) {
 	ScidacWriter _ScidacWriter(grid->IsBoss());
 	_ScidacWriter.open(smr);
-	_ScidacWriter.writeScidacFieldRecord(SmartConfig.get_U(true), MData);
+	_ScidacWriter.writeScidacFieldRecord(Usmr, MData);
 	_ScidacWriter.close();
       }
       std::cout << GridLogMessage << "Written Scidac Configuration on " << config << std::endl;
+      });
     }
   };
 
   void CheckpointRestore(int traj, Field &U, GridSerialRNG &sRNG,
                          GridParallelRNG &pRNG) {
-    std::string config, rng;
-    this->build_filenames(traj, Params, config, rng);
+    this->CheckpointWait();
+    std::string config, rng, smr;
+    this->build_filenames(traj, Params, config, smr, rng);
     this->check_filename(rng);
     this->check_filename(config);
 
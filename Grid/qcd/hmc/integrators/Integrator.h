@@ -85,9 +85,13 @@ public:
   //The default filter does nothing
   MomentumFilterBase<MomentaField> const* MomFilter;
 
-  const ActionSet<Field, RepresentationPolicy> as;
+  ActionSet<Field, RepresentationPolicy> as; // multipliers may be retuned, see IntegratorStepTuner
 
   ActionSet<Field,RepresentationPolicy> LevelForces;
+
+  // Cost of the link updates, including resmearing
+  RealD update_U_us;
+  int   update_U_num;
   
   //Get a pointer to a shared static instance of the "do-nothing" momentum filter to serve as a default
   static MomentumFilterBase<MomentaField> const* getDefaultMomFilter(){ 
@@ -203,6 +207,7 @@ public:
   
   void update_U(MomentaField& Mom, Field& U, double ep) 
   {
+    update_U_us -= usecond();
     MomentaField MomFiltered(Mom.Grid());
     MomFiltered = Mom;
     MomFilter->applyFilter(MomFiltered);
@@ -215,6 +220,8 @@ public:
 
     // Update the higher representations fields
     Representations.update(U);  // void functions if fundamental representation
+    update_U_us += usecond();
+    update_U_num++;
   }
 
   virtual void step(Field& U, int level, int first, int last) = 0;
@@ -232,6 +239,8 @@ public:
   {
     t_P.resize(levels, 0.0);
     t_U = 0.0;
+    update_U_us = 0.0;
+    update_U_num = 0;
     // initialization of smearer delegated outside of Integrator
 
     //Default the momentum filter to "do-nothing"
@@ -255,6 +264,32 @@ public:
   }
 
   virtual std::string integrator_name() = 0;
+
+  // Power of the step size in the energy violation dH
+  virtual int integrator_order() { return 2; }
+
+  // False if reversibility only holds to the order of dH, which
+  // makes the Metropolis test inexact
+  virtual bool exactly_reversible() { return true; }
+
+  // Step size of the given level; each level makes multiplier steps
+  // per step of the level above
+  virtual RealD step_size(int level)
+  {
+    RealD eps = Params.trajL/Params.MDsteps;
+    for (int l = 0; l <= level; ++l) eps /= as[l].multiplier;
+    return eps;
+  }
+
+  // Outer steps and the multipliers of the inner levels; level 0 keeps its own
+  void set_steps(int MDsteps, const std::vector<int> &multipliers)
+  {
+    assert(multipliers.size() == levels);
+    Params.MDsteps = MDsteps;
+    for (int level = 1; level < levels; ++level) {
+      as[level].multiplier = multipliers[level];
+    }
+  }
   
   //Set the momentum filter allowing for manipulation of the conjugate momentum
   void setMomentumFilter(const MomentumFilterBase<MomentaField> &filter){
@@ -276,6 +311,8 @@ public:
       assert(LevelForces.at(level).actions.size()==1);
       LevelForces.at(level).actions.at(actionID)->reset_timer();
     }
+    update_U_us = 0.0;
+    update_U_num = 0;
   }
   void print_timer(void)
   {
@@ -313,6 +350,10 @@ public:
       }
     }
     std::cout << GridLogMessage << "--------------------------- "<<std::endl;
+    std::cout << GridLogMessage << " Link update cumulative timing "<<std::endl;
+    std::cout << GridLogMessage << "--------------------------- "<<std::endl;
+    std::cout << GridLogMessage << " update_U "<< update_U_us*1.0e-6<<" s calls "<<update_U_num<< std::endl;
+    std::cout << GridLogMessage << "--------------------------- "<<std::endl;
     std::cout << GridLogMessage << " Dslash counts "<<std::endl;
     std::cout << GridLogMessage << "------------------------- "<<std::endl;
     uint64_t full, partial, dirichlet;
@@ -0,0 +1,245 @@
+/*************************************************************************************
+
+Grid physics library, www.github.com/paboyle/Grid
+
+Source file: ./Grid/qcd/hmc/integrators/IntegratorTuner.h
+
+Copyright (C) 2023
+
+Author: Peter Boyle <paboyle@ph.ed.ac.uk>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+See the full license in the file "LICENSE" in the top level distribution
+directory
+*************************************************************************************/
+			   /*  END LEGAL */
+#pragma once
+
+NAMESPACE_BEGIN(Grid);
+
+/////////////////////////////////////////////////////////////////////////////
+// Step size tuning of a nested integrator from thermalisation trajectories.
+//
+// Each trajectory records dH, the step size h_l and the average force
+// norm F_l of every level, and the measured cost of a force evaluation
+// on each level and of a link update. The energy violation is modelled as
+//
+//   <dH^2> = kappa sum_l ( F_l h_l^p )^2
+//
+// with p the integrator order, and kappa fitted over all recorded
+// trajectories, which span the step sizes of successive rounds. The step
+// size of level l is taken from the integrator as nest_l trajL/N_l, with
+// N_l the steps on the level, so nest_l carries its nesting (1 for
+// LeapFrog, 2^-l for the integrators that halve the step per level). Using
+// <dH> = <dH^2>/2 and P_acc = erfc( sqrt(<dH>)/2 ), the target acceptance
+// bounds <dH^2>; the outer step count and inner multipliers that meet the
+// bound at least cost are searched exhaustively and applied.
+//
+//   IntegratorStepTuner<Integrator> Tuner(TuneParams);
+//   HMC.setStepTuner(Tuner); // records thermalisation trajectories
+/////////////////////////////////////////////////////////////////////////////
+struct IntegratorTuneParameters : Serializable {
+public:
+  GRID_SERIALIZABLE_CLASS_MEMBERS(IntegratorTuneParameters,
+				  RealD, TargetAcceptance,
+				  int, RoundLength,    /*trajectories between retunes*/
+				  int, MaxMDsteps,
+				  int, MaxMultiplier);
+
+  IntegratorTuneParameters(RealD _TargetAcceptance = 0.8,
+			   int _RoundLength   = 4,
+			   int _MaxMDsteps    = 64,
+			   int _MaxMultiplier = 16)
+    : TargetAcceptance(_TargetAcceptance),
+      RoundLength(_RoundLength),
+      MaxMDsteps(_MaxMDsteps),
+      MaxMultiplier(_MaxMultiplier) {};
+
+  template <class ReaderClass >
+  IntegratorTuneParameters(Reader<ReaderClass> & TheReader){
+    read(TheReader, "IntegratorTune", *this);
+  }
+};
+
+template <class IntegratorType>
+class IntegratorStepTuner {
+public:
+  IntegratorTuneParameters Params;
+
+  int levels;
+  int order;
+  // Sums over the recorded trajectories
+  int   samples;
+  RealD sum_dH2;
+  RealD sum_model;            // sum_i sum_l ( F_l h_l^p )^2
+  std::vector<RealD> sum_force;
+  std::vector<RealD> force_us;  // force evaluation time per level
+  std::vector<RealD> force_num; // force evaluations per level
+  std::vector<RealD> steps;     // steps per level
+  std::vector<RealD> nest;      // step size over trajL/steps per level
+  RealD update_U_us;
+  RealD update_U_num;
+  RealD steps_U;
+
+  IntegratorStepTuner(IntegratorTuneParameters _Params) : Params(_Params), levels(0), order(2)
+  {
+    Reset();
+  };
+
+  void Reset(void)
+  {
+    samples = 0;
+    sum_dH2 = sum_model = 0.0;
+    update_U_us = update_U_num = steps_U = 0.0;
+    sum_force.assign(levels,0.0);
+    force_us.assign(levels,0.0);
+    force_num.assign(levels,0.0);
+    steps.assign(levels,0.0);
+    nest.assign(levels,1.0);
+  }
+
+  // Acceptance erfc(sqrt(<dH>)/2) is monotonic in <dH>
+  static RealD TargetDeltaH2(RealD acceptance)
+  {
+    assert(acceptance > 0.0 && acceptance < 1.0);
+    RealD lo = 0.0, hi = 1.0;
+    while ( std::erfc(std::sqrt(hi)/2.0) > acceptance ) hi *= 2.0;
+    for(int i=0;i<100;i++){
+      RealD mid = 0.5*(lo+hi);
+      if ( std::erfc(std::sqrt(mid)/2.0) > acceptance ) lo = mid;
+      else hi = mid;
+    }
+    return 2.0*lo;
+  }
+
+  // Call after each thermalisation trajectory, before the timers are reset
+  void Record(IntegratorType &Integrator, RealD dH)
+  {
+    if ( levels != Integrator.levels ) {
+      levels = Integrator.levels;
+      Reset();
+    }
+    order = Integrator.integrator_order();
+
+    RealD model = 0.0;
+    RealD nsteps = Integrator.Params.MDsteps;
+    for(int level=0;level<levels;level++){
+      nsteps *= Integrator.as[level].multiplier;
+      auto force = Integrator.LevelForces[level].actions.at(0);
+      RealD F = (force->deriv_num > 0) ? force->deriv_norm_average() : 0.0;
+      RealD h  = Integrator.step_size(level);
+      RealD Fh = F*std::pow(h,order);
+      nest[level] = h*nsteps/Integrator.Params.trajL;
+      model += Fh*Fh;
+      sum_force[level] += F;
+      for(int a=0;a<Integrator.as[level].actions.size();a++){
+	force_us[level] += Integrator.as[level].actions.at(a)->deriv_us;
+      }
+      force_num[level] += force->deriv_num;
+      steps[level]     += nsteps;
+    }
+    update_U_us  += Integrator.update_U_us;
+    update_U_num += Integrator.update_U_num;
+    steps_U      += nsteps;
+
+    sum_dH2   += dH*dH;
+    sum_model += model;
+    samples++;
+
+    std::cout << GridLogHMC << "IntegratorStepTuner: trajectory "<<samples<<" dH "<<dH
+	      << " model/kappa "<<model<<std::endl;
+
+    if ( (samples % Params.RoundLength) == 0 ) Tune(Integrator);
+  }
+
+  // Ratio estimator; dH^2 is kappa*model times a chi-squared like variable
+  RealD Kappa(void) { return sum_dH2/sum_model; }
+
+  void Tune(IntegratorType &Integrator)
+  {
+    if ( sum_model <= 0.0 || sum_dH2 <= 0.0 ) return;
+
+    kappa  = Kappa();
+    target = TargetDeltaH2(Params.TargetAcceptance);
+    trajL  = Integrator.Params.trajL;
+    int   m0    = Integrator.as[0].multiplier;
+
+    // Measured per trajectory averages
+    F.resize(levels); cost.resize(levels); evals.resize(levels);
+    for(int level=0;level<levels;level++){
+      F[level]     = sum_force[level]/samples;
+      cost[level]  = (force_num[level] > 0) ? force_us[level]/force_num[level] : 0.0;
+      evals[level] = force_num[level]/steps[level];
+    }
+    cost_U  = (update_U_num > 0) ? update_U_us/update_U_num : 0.0;
+    evals_U = update_U_num/steps_U;
+
+    best_MDsteps = 0;
+    mult.assign(levels,1);
+    best.assign(levels,1);
+    for(int n=1;n<=Params.MaxMDsteps;n++){
+      RealD h  = nest[0]*trajL/(n*m0);
+      RealD Fh = F[0]*std::pow(h,order);
+      Search(1,n,n*m0,Fh*Fh,cost[0]*evals[0]*n*m0);
+    }
+
+    if ( best_MDsteps == 0 ) {
+      std::cout << GridLogHMC << "IntegratorStepTuner: no step sizes within limits reach acceptance "
+		<< Params.TargetAcceptance << "; keeping MDsteps "<<Integrator.Params.MDsteps<<std::endl;
+      return;
+    }
+
+    std::cout << GridLogHMC << "IntegratorStepTuner: kappa "<<kappa<<" from "<<samples<<" trajectories"
+	      << ", target <dH^2> "<<target<<std::endl;
+    std::cout << GridLogHMC << "IntegratorStepTuner: MDsteps "<<best_MDsteps;
+    for(int level=1;level<levels;level++) std::cout << " multiplier["<<level<<"] "<<best[level];
+    std::cout << " predicted cost "<<best_cost*1.0e-6<<" s"<<std::endl;
+
+    Integrator.set_steps(best_MDsteps,best);
+  }
+
+private:
+  // Inputs and result of the search
+  RealD kappa, target, trajL, cost_U, evals_U, best_cost;
+  std::vector<RealD> F, cost, evals;
+  std::vector<int> mult, best;
+  int best_MDsteps;
+
+  // Depth first over the inner multipliers; model is sum (F_l h_l^p)^2 and
+  // cost_so_far the force cost of the levels above this one
+  void Search(int level,int n,RealD nsteps,RealD model,RealD cost_so_far)
+  {
+    if ( best_MDsteps && cost_so_far >= best_cost ) return;
+    if ( level == levels ) {
+      RealD total = cost_so_far + cost_U*evals_U*nsteps;
+      if ( kappa*model <= target && (best_MDsteps==0 || total < best_cost) ) {
+	best_cost    = total;
+	best         = mult;
+	best_MDsteps = n;
+      }
+      return;
+    }
+    for(int m=1;m<=Params.MaxMultiplier;m++){
+      mult[level] = m;
+      RealD hl = nest[level]*trajL/(nsteps*m);
+      RealD Fh = F[level]*std::pow(hl,order);
+      Search(level+1,n,nsteps*m,model+Fh*Fh,cost_so_far+cost[level]*evals[level]*nsteps*m);
+    }
+    mult[level] = 1;
+  }
+};
+
+NAMESPACE_END(Grid);
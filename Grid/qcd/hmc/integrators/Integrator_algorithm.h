@@ -112,8 +112,7 @@ public:
     // eps    : current step size
 
     // Get current level step size
-    RealD eps = this->Params.trajL/this->Params.MDsteps;
-    for (int l = 0; l <= level; ++l) eps /= this->as[l].multiplier;
+    RealD eps = this->step_size(level);
 
     int multiplier = this->as[level].multiplier;
     for (int e = 0; e < multiplier; ++e) {
@@ -151,6 +150,13 @@ public:
 
   std::string integrator_name(){return "MininumNorm2";}
 
+  // Each step updates U twice, so the next level starts at eps/2/multiplier
+  RealD step_size(int level) {
+    RealD eps = this->Params.trajL/this->Params.MDsteps * 2.0;
+    for (int l = 0; l <= level; ++l) eps /= 2.0 * this->as[l].multiplier;
+    return eps;
+  }
+
   void step(Field& U, int level, int _first, int _last) {
     // level  : current level
     // fl     : final level
@@ -158,8 +164,7 @@ public:
 
     int fl = this->as.size() - 1;
 
-    RealD eps = this->Params.trajL/this->Params.MDsteps * 2.0;
-    for (int l = 0; l <= level; ++l) eps /= 2.0 * this->as[l].multiplier;
+    RealD eps = this->step_size(level);
 
     // Nesting:  2xupdate_U of size eps/2
     // Next level is eps/2/multiplier
@@ -215,6 +220,14 @@ public:
 									    grid, Par, Aset, Sm){};
 
   std::string integrator_name(){return "ForceGradient";}
+  int integrator_order(){return 4;}
+
+  // As MinimumNorm2, the next level starts at eps/2/multiplier
+  RealD step_size(int level) {
+    RealD eps = this->Params.trajL/this->Params.MDsteps * 2.0;
+    for (int l = 0; l <= level; ++l) eps /= 2.0 * this->as[l].multiplier;
+    return eps;
+  }
   
   void FG_update_P(Field& U, int level, double fg_dt, double ep) {
     Field Ufg(U.Grid());
@@ -237,8 +250,7 @@ public:
   }
 
   void step(Field& U, int level, int _first, int _last) {
-    RealD eps = this->Params.trajL/this->Params.MDsteps * 2.0;
-    for (int l = 0; l <= level; ++l) eps /= 2.0 * this->as[l].multiplier;
+    RealD eps = this->step_size(level);
 
     RealD Chi = chi * eps * eps * eps;
 
@@ -275,6 +287,146 @@ public:
   }
 };
 
+/* Force gradient without the extra force evaluation.
+ *
+ * The force gradient update evaluates the force at U shifted by
+ * dt^3/(24 eps) ~ eps^2 times the force at U, so the shift only needs
+ * the force at U to O(eps^2) to keep the fourth order. It is linearly
+ * extrapolated from the last two forces on the same level: the update at
+ * the start of the step and the previous force gradient update, which
+ * being evaluated at a shifted field is itself within O(eps^2). Kicks of
+ * any level between them bend the trajectory by O(eps^2) only. On the
+ * first step of a trajectory the force at U is evaluated as in
+ * ForceGradient; after that each level costs two force evaluations per
+ * step rather than three.
+ *
+ * The shift now depends on earlier fields, so the integrator is
+ * reversible and area preserving only up to the same O(eps^4) as dH,
+ * not exactly. Check the reversibility violation against the
+ * statistical error before using it under a Metropolis test; HMC warns
+ * when it is. It is deliberately not registered as an HMC module.
+ */
+template <class FieldImplementation_, class SmearingPolicy, class RepresentationPolicy = Representations<FundamentalRepresentation> >
+class CachedForceGradient : public Integrator<FieldImplementation_, SmearingPolicy, RepresentationPolicy> 
+{
+public:
+  typedef FieldImplementation_ FieldImplementation;
+  INHERIT_FIELD_TYPES(FieldImplementation);
+
+private:
+  const RealD lambda = 1.0 / 6.0;
+  const RealD chi = 1.0 / 72.0;
+
+  // Last two momentum rates dP/dt = -F on each level, at link time t
+  struct CachedForce {
+    Field Pdot;
+    RealD t;
+    bool  valid;
+    CachedForce(GridBase *grid) : Pdot(grid), t(0.0), valid(false) {};
+  };
+  std::vector<std::vector<CachedForce> > cache;
+
+  // update_P, keeping the rate of change of the momentum
+  void cached_update_P(Field& U, int level, double ep) {
+    Field Pold = this->P;
+    this->update_P(U, level, ep);
+
+    std::swap(cache[level][0], cache[level][1]);
+    CachedForce &c = cache[level][1];
+    c.Pdot  = (this->P - Pold) * (1.0 / ep);
+    c.t     = this->t_U;
+    c.valid = true;
+  }
+
+  void FG_update_P(Field& U, int level, double fg_dt, double ep) {
+    Field Ufg(U.Grid());
+    Field Pfg(U.Grid());
+    Ufg = U;
+
+    CachedForce &c0 = cache[level][0];
+    CachedForce &c1 = cache[level][1];
+    if ( c0.valid && c1.valid && c1.t > c0.t ) {
+      RealD w = (this->t_U - c1.t) / (c1.t - c0.t);
+      std::cout << GridLogIntegrator << "FG update " << fg_dt << " " << ep << " extrapolated, w = " << w << std::endl;
+      Pfg = c1.Pdot + (c1.Pdot - c0.Pdot) * w;
+    } else {
+      std::cout << GridLogIntegrator << "FG update " << fg_dt << " " << ep << std::endl;
+      Pfg = Zero();
+      this->update_P(Pfg, Ufg, level, fg_dt);
+      Pfg = Pfg * (1.0 / fg_dt);
+    }
+    this->update_U(Pfg, Ufg, fg_dt);
+    cached_update_P(Ufg, level, ep);
+  }
+
+public:
+  CachedForceGradient(GridBase* grid, IntegratorParameters Par,
+		      ActionSet<Field, RepresentationPolicy>& Aset,
+		      SmearingPolicy& Sm)
+    : Integrator<FieldImplementation, SmearingPolicy, RepresentationPolicy>(grid, Par, Aset, Sm)
+  {
+    cache.resize(this->levels);
+    for (int level = 0; level < this->levels; ++level) {
+      cache[level].push_back(CachedForce(grid));
+      cache[level].push_back(CachedForce(grid));
+    }
+  };
+
+  std::string integrator_name(){return "CachedForceGradient";}
+  int integrator_order(){return 4;}
+  bool exactly_reversible(){return false;}
+
+  // As ForceGradient, the next level starts at eps/2/multiplier
+  RealD step_size(int level) {
+    RealD eps = this->Params.trajL/this->Params.MDsteps * 2.0;
+    for (int l = 0; l <= level; ++l) eps /= 2.0 * this->as[l].multiplier;
+    return eps;
+  }
+
+  void step(Field& U, int level, int _first, int _last) {
+    if ( level == 0 && _first ) {  // new trajectory
+      for (int l = 0; l < this->levels; ++l) {
+	cache[l][0].valid = cache[l][1].valid = false;
+      }
+    }
+
+    RealD eps = this->step_size(level);
+
+    RealD Chi = chi * eps * eps * eps;
+
+    int fl = this->as.size() - 1;
+
+    int multiplier = this->as[level].multiplier;
+
+    for (int e = 0; e < multiplier; ++e) {  // steps per step
+
+      int first_step = _first && (e == 0);
+      int last_step = _last && (e == multiplier - 1);
+
+      if (first_step) {  // initial half step
+        this->cached_update_P(U, level, lambda * eps);
+      }
+
+      if (level == fl) {  // lowest level
+        this->update_U(U, 0.5 * eps);
+      } else {  // recursive function call
+        this->step(U, level + 1, first_step, 0);
+      }
+
+      this->FG_update_P(U, level, 2 * Chi / ((1.0 - 2.0 * lambda) * eps), (1.0 - 2.0 * lambda) * eps);
+
+      if (level == fl) {  // lowest level
+        this->update_U(U, 0.5 * eps);
+      } else {  // recursive function call
+        this->step(U, level + 1, 0, last_step);
+      }
+
+      int mm = (last_step) ? 1 : 2;
+      this->cached_update_P(U, level, lambda * eps * mm);
+    }
+  }
+};
+
 NAMESPACE_END(Grid);
 
 #endif  // INTEGRATOR_INCLUDED
@@ -52,6 +52,7 @@ protected:
   const unsigned int smearingLevels;
   Smear_Stout<Gimpl> *StoutSmearing;
   std::vector<GaugeField> SmearedSet;
+  std::vector<GaugeField> SmearedStaples; // staples of each level, empty unless CacheStaples
 public:
   GaugeField*  ThinLinks; /* Pointer to the thin links configuration */ // move to base???
 protected:
@@ -78,7 +79,11 @@ protected:
       previous_u = *ThinLinks;
       for (int smearLvl = 0; smearLvl < smearingLevels; ++smearLvl)
       {
-        StoutSmearing->smear(SmearedSet[smearLvl], previous_u);
+        if ( SmearedStaples.size() ) {
+          StoutSmearing->smear(SmearedSet[smearLvl], SmearedStaples[smearLvl], previous_u);
+        } else {
+          StoutSmearing->smear(SmearedSet[smearLvl], previous_u);
+        }
         previous_u = SmearedSet[smearLvl];
 
         // For debug purposes
@@ -93,26 +98,46 @@ protected:
   virtual GaugeField AnalyticSmearedForce(const GaugeField& SigmaKPrime,
 					  const GaugeField& GaugeK) const 
   {
-    GridBase* grid = GaugeK.Grid();
-    GaugeField C(grid), SigmaK(grid), iLambda(grid);
-    GaugeLinkField iLambda_mu(grid);
-    GaugeLinkField iQ(grid), e_iQ(grid);
-    GaugeLinkField SigmaKPrime_mu(grid);
-    GaugeLinkField GaugeKmu(grid), Cmu(grid);
-
+    GaugeField C(GaugeK.Grid());
     StoutSmearing->BaseSmear(C, GaugeK);
-    SigmaK = Zero();
-    iLambda = Zero();
+    return AnalyticSmearedForce(SigmaKPrime, GaugeK, C);
+  }
+
+  // Staples C of this level supplied, e.g. kept from fill_smearedSet
+  GaugeField AnalyticSmearedForce(const GaugeField& SigmaKPrime,
+				  const GaugeField& GaugeK,
+				  const GaugeField& C) const 
+  {
+    GridBase* grid = GaugeK.Grid();
+    const int Nsimd = grid->Nsimd();
+    GaugeField SigmaK(grid), iLambda(grid);
 
-    for (int mu = 0; mu < Nd; mu++)
+    // Sigma_K and iLambda for all directions in one site kernel
     {
-      Cmu = peekLorentz(C, mu);
-      GaugeKmu = peekLorentz(GaugeK, mu);
-      SigmaKPrime_mu = peekLorentz(SigmaKPrime, mu);
-      iQ = Ta(Cmu * adj(GaugeKmu));
-      set_iLambda(iLambda_mu, e_iQ, iQ, SigmaKPrime_mu, GaugeKmu);
-      pokeLorentz(SigmaK, SigmaKPrime_mu * e_iQ + adj(Cmu) * iLambda_mu, mu);
-      pokeLorentz(iLambda, iLambda_mu, mu);
+      autoView(U_v, GaugeK, AcceleratorRead);
+      autoView(C_v, C, AcceleratorRead);
+      autoView(P_v, SigmaKPrime, AcceleratorRead);
+      autoView(S_v, SigmaK, AcceleratorWrite);
+      autoView(L_v, iLambda, AcceleratorWrite);
+      accelerator_for(ss, grid->oSites(), Nsimd, {
+#ifdef GRID_SIMT
+	{
+	  auto S  = coalescedRead(P_v[ss]);
+	  auto iL = S;
+	  StoutForceSite(coalescedRead(U_v[ss]), coalescedRead(C_v[ss]), coalescedRead(P_v[ss]), S, iL);
+	  coalescedWrite(S_v[ss], S);
+	  coalescedWrite(L_v[ss], iL);
+	}
+#else
+	for(int lane=0;lane<Nsimd;lane++){
+	  auto S  = extractLane(lane,P_v[ss]);
+	  auto iL = S;
+	  StoutForceSite(extractLane(lane,U_v[ss]), extractLane(lane,C_v[ss]), extractLane(lane,P_v[ss]), S, iL);
+	  insertLane(lane, S_v[ss], S);
+	  insertLane(lane, L_v[ss], iL);
+	}
+#endif
+      });
     }
     StoutSmearing->derivative(SigmaK, iLambda,
                              GaugeK);  // derivative of SmearBase
@@ -126,96 +151,37 @@ protected:
   }
 
   //====================================================================
+  // exp(iQ) and iLambda in one site kernel, see StoutLambda
   void set_iLambda(GaugeLinkField& iLambda, GaugeLinkField& e_iQ,
                    const GaugeLinkField& iQ, const GaugeLinkField& Sigmap,
                    const GaugeLinkField& GaugeK) const 
   {
     GridBase* grid = iQ.Grid();
-    GaugeLinkField iQ2(grid), iQ3(grid), B1(grid), B2(grid), USigmap(grid);
-    GaugeLinkField unity(grid);
-    unity = 1.0;
-
-    LatticeComplex u(grid), w(grid);
-    LatticeComplex f0(grid), f1(grid), f2(grid);
-    LatticeComplex xi0(grid), xi1(grid), tmp(grid);
-    LatticeComplex u2(grid), w2(grid), cosw(grid);
-    LatticeComplex emiu(grid), e2iu(grid), qt(grid), fden(grid);
-    LatticeComplex r01(grid), r11(grid), r21(grid), r02(grid), r12(grid);
-    LatticeComplex r22(grid), tr1(grid), tr2(grid);
-    LatticeComplex b10(grid), b11(grid), b12(grid), b20(grid), b21(grid),
-      b22(grid);
-    LatticeComplex LatticeUnitComplex(grid);
-
-    LatticeUnitComplex = 1.0;
-
-    // Exponential
-    iQ2 = iQ * iQ;
-    iQ3 = iQ * iQ2;
-    StoutSmearing->set_uw(u, w, iQ2, iQ3);
-    StoutSmearing->set_fj(f0, f1, f2, u, w);
-    e_iQ = f0 * unity + timesMinusI(f1) * iQ - f2 * iQ2;
-
-    // Getting B1, B2, Gamma and Lambda
-    // simplify this part, reduntant calculations in set_fj
-    xi0 = StoutSmearing->func_xi0(w);
-    xi1 = StoutSmearing->func_xi1(w);
-    u2 = u * u;
-    w2 = w * w;
-    cosw = cos(w);
-
-    emiu = cos(u) - timesI(sin(u));
-    e2iu = cos(2.0 * u) + timesI(sin(2.0 * u));
-
-    r01 = (2.0 * u + timesI(2.0 * (u2 - w2))) * e2iu +
-      emiu * ((16.0 * u * cosw + 2.0 * u * (3.0 * u2 + w2) * xi0) +
-	      timesI(-8.0 * u2 * cosw + 2.0 * (9.0 * u2 + w2) * xi0));
-
-    r11 = (2.0 * LatticeUnitComplex + timesI(4.0 * u)) * e2iu +
-      emiu * ((-2.0 * cosw + (3.0 * u2 - w2) * xi0) +
-	      timesI((2.0 * u * cosw + 6.0 * u * xi0)));
-
-    r21 =
-      2.0 * timesI(e2iu) + emiu * (-3.0 * u * xi0 + timesI(cosw - 3.0 * xi0));
-
-    r02 = -2.0 * e2iu +
-      emiu * (-8.0 * u2 * xi0 +
-	      timesI(2.0 * u * (cosw + xi0 + 3.0 * u2 * xi1)));
-
-    r12 = emiu * (2.0 * u * xi0 + timesI(-cosw - xi0 + 3.0 * u2 * xi1));
-
-    r22 = emiu * (xi0 - timesI(3.0 * u * xi1));
-
-    fden = LatticeUnitComplex / (2.0 * (9.0 * u2 - w2) * (9.0 * u2 - w2));
-
-    b10 = 2.0 * u * r01 + (3.0 * u2 - w2) * r02 - (30.0 * u2 + 2.0 * w2) * f0;
-    b11 = 2.0 * u * r11 + (3.0 * u2 - w2) * r12 - (30.0 * u2 + 2.0 * w2) * f1;
-    b12 = 2.0 * u * r21 + (3.0 * u2 - w2) * r22 - (30.0 * u2 + 2.0 * w2) * f2;
-
-    b20 = r01 - (3.0 * u) * r02 - (24.0 * u) * f0;
-    b21 = r11 - (3.0 * u) * r12 - (24.0 * u) * f1;
-    b22 = r21 - (3.0 * u) * r22 - (24.0 * u) * f2;
-
-    b10 *= fden;
-    b11 *= fden;
-    b12 *= fden;
-    b20 *= fden;
-    b21 *= fden;
-    b22 *= fden;
-
-    B1 = b10 * unity + timesMinusI(b11) * iQ - b12 * iQ2;
-    B2 = b20 * unity + timesMinusI(b21) * iQ - b22 * iQ2;
-    USigmap = GaugeK * Sigmap;
-
-    tr1 = trace(USigmap * B1);
-    tr2 = trace(USigmap * B2);
-
-    GaugeLinkField QUS = iQ * USigmap;
-    GaugeLinkField USQ = USigmap * iQ;
-
-    GaugeLinkField iGamma = tr1 * iQ - timesI(tr2) * iQ2 +
-      timesI(f1) * USigmap + f2 * QUS + f2 * USQ;
-
-    iLambda = Ta(iGamma);
+    const int Nsimd = grid->Nsimd();
+    autoView(iQ_v, iQ, AcceleratorRead);
+    autoView(S_v, Sigmap, AcceleratorRead);
+    autoView(U_v, GaugeK, AcceleratorRead);
+    autoView(L_v, iLambda, AcceleratorWrite);
+    autoView(e_v, e_iQ, AcceleratorWrite);
+    accelerator_for(ss, grid->oSites(), Nsimd, {
+#ifdef GRID_SIMT
+      {
+	auto e  = coalescedRead(iQ_v[ss]);
+	auto iL = e;
+	StoutLambda(coalescedRead(iQ_v[ss]), coalescedRead(U_v[ss]), coalescedRead(S_v[ss]), e, iL);
+	coalescedWrite(e_v[ss], e);
+	coalescedWrite(L_v[ss], iL);
+      }
+#else
+      for(int lane=0;lane<Nsimd;lane++){
+	auto e  = extractLane(lane,iQ_v[ss]);
+	auto iL = e;
+	StoutLambda(extractLane(lane,iQ_v[ss]), extractLane(lane,U_v[ss]), extractLane(lane,S_v[ss]), e, iL);
+	insertLane(lane, e_v[ss], e);
+	insertLane(lane, L_v[ss], iL);
+      }
+#endif
+    });
   }
 
   //====================================================================
@@ -230,6 +196,19 @@ public:
       SmearedSet.push_back(*(new GaugeField(UGrid)));
   }
 
+  /*! Keep the staples of every level from smearing for reuse in the
+      force; trades one gauge field per level for a staple evaluation.
+      If a field is already attached it is resmeared to fill the cache */
+  void CacheStaples(bool cache)
+  {
+    SmearedStaples.clear();
+    if ( cache ) {
+      for (unsigned int i = 0; i < smearingLevels; ++i)
+        SmearedStaples.push_back(GaugeField(SmearedSet[i].Grid()));
+      if ( ThinLinks != NULL ) fill_smearedSet(*ThinLinks);
+    }
+  }
+
   /*! For just thin links */
   SmearedConfiguration()
     : smearingLevels(0), StoutSmearing(nullptr), SmearedSet(), ThinLinks(NULL) {}
@@ -260,10 +239,17 @@ public:
         pokeLorentz(force, tmp_mu, mu);
       }
 
-      for (int ismr = smearingLevels - 1; ismr > 0; --ismr)
-        force = AnalyticSmearedForce(force, get_smeared_conf(ismr - 1));
+      if ( SmearedStaples.size() ) {
+        for (int ismr = smearingLevels - 1; ismr > 0; --ismr)
+          force = AnalyticSmearedForce(force, get_smeared_conf(ismr - 1), SmearedStaples[ismr]);
+
+        force = AnalyticSmearedForce(force, *ThinLinks, SmearedStaples[0]);
+      } else {
+        for (int ismr = smearingLevels - 1; ismr > 0; --ismr)
+          force = AnalyticSmearedForce(force, get_smeared_conf(ismr - 1));
 
-      force = AnalyticSmearedForce(force, *ThinLinks);
+        force = AnalyticSmearedForce(force, *ThinLinks);
+      }
 
       for (int mu = 0; mu < Nd; mu++)
       {
@@ -35,6 +35,164 @@
 
 NAMESPACE_BEGIN(Grid);
 
+//////////////////////////////////////////////////////////////////////////////
+// Site local Cayley-Hamilton exponential of su(3), hep-lat/0311018.
+// For traceless anti-hermitian iQ with Q = -i iQ,
+//   c0 = det Q,  c1 = tr Q^2 / 2,  exp(iQ) = f0 + f1 Q + f2 Q^2
+// and b1j = df_j/dc1, b2j = df_j/dc0 (eqs 57-58) give the force.
+// Everything lives in registers; no lattice temporaries.
+//////////////////////////////////////////////////////////////////////////////
+accelerator_inline void StoutCoefficients(RealD c0,RealD c1,ComplexD *f,ComplexD *b1,ComplexD *b2)
+{
+  const ComplexD I(0.0,1.0);
+
+  // Q -> 0 limit of the expansion, where 9u^2-w^2 vanishes
+  if ( c1 < 1.0e-10 ) {
+    f[0] = 1.0 - I*(c0/6.0);
+    f[1] = I*(1.0 - c1/6.0);
+    f[2] = -0.5 + c1/24.0;
+    if ( b1 ) {
+      b1[0] = 0.0;     b1[1] = -I/6.0; b1[2] = 1.0/24.0;
+      b2[0] = -I/6.0;  b2[1] = 1.0/24.0; b2[2] = I/120.0;
+    }
+    return;
+  }
+
+  RealD c0max = 2.0*pow(c1/3.0,1.5);
+  RealD ratio = c0/c0max;
+  ratio = (ratio > 1.0) ? 1.0 : ((ratio < -1.0) ? -1.0 : ratio);
+  RealD theta = acos(ratio)/3.0;
+  RealD u = sqrt(c1/3.0)*cos(theta);
+  RealD w = sqrt(c1)*sin(theta);
+
+  RealD u2 = u*u;
+  RealD w2 = w*w;
+  RealD cosw = cos(w);
+  RealD xi0, xi1;
+  if ( w < 0.05 ) { // w >= 0 as theta is in [0,pi/3]
+    xi0 = 1.0 - w2/6.0*(1.0 - w2/20.0*(1.0 - w2/42.0));
+    xi1 = -(1.0 - w2/10.0*(1.0 - w2/28.0*(1.0 - w2/54.0)))/3.0;
+  } else {
+    xi0 = sin(w)/w;
+    xi1 = cos(w)/w2 - sin(w)/(w2*w);
+  }
+
+  ComplexD emiu(cos(u),-sin(u));
+  ComplexD e2iu(cos(2.0*u),sin(2.0*u));
+
+  ComplexD h0 = e2iu*(u2-w2) + emiu*(8.0*u2*cosw + I*(2.0*u*(3.0*u2+w2)*xi0));
+  ComplexD h1 = e2iu*(2.0*u) - emiu*(2.0*u*cosw - I*((3.0*u2-w2)*xi0));
+  ComplexD h2 = e2iu - emiu*(cosw + I*(3.0*u*xi0));
+
+  RealD fden = 1.0/(9.0*u2-w2);
+  f[0] = h0*fden;
+  f[1] = h1*fden;
+  f[2] = h2*fden;
+
+  if ( b1 ) {
+    ComplexD r01 = (2.0*u + I*(2.0*(u2-w2)))*e2iu
+      + emiu*((16.0*u*cosw + 2.0*u*(3.0*u2+w2)*xi0) + I*(-8.0*u2*cosw + 2.0*(9.0*u2+w2)*xi0));
+    ComplexD r11 = (2.0 + I*(4.0*u))*e2iu
+      + emiu*((-2.0*cosw + (3.0*u2-w2)*xi0) + I*(2.0*u*cosw + 6.0*u*xi0));
+    ComplexD r21 = 2.0*I*e2iu + emiu*(-3.0*u*xi0 + I*(cosw - 3.0*xi0));
+    ComplexD r02 = -2.0*e2iu + emiu*(-8.0*u2*xi0 + I*(2.0*u*(cosw + xi0 + 3.0*u2*xi1)));
+    ComplexD r12 = emiu*(2.0*u*xi0 + I*(-cosw - xi0 + 3.0*u2*xi1));
+    ComplexD r22 = emiu*(xi0 - I*(3.0*u*xi1));
+
+    RealD bden = 1.0/(2.0*(9.0*u2-w2)*(9.0*u2-w2));
+    b1[0] = (2.0*u*r01 + (3.0*u2-w2)*r02 - (30.0*u2+2.0*w2)*f[0])*bden;
+    b1[1] = (2.0*u*r11 + (3.0*u2-w2)*r12 - (30.0*u2+2.0*w2)*f[1])*bden;
+    b1[2] = (2.0*u*r21 + (3.0*u2-w2)*r22 - (30.0*u2+2.0*w2)*f[2])*bden;
+    b2[0] = (r01 - (3.0*u)*r02 - (24.0*u)*f[0])*bden;
+    b2[1] = (r11 - (3.0*u)*r12 - (24.0*u)*f[1])*bden;
+    b2[2] = (r21 - (3.0*u)*r22 - (24.0*u)*f[2])*bden;
+  }
+}
+
+// f0 + f1 Q + f2 Q^2 written in terms of iQ
+template<class cmat>
+accelerator_inline cmat StoutPolynomial(const ComplexD *f,const cmat &iQ,const cmat &iQ2)
+{
+  typedef typename cmat::scalar_type scalar;
+  const ComplexD I(0.0,1.0);
+  cmat ret;
+  ret = scalar(f[0]);
+  ret = ret + scalar(-I*f[1])*iQ - scalar(f[2])*iQ2;
+  return ret;
+}
+
+template<class cmat>
+accelerator_inline void StoutInvariants(const cmat &iQ,cmat &iQ2,RealD &c0,RealD &c1)
+{
+  iQ2 = iQ*iQ;
+  cmat iQ3 = iQ*iQ2;
+  c0 = -imag(TensorRemove(trace(iQ3)))/3.0; // sign from the conventions on Ta
+  c1 = -real(TensorRemove(trace(iQ2)))/2.0;
+}
+
+// exp(iQ) for one site
+template<class cmat>
+accelerator_inline cmat StoutExponentiate(const cmat &iQ)
+{
+  cmat iQ2;
+  RealD c0,c1;
+  ComplexD f[3];
+  StoutInvariants(iQ,iQ2,c0,c1);
+  StoutCoefficients(c0,c1,f,nullptr,nullptr);
+  return StoutPolynomial(f,iQ,iQ2);
+}
+
+// exp(iQ) and iLambda = Ta(iGamma) of eq 74 for one site, Sigmap the force from the level above
+template<class cmat>
+accelerator_inline void StoutLambda(const cmat &iQ,const cmat &U,const cmat &Sigmap,cmat &e_iQ,cmat &iLambda)
+{
+  typedef typename cmat::scalar_type scalar;
+  const ComplexD I(0.0,1.0);
+  cmat iQ2;
+  RealD c0,c1;
+  ComplexD f[3], b1[3], b2[3];
+  StoutInvariants(iQ,iQ2,c0,c1);
+  StoutCoefficients(c0,c1,f,b1,b2);
+
+  e_iQ = StoutPolynomial(f,iQ,iQ2);
+  cmat B1 = StoutPolynomial(b1,iQ,iQ2);
+  cmat B2 = StoutPolynomial(b2,iQ,iQ2);
+
+  cmat USigmap = U*Sigmap;
+  scalar tr1 = TensorRemove(trace(USigmap*B1));
+  scalar tr2 = TensorRemove(trace(USigmap*B2));
+
+  cmat iGamma = tr1*iQ - (scalar(I)*tr2)*iQ2 + scalar(I*f[1])*USigmap
+    + scalar(f[2])*(iQ*USigmap) + scalar(f[2])*(USigmap*iQ);
+  iLambda = Ta(iGamma);
+}
+
+// Smeared links exp(iQ_mu) U_mu of one site, iQ_mu = Ta(C_mu U_mu^dag)
+template<class sobj>
+accelerator_inline sobj StoutSmearSite(const sobj &U,const sobj &C,int orthog)
+{
+  sobj ret = U;
+  for(int mu=0;mu<Nd;mu++){
+    if ( mu==orthog ) continue;
+    auto iQ = Ta(C(mu)*adj(U(mu)));
+    ret(mu) = StoutExponentiate(iQ)*U(mu);
+  }
+  return ret;
+}
+
+// Sigma = Sigma' exp(iQ) + C^dag iLambda and iLambda of one site, eq 75
+template<class sobj>
+accelerator_inline void StoutForceSite(const sobj &U,const sobj &C,const sobj &SigmaP,sobj &Sigma,sobj &iLambda)
+{
+  for(int mu=0;mu<Nd;mu++){
+    auto iQ = Ta(C(mu)*adj(U(mu)));
+    decltype(iQ) e_iQ, iL;
+    StoutLambda(iQ,U(mu),SigmaP(mu),e_iQ,iL);
+    Sigma(mu)   = SigmaP(mu)*e_iQ + adj(C(mu))*iL;
+    iLambda(mu) = iL;
+  }
+}
+
 /*!  @brief Stout smearing of link variable. */
 template <class Gimpl>
 class Smear_Stout : public Smear<Gimpl> {
@@ -83,23 +241,33 @@ public:
 
   void smear(GaugeField& u_smr, const GaugeField& U) const {
     GaugeField C(U.Grid());
-    GaugeLinkField tmp(U.Grid()), iq_mu(U.Grid()), Umu(U.Grid());
+    smear(u_smr, C, U);
+  };
 
+  // Also returns the staples C, which the force at this level reuses
+  void smear(GaugeField& u_smr, GaugeField& C, const GaugeField& U) const {
     std::cout << GridLogDebug << "Stout smearing started\n";
 
     // C contains the staples multiplied by some rho
-    u_smr = U ; // set the smeared field to the current gauge field
     SmearBase->smear(C, U);
 
-    for (int mu = 0; mu < Nd; mu++) {
-      if( mu == OrthogDim ) continue ;
-      // u_smr = exp(iQ_mu)*U_mu apart from Orthogdim
-      Umu = peekLorentz(U, mu);
-      tmp = peekLorentz(C, mu);
-      iq_mu = Ta( tmp * adj(Umu));  
-      exponentiate_iQ(tmp, iq_mu);
-      pokeLorentz(u_smr, tmp * Umu, mu);
-    }
+    // u_smr = exp(iQ_mu)*U_mu apart from Orthogdim, one fused site kernel
+    GridBase *grid = U.Grid();
+    const int Nsimd = grid->Nsimd();
+    int orthog = OrthogDim;
+    u_smr.Checkerboard() = U.Checkerboard();
+    autoView(U_v, U, AcceleratorRead);
+    autoView(C_v, C, AcceleratorRead);
+    autoView(u_v, u_smr, AcceleratorWrite);
+    accelerator_for(ss, grid->oSites(), Nsimd, {
+#ifdef GRID_SIMT
+      coalescedWrite(u_v[ss], StoutSmearSite(coalescedRead(U_v[ss]), coalescedRead(C_v[ss]), orthog));
+#else
+      for(int lane=0;lane<Nsimd;lane++){
+	insertLane(lane, u_v[ss], StoutSmearSite(extractLane(lane,U_v[ss]), extractLane(lane,C_v[ss]), orthog));
+      }
+#endif
+    });
     std::cout << GridLogDebug << "Stout smearing completed\n";
   };
 
@@ -113,36 +281,26 @@ public:
   };
 
 
-  // Repetion of code here (use the Tensor_exp.h function)
+  // Only valid for SU(3). Computes exp(input matrix); the input is
+  // anti-hermitian, the i sign coming from outside.
   void exponentiate_iQ(GaugeLinkField& e_iQ, const GaugeLinkField& iQ) const {
-    // Put this outside
-    // only valid for SU(3) matrices
-
-    // only one Lorentz direction at a time
-
-    // notice that it actually computes
-    // exp ( input matrix )
-    // the i sign is coming from outside
-    // input matrix is anti-hermitian NOT hermitian
-
     GridBase* grid = iQ.Grid();
-    GaugeLinkField unity(grid);
-    unity = 1.0;
-
-    GaugeLinkField iQ2(grid), iQ3(grid);
-    LatticeComplex u(grid), w(grid);
-    LatticeComplex f0(grid), f1(grid), f2(grid);
-
-    iQ2 = iQ * iQ;
-    iQ3 = iQ * iQ2;
-
-    //We should check sgn(c0) here already and then apply eq (34) from 0311018
-    set_uw(u, w, iQ2, iQ3);
-    set_fj(f0, f1, f2, u, w);
-
-    e_iQ = f0 * unity + timesMinusI(f1) * iQ - f2 * iQ2;
+    const int Nsimd = grid->Nsimd();
+    e_iQ.Checkerboard() = iQ.Checkerboard();
+    autoView(iQ_v, iQ, AcceleratorRead);
+    autoView(e_v, e_iQ, AcceleratorWrite);
+    accelerator_for(ss, grid->oSites(), Nsimd, {
+#ifdef GRID_SIMT
+      coalescedWrite(e_v[ss], StoutExponentiate(coalescedRead(iQ_v[ss])));
+#else
+      for(int lane=0;lane<Nsimd;lane++){
+	insertLane(lane, e_v[ss], StoutExponentiate(extractLane(lane,iQ_v[ss])));
+      }
+#endif
+    });
   };
 
+  // Whole lattice building blocks of the exponential, kept for reference
   void set_uw(LatticeComplex& u, LatticeComplex& w, GaugeLinkField& iQ2,
               GaugeLinkField& iQ3) const {
     Complex one_over_three = 1.0 / 3.0;
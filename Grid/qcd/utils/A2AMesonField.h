@@ -0,0 +1,308 @@
+/*************************************************************************************
+
+    Grid physics library, www.github.com/paboyle/Grid
+
+    Source file: ./Grid/qcd/utils/A2AMesonField.h
+
+    Copyright (C) 2023
+
+Author: Peter Boyle <pboyle@bnl.gov>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+    See the full license in the file "LICENSE" in the top level distribution directory
+*************************************************************************************/
+/*  END LEGAL */
+#pragma once
+
+NAMESPACE_BEGIN(Grid);
+
+/////////////////////////////////////////////////////////////////////////////
+// GEMM based all-to-all meson fields
+//
+//   M(m,g,t,i,j) = sum_{x in t} exp(i p_m.x) w_i(x)^dag Gamma_g v_j(x)
+//
+// Same contraction and output layout as A2Autils::MesonField. The W and V
+// blocks are unpacked, SIMD lanes included, into column major
+// (slice sites . colour) x vector matrices, one per spin and local
+// timeslice. For each momentum the spin resolved products
+//
+//   S_{s1 s2}(t)_{ij} = sum_{x in t, c} conj(w_i(x,s2,c)) phase_m(x) v_j(x,s1,c)
+//
+// are a single batched GEMM of Ns*Ns*Lt matrices through GridBLAS
+// (cuBLAS/hipBLAS/oneMKL, Eigen on CPU). Gammas enter through the Ns x Ns
+// trace afterwards, so any number of gamma structures share the GEMM.
+//
+//   A2AMesonField<WilsonImplR> MF(grid,Tp,gammas,phases);
+//   MF(mat,&w[0],&v[0]);                       // one Lblock x Rblock block
+//   MF.Stream(w,v,blockSize,[&](const Block &b,int i0,int j0){ ... });
+//   MF.Stream(Hdf5Writer,"mf",w,v,blockSize);  // chunked dataset, async writes
+/////////////////////////////////////////////////////////////////////////////
+template<class FImpl>
+class A2AMesonField
+{
+public:
+  typedef typename FImpl::ComplexField ComplexField;
+  typedef typename FImpl::FermionField FermionField;
+  typedef typename FImpl::SiteSpinor vobj;
+  typedef typename vobj::scalar_object sobj;
+  typedef typename vobj::scalar_type scalar;
+  typedef Eigen::Tensor<ComplexD,5,Eigen::RowMajor> Block;
+
+  GridBase *grid;
+  int orthogdim;
+  std::vector<Gamma::Algebra> gammas;
+  const std::vector<ComplexField> &mom;
+
+  int Nt;      // global extent in orthogdim
+  int Lt;      // local extent in orthogdim
+  int Nslice;  // local sites per timeslice
+  int Ncol;    // internal components per spin
+  int Kc;      // GEMM depth: Nslice*Ncol
+
+  double t_pack, t_gemm, t_trace, t_gsum;
+
+private:
+  ComplexField Unit;
+  deviceVector<uint64_t> Slot;   // (osite,lane) -> lt*Nslice + site in slice
+  deviceVector<scalar>   BLAS_W; // Ns x Lt x Lblock x Kc
+  deviceVector<scalar>   BLAS_V; // Ns x Lt x Rblock x Kc
+  deviceVector<scalar>   BLAS_S; // Nmom x Ns x Ns x Lt x Lblock x Rblock
+  std::vector<ComplexD>  GammaMat; // Ngamma x Ns x Ns
+
+public:
+
+  A2AMesonField(GridBase *_grid,int _orthogdim,
+		const std::vector<Gamma::Algebra> &_gammas,
+		const std::vector<ComplexField> &_mom) :
+    grid(_grid),
+    orthogdim(_orthogdim),
+    gammas(_gammas),
+    mom(_mom),
+    Unit(_grid)
+  {
+    const int Nsimd = grid->Nsimd();
+    Nt     = grid->GlobalDimensions()[orthogdim];
+    Lt     = grid->LocalDimensions()[orthogdim];
+    Nslice = grid->lSites()/Lt;
+    Ncol   = sizeof(sobj)/sizeof(scalar)/Ns;
+    Kc     = Nslice*Ncol;
+    Unit   = scalar(1.0);
+    for(int m=0;m<mom.size();m++) conformable(grid,mom[m].Grid());
+
+    // Where each scalar site lands in the packed matrices
+    std::vector<uint64_t> slot(grid->lSites());
+    std::vector<int> count(Lt,0);
+    Coordinate lcoor;
+    for(int lidx=0;lidx<grid->lSites();lidx++){
+      grid->LocalIndexToLocalCoor(lidx,lcoor);
+      int lt = lcoor[orthogdim];
+      slot[grid->oIndex(lcoor)*Nsimd+grid->iIndex(lcoor)] = lt*Nslice + count[lt]++;
+    }
+    Slot.resize(slot.size());
+    acceleratorCopyToDevice(&slot[0],&Slot[0],slot.size()*sizeof(uint64_t));
+
+    int Ngamma = gammas.size();
+    GammaMat.resize(Ngamma*Ns*Ns);
+    iSpinMatrix<ComplexD> unit; unit = ComplexD(1.0);
+    for(int g=0;g<Ngamma;g++){
+      iSpinMatrix<ComplexD> G = Gamma(gammas[g])*unit;
+      for(int s1=0;s1<Ns;s1++){
+      for(int s2=0;s2<Ns;s2++){
+	GammaMat[(g*Ns+s1)*Ns+s2] = G()(s1,s2)();
+      }}
+    }
+    t_pack=t_gemm=t_trace=t_gsum=0.0;
+  }
+
+  // Unpack nvec fields times a phase to Ns*Lt column major Kc x nvec matrices
+  void Pack(deviceVector<scalar> &buf,const FermionField *f,int nvec,const ComplexField &phase)
+  {
+    const int Nsimd = grid->Nsimd();
+    const uint64_t sites = grid->oSites()*Nsimd;
+    const int nsp=Ns, lt_n=Lt, ncol=Ncol, kc=Kc, nslice=Nslice;
+    buf.resize(Ns*Lt*nvec*Kc);
+    scalar   *buf_p  = &buf[0];
+    uint64_t *slot_p = &Slot[0];
+    autoView( p_v , phase, AcceleratorRead);
+    for(int i=0;i<nvec;i++){
+      conformable(grid,f[i].Grid());
+      autoView( f_v , f[i], AcceleratorRead);
+      accelerator_for(sl,sites,1,{
+	uint64_t ss   = sl/Nsimd;
+	int      lane = sl%Nsimd;
+	uint64_t dst  = slot_p[sl];
+	uint64_t lt   = dst/nslice;
+	uint64_t k    = dst%nslice;
+	scalar ph = TensorRemove(extractLane(lane,p_v[ss]));
+	sobj site = extractLane(lane,f_v[ss]);
+	scalar *site_p = (scalar *)&site;
+	for(int s=0;s<nsp;s++){
+	  scalar *col = buf_p + ((s*lt_n+lt)*nvec+i)*(uint64_t)kc + k*ncol;
+	  for(int c=0;c<ncol;c++){
+	    col[c] = ph*site_p[s*ncol+c];
+	  }
+	}
+      });
+    }
+  }
+
+  // One Lblock x Rblock block; mat is (Nmom,Ngamma,Nt,Lblock,Rblock)
+  template <typename TensorType>
+  void operator() (TensorType &mat,const FermionField *lhs_wi,const FermionField *rhs_vj)
+  {
+    int Nmom   = mom.size();
+    int Ngamma = gammas.size();
+    int Lblock = mat.dimension(3);
+    int Rblock = mat.dimension(4);
+    assert(mat.dimension(0) == Nmom);
+    assert(mat.dimension(1) == Ngamma);
+    assert(mat.dimension(2) == Nt);
+
+    int nbatch = Ns*Ns*Lt;
+    int LR     = Lblock*Rblock;
+
+    t_pack-=usecond();
+    Pack(BLAS_W,lhs_wi,Lblock,Unit);
+    BLAS_V.resize(Ns*Lt*Rblock*Kc);
+    BLAS_S.resize(Nmom*nbatch*LR);
+    t_pack+=usecond();
+
+    // Batch (s1,s2,lt) multiplies W(s2,lt)^dag V(s1,lt)
+    std::vector<scalar *> Wh(nbatch), Vh(nbatch), Sh(nbatch);
+    deviceVector<scalar *> Wd(nbatch), Vd(nbatch), Sd(nbatch);
+    for(int s1=0;s1<Ns;s1++){
+    for(int s2=0;s2<Ns;s2++){
+    for(int lt=0;lt<Lt;lt++){
+      int b = (s1*Ns+s2)*Lt+lt;
+      Wh[b] = &BLAS_W[(uint64_t)(s2*Lt+lt)*Lblock*Kc];
+      Vh[b] = &BLAS_V[(uint64_t)(s1*Lt+lt)*Rblock*Kc];
+    }}}
+    acceleratorCopyToDevice(&Wh[0],&Wd[0],nbatch*sizeof(scalar *));
+    acceleratorCopyToDevice(&Vh[0],&Vd[0],nbatch*sizeof(scalar *));
+
+    GridBLAS BLAS;
+    for(int m=0;m<Nmom;m++){
+      t_pack-=usecond();
+      Pack(BLAS_V,rhs_vj,Rblock,mom[m]);
+      t_pack+=usecond();
+
+      for(int b=0;b<nbatch;b++) Sh[b] = &BLAS_S[(uint64_t)(m*nbatch+b)*LR];
+      acceleratorCopyToDevice(&Sh[0],&Sd[0],nbatch*sizeof(scalar *));
+
+      t_gemm-=usecond();
+      BLAS.gemmBatched(GridBLAS_OP_C,GridBLAS_OP_N,
+		       Lblock,Rblock,Kc,
+		       scalar(1.0),
+		       Wd,Vd,
+		       scalar(0.0),
+		       Sd);
+      BLAS.synchronise();
+      t_gemm+=usecond();
+    }
+
+    // Gamma trace on the host, local timeslices only
+    t_trace-=usecond();
+    std::vector<scalar> S(BLAS_S.size());
+    acceleratorCopyFromDevice(&BLAS_S[0],&S[0],S.size()*sizeof(scalar));
+
+    mat.setZero();
+    int pc = grid->_processor_coor[orthogdim];
+    thread_for_collapse(3,m,Nmom,{
+    for(int g=0;g<Ngamma;g++){
+    for(int lt=0;lt<Lt;lt++){
+      int t = lt + pc*Lt;
+      const ComplexD *G = &GammaMat[g*Ns*Ns];
+      for(int i=0;i<Lblock;i++){
+      for(int j=0;j<Rblock;j++){
+	ComplexD tr(0.0);
+	for(int s1=0;s1<Ns;s1++){
+	for(int s2=0;s2<Ns;s2++){
+	  int b = (s1*Ns+s2)*Lt+lt;
+	  tr += ComplexD(S[(uint64_t)(m*nbatch+b)*LR + i + Lblock*j]) * G[s2*Ns+s1];
+	}}
+	mat(m,g,t,i,j) = tr;
+      }}
+    }}});
+    t_trace+=usecond();
+
+    t_gsum-=usecond();
+    grid->GlobalSumVector(&mat(0,0,0,0,0),Nmom*Ngamma*Nt*LR);
+    t_gsum+=usecond();
+  }
+
+  //////////////////////////////////////////////////////////////////////////
+  // Full N_w x N_v meson field in blockSize x blockSize blocks. Each block
+  // is handed to writeBlock(block,i0,j0) as soon as it is complete, so
+  // only one block is ever held.
+  //////////////////////////////////////////////////////////////////////////
+  template<class Callback>
+  void Stream(const std::vector<FermionField> &w,const std::vector<FermionField> &v,int blockSize,Callback &&writeBlock)
+  {
+    int Nw = w.size();
+    int Nv = v.size();
+    for(int i0=0;i0<Nw;i0+=blockSize){
+    for(int j0=0;j0<Nv;j0+=blockSize){
+      int Lblock = std::min(blockSize,Nw-i0);
+      int Rblock = std::min(blockSize,Nv-j0);
+      Block block(mom.size(),gammas.size(),Nt,Lblock,Rblock);
+      (*this)(block,&w[i0],&v[j0]);
+      writeBlock(block,i0,j0);
+    }}
+    std::cout << GridLogPerformance << "A2AMesonField "<<Nw<<" x "<<Nv
+	      << " pack "<<t_pack/1.0e6<<" s gemm "<<t_gemm/1.0e6
+	      << " s trace "<<t_trace/1.0e6<<" s gsum "<<t_gsum/1.0e6<<" s"<<std::endl;
+  }
+
+  // Blocks as records name_i0_j0 of a Grid serialisation writer, boss node only;
+  // an Hdf5Writer takes the single dataset overload below
+  template<class Writer>
+  void Stream(Writer &WR,const std::string &name,
+	      const std::vector<FermionField> &w,const std::vector<FermionField> &v,int blockSize)
+  {
+    Stream(w,v,blockSize,[&](const Block &block,int i0,int j0){
+      if ( grid->IsBoss() ) {
+	write(WR,name+"_"+std::to_string(i0)+"_"+std::to_string(j0),block);
+      }
+    });
+  }
+
+#ifdef HAVE_HDF5
+  // One pre-sized (Nmom,Ngamma,Nt,Nw,Nv) dataset, chunked by block; the
+  // HDF5 write of a block overlaps the GEMMs of the next one
+  void Stream(Hdf5Writer &WR,const std::string &name,
+	      const std::vector<FermionField> &w,const std::vector<FermionField> &v,int blockSize,
+	      int compression=0)
+  {
+    size_t Nmom=mom.size(), Ngamma=gammas.size();
+    std::unique_ptr<Hdf5DataSetStream<ComplexD> > dataSet;
+    if ( grid->IsBoss() ) {
+      dataSet.reset(new Hdf5DataSetStream<ComplexD>(WR.getGroup(),name,
+						    {Nmom,Ngamma,(size_t)Nt,w.size(),v.size()},
+						    {1,1,(size_t)Nt,(size_t)blockSize,(size_t)blockSize},
+						    compression,true));
+    }
+    Stream(w,v,blockSize,[&](const Block &block,int i0,int j0){
+      if ( dataSet ) {
+	dataSet->writeBlock({0,0,0,(size_t)i0,(size_t)j0},
+			    {Nmom,Ngamma,(size_t)Nt,(size_t)block.dimension(3),(size_t)block.dimension(4)},
+			    block.data());
+      }
+    });
+  }
+#endif
+};
+
+NAMESPACE_END(Grid);
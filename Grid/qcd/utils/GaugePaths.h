@@ -0,0 +1,329 @@
+/*************************************************************************************
+
+    Grid physics library, www.github.com/paboyle/Grid
+
+    Source file: ./lib/qcd/utils/GaugePaths.h
+
+    Copyright (C) 2023
+
+Author: Peter Boyle <paboyle@ph.ed.ac.uk>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+    See the full license in the file "LICENSE" in the top level distribution directory
+*************************************************************************************/
+/*  END LEGAL */
+#pragma once
+
+NAMESPACE_BEGIN(Grid);
+
+/////////////////////////////////////////////////////////////////////////////
+// Gauge path compiler.
+//
+// A path is a list of directions, mu for a forward step and Back(mu) for
+// a backward step, as in generalShift. Each term multiplies the links
+// along its path starting from x+origin, and accumulates coeff times the
+// product into one of several outputs:
+//
+//   out[o](x) = sum_{t in o} coeff_t  U(x+origin_t, path_t)
+//
+// All terms are compiled into one GeneralLocalStencil on a PaddedCell
+// deep enough for the longest excursion. Evaluation pads each link field
+// once and runs a single fused site kernel for every output.
+//
+//   GaugePaths<PeriodicGimplR> paths;
+//   for(int mu=0;mu<Nd;mu++) {
+//     paths.AddStaples(mu,mu,c_plaq);
+//     paths.AddRectStaples(mu,mu,c_rect);
+//   }
+//   paths(staples,U);
+/////////////////////////////////////////////////////////////////////////////
+template <class Gimpl> class GaugePaths {
+public:
+  INHERIT_GIMPL_TYPES(Gimpl);
+
+  typedef typename Gimpl::GaugeLinkField GaugeMat;
+  typedef typename GaugeMat::vector_object::scalar_type Coeff_t;
+
+  // Device tables
+  struct Link { int point; int dir; int dag; };         // stencil point, link direction, adjoint
+  struct Term { int begin; int end; Coeff_t coeff; };  // range of links
+
+  struct Path {
+    int out;
+    Coeff_t coeff;
+    Coordinate origin;
+    std::vector<int> dirs;
+  };
+
+  std::vector<Path> paths;
+  int nout;
+
+private:
+  GridBase                            *compiled_grid;
+  std::unique_ptr<PaddedCell>          Cell;
+  std::unique_ptr<GeneralLocalStencil> Stencil;
+  deviceVector<Link>                   Links;
+  deviceVector<Term>                   Terms;
+  deviceVector<int>                    Outs;   // terms of output o are [Outs[o],Outs[o+1])
+
+public:
+  GaugePaths() : nout(0), compiled_grid(nullptr) {};
+
+  ////////////////////////////////////////////////////////
+  // Path description
+  ////////////////////////////////////////////////////////
+  void AddPath(int out,Coeff_t coeff,const std::vector<int> &dirs,const Coordinate &origin=Coordinate(Nd,0))
+  {
+    assert(dirs.size()>0);
+    assert(origin.size()==Nd);
+    Path p;
+    p.out   = out;
+    p.coeff = coeff;
+    p.origin= origin;
+    p.dirs  = dirs;
+    paths.push_back(p);
+    nout = std::max(nout,out+1);
+    compiled_grid = nullptr; // recompile
+  }
+
+  // Staples of link mu summed over nu != mu; U_mu(x)*staple closes the plaquettes
+  void AddStaples(int out,int mu,Coeff_t coeff)
+  {
+    Coordinate xmu(Nd,0); xmu[mu]=1;
+    for(int nu=0;nu<Nd;nu++){
+      if ( nu==mu ) continue;
+      AddPath(out,coeff,{nu,Back(mu),Back(nu)},xmu);
+      AddPath(out,coeff,{Back(nu),Back(mu),nu},xmu);
+    }
+  }
+
+  // The six 1x2 rectangle staples of link mu for each nu != mu
+  void AddRectStaples(int out,int mu,Coeff_t coeff)
+  {
+    Coordinate xmu(Nd,0); xmu[mu]=1;
+    for(int nu=0;nu<Nd;nu++){
+      if ( nu==mu ) continue;
+      AddPath(out,coeff,{mu,nu,Back(mu),Back(mu),Back(nu)},xmu);
+      AddPath(out,coeff,{mu,Back(nu),Back(mu),Back(mu),nu},xmu);
+      AddPath(out,coeff,{nu,Back(mu),Back(mu),Back(nu),mu},xmu);
+      AddPath(out,coeff,{Back(nu),Back(mu),Back(mu),nu,mu},xmu);
+      AddPath(out,coeff,{nu,nu,Back(mu),Back(nu),Back(nu)},xmu);
+      AddPath(out,coeff,{Back(nu),Back(nu),Back(mu),nu,nu},xmu);
+    }
+  }
+
+  // The four MxN loops around x in the mu-nu plane, as WilsonLoops::CloverleafMxN
+  void AddCloverleafMxN(int out,int mu,int nu,int M,int N,Coeff_t coeff)
+  {
+    auto steps = [](std::vector<int> &p,int dir,int n) { for(int i=0;i<n;i++) p.push_back(dir); };
+    std::vector<int> p;
+    p.resize(0); steps(p,nu,N);       steps(p,mu,M);       steps(p,Back(nu),N); steps(p,Back(mu),M); AddPath(out,coeff,p);
+    p.resize(0); steps(p,Back(mu),M); steps(p,nu,N);       steps(p,mu,M);       steps(p,Back(nu),N); AddPath(out,coeff,p);
+    p.resize(0); steps(p,mu,M);       steps(p,Back(nu),N); steps(p,Back(mu),M); steps(p,nu,N);       AddPath(out,coeff,p);
+    p.resize(0); steps(p,Back(nu),N); steps(p,Back(mu),M); steps(p,nu,N);       steps(p,mu,M);       AddPath(out,coeff,p);
+  }
+
+  // Rectangular R x T Wilson loop in the mu-nu plane starting at x
+  void AddWilsonLoop(int out,int mu,int nu,int R,int T,Coeff_t coeff)
+  {
+    std::vector<int> p;
+    for(int i=0;i<R;i++) p.push_back(mu);
+    for(int i=0;i<T;i++) p.push_back(nu);
+    for(int i=0;i<R;i++) p.push_back(Back(mu));
+    for(int i=0;i<T;i++) p.push_back(Back(nu));
+    AddPath(out,coeff,p);
+  }
+
+  int PaddingDepth(void) const
+  {
+    int depth=1;
+    for(auto const &p : paths){
+      Coordinate x = p.origin;
+      for(int d=0;d<Nd;d++) depth=std::max(depth,std::abs(x[d]));
+      for(auto dir : p.dirs){
+	generalShift(x,dir);
+	for(int d=0;d<Nd;d++) depth=std::max(depth,std::abs(x[d]));
+      }
+    }
+    return depth;
+  }
+
+  ////////////////////////////////////////////////////////
+  // Build the padded cell, the stencil of distinct link
+  // positions and the link/term/output tables
+  ////////////////////////////////////////////////////////
+  void Compile(GridBase *grid)
+  {
+    double t0=usecond();
+    assert(paths.size()>0);
+
+    Cell.reset(new PaddedCell(PaddingDepth(),dynamic_cast<GridCartesian *>(grid)));
+
+    std::vector<Coordinate> shifts;
+    std::map<std::vector<int>,int> point;
+    auto pointOf = [&](const Coordinate &x) {
+      std::vector<int> key(x.begin(),x.end());
+      auto it = point.find(key);
+      if ( it != point.end() ) return it->second;
+      int p = shifts.size();
+      point[key]=p;
+      shifts.push_back(x);
+      return p;
+    };
+
+    // Terms ordered by output so each output is one contiguous range
+    std::vector<int> order(paths.size());
+    for(int t=0;t<order.size();t++) order[t]=t;
+    std::stable_sort(order.begin(),order.end(),[&](int a,int b){ return paths[a].out < paths[b].out; });
+
+    std::vector<Link> links;
+    std::vector<Term> terms;
+    std::vector<int>  outs(nout+1,0);
+    for(auto t : order){
+      const Path &p = paths[t];
+      Term term;
+      term.begin = links.size();
+      term.coeff = p.coeff;
+      Coordinate x = p.origin;
+      for(auto dir : p.dirs){
+	Link l;
+	if ( dir >= shiftSignal::BACKWARD_CONST ) { // U^dag_mu(x-mu)
+	  l.dir = dir - shiftSignal::BACKWARD_CONST;
+	  l.dag = 1;
+	  x[l.dir]--;
+	  l.point = pointOf(x);
+	} else {                                    // U_mu(x)
+	  l.dir = dir;
+	  l.dag = 0;
+	  l.point = pointOf(x);
+	  x[l.dir]++;
+	}
+	assert(l.dir>=0 && l.dir<Nd);
+	links.push_back(l);
+      }
+      term.end = links.size();
+      terms.push_back(term);
+      outs[p.out+1]++;
+    }
+    for(int o=0;o<nout;o++) outs[o+1]+=outs[o];
+
+    Stencil.reset(new GeneralLocalStencil(Cell->grids.back(),shifts));
+
+    Links.resize(links.size());
+    Terms.resize(terms.size());
+    Outs.resize(outs.size());
+    acceleratorCopyToDevice(&links[0],&Links[0],links.size()*sizeof(Link));
+    acceleratorCopyToDevice(&terms[0],&Terms[0],terms.size()*sizeof(Term));
+    acceleratorCopyToDevice(&outs[0] ,&Outs[0] ,outs.size()*sizeof(int));
+
+    compiled_grid = grid;
+    double t1=usecond();
+    std::cout << GridLogPerformance << "GaugePaths::Compile "<<paths.size()<<" paths, "<<links.size()<<" links, "
+	      <<shifts.size()<<" stencil points, depth "<<Cell->depth<<" : "<<(t1-t0)/1000<<"ms"<<std::endl;
+  }
+
+  ////////////////////////////////////////////////////////
+  // Evaluate every output from the Nd link fields
+  ////////////////////////////////////////////////////////
+  void operator() (std::vector<GaugeMat> &out,const std::vector<GaugeMat> &U)
+  {
+    assert(U.size()==Nd);
+    GridBase *grid = U[0].Grid();
+    if ( compiled_grid != grid ) Compile(grid);
+
+    double t0=usecond();
+    CshiftImplGauge<Gimpl> cshift_impl;
+    std::vector<GaugeMat> U_pad(Nd,Cell->grids.back());
+    for(int mu=0;mu<Nd;mu++) U_pad[mu] = Cell->Exchange(U[mu],cshift_impl);
+    double t1=usecond();
+    Evaluate(out,U_pad);
+    double t2=usecond();
+    std::cout << GridLogPerformance << "GaugePaths timings: pad:"<<(t1-t0)/1000<<"ms, paths:"<<(t2-t1)/1000<<"ms"<<std::endl;
+  }
+  void operator() (std::vector<GaugeMat> &out,const GaugeField &Umu)
+  {
+    std::vector<GaugeMat> U(Nd,Umu.Grid());
+    for(int mu=0;mu<Nd;mu++) U[mu] = PeekIndex<LorentzIndex>(Umu,mu);
+    (*this)(out,U);
+  }
+
+  // Links already padded with the Cell of this object
+  void Evaluate(std::vector<GaugeMat> &out,const std::vector<GaugeMat> &U_padded)
+  {
+    assert(U_padded.size()==Nd);
+    assert(U_padded[0].Grid()==(GridBase *)Cell->grids.back());
+    GridBase *ggrid = U_padded[0].Grid();
+    GridBase *grid  = Cell->unpadded_grid;
+
+    if ( out.size()!=nout ) out.resize(nout,grid);
+    std::vector<GaugeMat> out_pad(nout,ggrid);
+
+    typedef LatticeView<typename GaugeMat::vector_object> GaugeViewType;
+    size_t usize = Nd*sizeof(GaugeViewType);
+    size_t osize = nout*sizeof(GaugeViewType);
+    GaugeViewType* U_v_host = (GaugeViewType*)malloc(usize);
+    GaugeViewType* O_v_host = (GaugeViewType*)malloc(osize);
+    for(int mu=0;mu<Nd;mu++) U_v_host[mu] = U_padded[mu].View(AcceleratorRead);
+    for(int o=0;o<nout;o++)  O_v_host[o]  = out_pad[o].View(AcceleratorWrite);
+    GaugeViewType* U_v = (GaugeViewType*)acceleratorAllocDevice(usize);
+    GaugeViewType* O_v = (GaugeViewType*)acceleratorAllocDevice(osize);
+    acceleratorCopyToDevice(U_v_host,U_v,usize);
+    acceleratorCopyToDevice(O_v_host,O_v,osize);
+
+    {
+      auto Stencil_v = Stencil->View(AcceleratorRead);
+      Link *links_p = &Links[0];
+      Term *terms_p = &Terms[0];
+      int  *outs_p  = &Outs[0];
+      int   Nout    = nout;
+
+      accelerator_for(ss, ggrid->oSites(), (size_t)ggrid->Nsimd(), {
+	typedef decltype(coalescedRead(U_v[0][0])) calcMat;
+	for(int o=0;o<Nout;o++){
+	  calcMat acc;
+	  acc = Zero();
+	  for(int t=outs_p[o];t<outs_p[o+1];t++){
+	    Term term = terms_p[t];
+	    calcMat prod;
+	    for(int l=term.begin;l<term.end;l++){
+	      Link link = links_p[l];
+	      GeneralStencilEntry const* e = Stencil_v.GetEntry(link.point,ss);
+	      calcMat L = coalescedReadGeneralPermute(U_v[link.dir][e->_offset], e->_permute, Nd);
+	      if ( link.dag ) L = adj(L);
+	      if ( l==term.begin ) prod = L;
+	      else                 prod = prod*L;
+	    }
+	    acc = acc + term.coeff*prod;
+	  }
+	  coalescedWrite(O_v[o][ss],acc);
+	}
+      });
+    }
+
+    for(int mu=0;mu<Nd;mu++) U_v_host[mu].ViewClose();
+    for(int o=0;o<nout;o++)  O_v_host[o].ViewClose();
+    free(U_v_host);
+    free(O_v_host);
+    acceleratorFreeDevice(U_v);
+    acceleratorFreeDevice(O_v);
+
+    for(int o=0;o<nout;o++) out[o] = Cell->Extract(out_pad[o]);
+  }
+
+  const PaddedCell &GetPaddedCell(void) const { assert(Cell); return *Cell; }
+};
+
+NAMESPACE_END(Grid);
@@ -37,18 +37,36 @@ using namespace H5NS; // Compile error here? Try adding --enable-cxx to hdf5 con
 #endif
 
 // Writer implementation ///////////////////////////////////////////////////////
-Hdf5Writer::Hdf5Writer(const std::string &fileName)
+// append opens an existing file read-write, so that chunked datasets
+// (Hdf5DataSetStream) can be extended across runs
+static unsigned int hdf5WriterMode(const std::string &fileName, const bool append)
+{
+  return (append && std::ifstream(fileName).good()) ? H5F_ACC_RDWR : H5F_ACC_TRUNC;
+}
+
+Hdf5Writer::Hdf5Writer(const std::string &fileName, const bool append)
 : fileName_(fileName)
-, file_(fileName.c_str(), H5F_ACC_TRUNC)
+, file_(fileName.c_str(), hdf5WriterMode(fileName, append))
 {
   group_ = file_.openGroup("/");
-  writeSingleAttribute(dataSetThres_, HDF5_GRID_GUARD "dataset_threshold",
-                       Hdf5Type<unsigned int>::type());
+  if (!group_.attrExists(HDF5_GRID_GUARD "dataset_threshold"))
+  {
+    writeSingleAttribute(dataSetThres_, HDF5_GRID_GUARD "dataset_threshold",
+                         Hdf5Type<unsigned int>::type());
+  }
 }
 
 void Hdf5Writer::push(const std::string &s)
 {
-  group_ = group_.createGroup(s);
+  // groups already in a file opened for append are reopened
+  if (H5Lexists(group_.getId(), s.c_str(), H5P_DEFAULT) > 0)
+  {
+    group_ = group_.openGroup(s);
+  }
+  else
+  {
+    group_ = group_.createGroup(s);
+  }
   path_.push_back(s);
 }
 
@@ -36,6 +36,7 @@
 #include <string>
 #include <list>
 #include <vector>
+#include <future>
 #include <H5Cpp.h>
 #include <Grid/tensors/Tensors.h>
 #include "Hdf5Type.h"
@@ -53,7 +54,7 @@ namespace Grid
   class Hdf5Writer: public Writer<Hdf5Writer>
   {
   public:
-    Hdf5Writer(const std::string &fileName);
+    Hdf5Writer(const std::string &fileName, const bool append = false);
     virtual ~Hdf5Writer(void) = default;
     void push(const std::string &s);
     void pop(void);
@@ -115,6 +116,44 @@ namespace Grid
     unsigned int             dataSetThres_;
   };
   
+  // Chunked dataset streamed a hyperslab at a time ///////////////////////////
+  //
+  // Pre-sized: every dimension is fixed at creation and blocks are written
+  // at any offset, so a producer never holds more than one block.
+  // Append mode: dims[0] == 0 gives an unlimited leading dimension that
+  // grows with each append(); an existing dataset of the same name is
+  // reopened and appended to, also inside groups reopened by push() on a
+  // writer opened for append.
+  // compression > 0 deflates each chunk at that level (1-9).
+  // With async each write is copied and handed to a background thread,
+  // overlapping it with the computation of the next block. At most one
+  // write is in flight; flush() before other HDF5 calls on the file.
+  template <typename U>
+  class Hdf5DataSetStream
+  {
+  public:
+    Hdf5DataSetStream(H5NS::Group &group, const std::string &name,
+                      const std::vector<size_t> &dims,
+                      const std::vector<size_t> &chunk,
+                      const int compression = 0, const bool async = false);
+    ~Hdf5DataSetStream(void) { flush(); }
+    void writeBlock(const std::vector<size_t> &offset,
+                    const std::vector<size_t> &count, const U *pDataRowMajor);
+    void append(const U *pDataRowMajor, const size_t n = 1);
+    void flush(void);
+    size_t size(void) const { return extent_[0]; }
+  private:
+    void writeSlab(const std::vector<hsize_t> &offset,
+                   const std::vector<hsize_t> &count, const U *pDataRowMajor);
+  private:
+    H5NS::DataSet        dataSet_;
+    int                  rank_;
+    std::vector<hsize_t> extent_;
+    bool                 async_;
+    std::vector<U>       buffer_;
+    std::future<void>    pending_;
+  };
+
   // Writer template implementation ////////////////////////////////////////////
   template <typename U>
   void Hdf5Writer::writeSingleAttribute(const U &x, const std::string &name,
@@ -242,6 +281,110 @@ namespace Grid
     pop();
   }
   
+  // Chunked dataset template implementation ///////////////////////////////////
+  template <typename U>
+  Hdf5DataSetStream<U>::Hdf5DataSetStream(H5NS::Group &group, const std::string &name,
+                                          const std::vector<size_t> &dims,
+                                          const std::vector<size_t> &chunk,
+                                          const int compression, const bool async)
+  : rank_(dims.size()), extent_(dims.begin(), dims.end()), async_(async)
+  {
+    assert(chunk.size() == rank_);
+    if (H5Lexists(group.getId(), name.c_str(), H5P_DEFAULT) > 0)
+    {
+      dataSet_ = group.openDataSet(name);
+      H5NS::DataSpace space = dataSet_.getSpace();
+      assert(space.getSimpleExtentNdims() == rank_);
+      space.getSimpleExtentDims(extent_.data());
+      for (int i = 1; i < rank_; i++)
+      {
+        assert(extent_[i] == dims[i]);
+      }
+    }
+    else
+    {
+      std::vector<hsize_t> maxDim(extent_), chunkDim(chunk.begin(), chunk.end());
+      if (dims[0] == 0)
+      {
+        maxDim[0] = H5S_UNLIMITED;
+      }
+      for (int i = 0; i < rank_; i++)
+      {
+        assert(chunkDim[i] > 0);
+        if (maxDim[i] != H5S_UNLIMITED) chunkDim[i] = std::min(chunkDim[i], maxDim[i]);
+      }
+      H5NS::DataSpace         dataSpace(rank_, extent_.data(), maxDim.data());
+      H5NS::DSetCreatPropList plist;
+      plist.setChunk(rank_, chunkDim.data());
+      if (compression > 0)
+      {
+        plist.setDeflate(compression);
+      }
+      plist.setFletcher32();
+      dataSet_ = group.createDataSet(name, Hdf5Type<U>::type(), dataSpace, plist);
+    }
+  }
+
+  template <typename U>
+  void Hdf5DataSetStream<U>::writeSlab(const std::vector<hsize_t> &offset,
+                                       const std::vector<hsize_t> &count, const U *pDataRowMajor)
+  {
+    H5NS::DataSpace fileSpace = dataSet_.getSpace();
+    H5NS::DataSpace memSpace(rank_, count.data());
+    fileSpace.selectHyperslab(H5S_SELECT_SET, count.data(), offset.data());
+    dataSet_.write(pDataRowMajor, Hdf5Type<U>::type(), memSpace, fileSpace);
+  }
+
+  template <typename U>
+  void Hdf5DataSetStream<U>::writeBlock(const std::vector<size_t> &offset,
+                                        const std::vector<size_t> &count, const U *pDataRowMajor)
+  {
+    assert(offset.size() == rank_);
+    assert(count.size() == rank_);
+    std::vector<hsize_t> off(offset.begin(), offset.end()), cnt(count.begin(), count.end());
+    size_t               n = 1;
+    for (int i = 0; i < rank_; i++)
+    {
+      assert(off[i] + cnt[i] <= extent_[i]);
+      n *= cnt[i];
+    }
+    flush();
+    if (async_)
+    {
+      buffer_.assign(pDataRowMajor, pDataRowMajor + n);
+      pending_ = std::async(std::launch::async, [this, off, cnt](void)
+      {
+        writeSlab(off, cnt, buffer_.data());
+      });
+    }
+    else
+    {
+      writeSlab(off, cnt, pDataRowMajor);
+    }
+  }
+
+  template <typename U>
+  void Hdf5DataSetStream<U>::append(const U *pDataRowMajor, const size_t n)
+  {
+    std::vector<size_t> offset(rank_, 0), count(extent_.begin(), extent_.end());
+    
+    flush();
+    offset[0]   = extent_[0];
+    count[0]    = n;
+    extent_[0] += n;
+    dataSet_.extend(extent_.data());
+    writeBlock(offset, count, pDataRowMajor);
+  }
+
+  template <typename U>
+  void Hdf5DataSetStream<U>::flush(void)
+  {
+    if (pending_.valid())
+    {
+      pending_.get();
+    }
+  }
+  
   // Reader template implementation ////////////////////////////////////////////
   template <typename U>
   void Hdf5Reader::readSingleAttribute(U &x, const std::string &name,
@@ -105,6 +105,21 @@ accelerator_inline Grid_half sfw_float_to_half(float ff) {
   o.x |= static_cast<unsigned short>(sign >> 16);
   return o;
 }
+// bfloat16: top half of an IEEE float, round to nearest even, NaN kept quiet
+accelerator_inline uint16_t sfw_float_to_bf16(float ff) {
+  FP32 f; f.f = ff;
+  if ( (f.u & 0x7fffffffu) > 0x7f800000u ) {
+    return static_cast<uint16_t>((f.u >> 16) | 0x40);
+  }
+  unsigned int lsb = (f.u >> 16) & 1;
+  f.u += 0x7fffu + lsb;
+  return static_cast<uint16_t>(f.u >> 16);
+}
+accelerator_inline float sfw_bf16_to_float(uint16_t h) {
+  FP32 f;
+  f.u = ((unsigned int)h) << 16;
+  return f.f;
+}
 
 
 #ifdef GPU_VEC
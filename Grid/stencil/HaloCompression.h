@@ -0,0 +1,257 @@
+/*************************************************************************************
+
+    Grid physics library, www.github.com/paboyle/Grid
+
+    Source file: ./lib/stencil/HaloCompression.h
+
+    Copyright (C) 2015
+
+Author: Peter Boyle <paboyle@ph.ed.ac.uk>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+    See the full license in the file "LICENSE" in the top level distribution directory
+*************************************************************************************/
+/*  END LEGAL */
+#ifndef GRID_STENCIL_HALO_COMPRESSION_H
+#define GRID_STENCIL_HALO_COMPRESSION_H
+
+NAMESPACE_BEGIN(Grid);
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Lossy face compression applied to MPI halo buffers, after the compressor has gathered
+// the face and before it goes on the wire. Works on the raw real numbers in the buffer,
+// so it is independent of the site object and of the compressor that filled it.
+//
+//  FP16 : blocks of HaloCompressionBlock reals share one float scale; mantissa 11 bits
+//  BF16 : truncated float with round to nearest even; float range, mantissa 8 bits
+//
+// Both ends must agree on the mode, so it is a collective per-stencil choice.
+// Default for operators that opt in comes from --comms-compression none|fp16|bf16
+//////////////////////////////////////////////////////////////////////////////////////////
+enum HaloCompressionMode {
+  HaloCompressionNone=0,
+  HaloCompressionFP16=1,
+  HaloCompressionBF16=2
+};
+
+extern int Stencil_halo_compression;        // --comms-compression
+extern int Stencil_halo_compression_check;  // --comms-compression-check
+
+const int HaloCompressionBlock=32;
+
+///////////////////////////////////////////////////////////////////
+// Compressors opt in with "static constexpr bool FaceCompression=true;"
+///////////////////////////////////////////////////////////////////
+template<class compressor,class=void> struct CompressorFaceCompression {
+  static constexpr bool value = false;
+};
+template<class compressor>
+struct CompressorFaceCompression<compressor,typename std::enable_if<compressor::FaceCompression>::type> {
+  static constexpr bool value = true;
+};
+
+///////////////////////////////////////////////////////////////////
+// Per-stencil error and traffic accounting
+///////////////////////////////////////////////////////////////////
+struct HaloCompressionStats {
+  uint64_t calls;
+  double   raw_bytes;
+  double   wire_bytes;
+  double   err2;
+  double   norm2;
+  double   max_rel;
+  HaloCompressionStats() { Zero(); };
+  void Zero(void) {
+    calls=0;
+    raw_bytes=wire_bytes=0.0;
+    err2=norm2=max_rel=0.0;
+  }
+  void Report(const std::string &name) const {
+    if ( calls==0 ) return;
+    std::cout << GridLogMessage << name << " halo compression: "<<calls<<" buffers "
+	      << raw_bytes/1.0e6 << " MB -> "<< wire_bytes/1.0e6 << " MB on wire"
+	      << " ratio "<< raw_bytes/wire_bytes << std::endl;
+    if ( norm2 > 0.0 ) {
+      std::cout << GridLogMessage << name << " halo compression: relative error "
+		<< std::sqrt(err2/norm2) << " worst block "<< max_rel << std::endl;
+    }
+  }
+};
+
+class HaloCompressor {
+public:
+
+  static std::string Name(int mode) {
+    if ( mode==HaloCompressionFP16 ) return std::string("fp16");
+    if ( mode==HaloCompressionBF16 ) return std::string("bf16");
+    return std::string("none");
+  }
+  static int Mode(const std::string &name) {
+    if ( name=="fp16" ) return HaloCompressionFP16;
+    if ( name=="bf16" ) return HaloCompressionBF16;
+    assert(name=="none");
+    return HaloCompressionNone;
+  }
+
+  static uint64_t Align(uint64_t bytes) { return (bytes+255)&(~((uint64_t)255)); }
+
+  template<class real> static uint64_t Reals(uint64_t bytes) {
+    assert( (bytes%sizeof(real))==0 );
+    return bytes/sizeof(real);
+  }
+  template<class real> static uint64_t Blocks(uint64_t bytes) {
+    return (Reals<real>(bytes)+HaloCompressionBlock-1)/HaloCompressionBlock;
+  }
+  template<class real> static uint64_t ScaleBytes(int mode,uint64_t bytes) {
+    if ( mode!=HaloCompressionFP16 ) return 0;
+    return ((Blocks<real>(bytes)*sizeof(float)+7)/8)*8;
+  }
+  // Bytes on the wire for a face of "bytes" uncompressed bytes
+  template<class real> static uint64_t CompressedBytes(int mode,uint64_t bytes) {
+    if ( mode==HaloCompressionNone ) return bytes;
+    return ScaleBytes<real>(mode,bytes) + Reals<real>(bytes)*sizeof(uint16_t);
+  }
+
+  ///////////////////////////////////////////////////////////////////
+  // Block kernels, callable on host or device
+  ///////////////////////////////////////////////////////////////////
+  template<class real>
+  static accelerator_inline void CompressBlock(int mode,const real *in,float *scale,uint16_t *out,
+					       uint64_t b,uint64_t n)
+  {
+    uint64_t s0 = b*HaloCompressionBlock;
+    uint64_t s1 = s0+HaloCompressionBlock;
+    if ( s1 > n ) s1 = n;
+    if ( mode==HaloCompressionFP16 ) {
+      float amax=0.0f;
+      for(uint64_t s=s0;s<s1;s++){
+	float a = (float)in[s];
+	a = (a<0.0f) ? -a : a;
+	amax = (a>amax) ? a : amax;
+      }
+      float sc  = (amax>0.0f) ? amax : 1.0f;
+      float isc = 1.0f/sc;
+      scale[b] = sc;
+      for(uint64_t s=s0;s<s1;s++){
+	out[s] = sfw_float_to_half((float)in[s]*isc).x;
+      }
+    } else {
+      for(uint64_t s=s0;s<s1;s++){
+	out[s] = sfw_float_to_bf16((float)in[s]);
+      }
+    }
+  }
+  template<class real>
+  static accelerator_inline void DecompressBlock(int mode,real *out,const float *scale,const uint16_t *in,
+						 uint64_t b,uint64_t n)
+  {
+    uint64_t s0 = b*HaloCompressionBlock;
+    uint64_t s1 = s0+HaloCompressionBlock;
+    if ( s1 > n ) s1 = n;
+    if ( mode==HaloCompressionFP16 ) {
+      float sc = scale[b];
+      for(uint64_t s=s0;s<s1;s++){
+	out[s] = (real)(sfw_half_to_float(Grid_half(in[s]))*sc);
+      }
+    } else {
+      for(uint64_t s=s0;s<s1;s++){
+	out[s] = (real)sfw_bf16_to_float(in[s]);
+      }
+    }
+  }
+
+  ///////////////////////////////////////////////////////////////////
+  // Whole buffers; on_device selects accelerator_for vs thread_for
+  // depending on where the comms buffers live.
+  ///////////////////////////////////////////////////////////////////
+  template<class real>
+  static void Compress(int mode,const void *in,void *out,uint64_t bytes,int on_device=1)
+  {
+    uint64_t n      = Reals<real>(bytes);
+    uint64_t nblock = Blocks<real>(bytes);
+    const real *x = (const real *)in;
+    float    *sc  = (float *)out;
+    uint16_t *h   = (uint16_t *)((char *)out+ScaleBytes<real>(mode,bytes));
+    if ( on_device ) {
+      accelerator_for(b,nblock,1,{
+	  CompressBlock(mode,x,sc,h,b,n);
+      });
+    } else {
+      thread_for(b,nblock,{
+	  CompressBlock(mode,x,sc,h,b,n);
+      });
+    }
+  }
+  template<class real>
+  static void Decompress(int mode,const void *in,void *out,uint64_t bytes,int on_device=1)
+  {
+    uint64_t n      = Reals<real>(bytes);
+    uint64_t nblock = Blocks<real>(bytes);
+    real           *x  = (real *)out;
+    const float    *sc = (const float *)in;
+    const uint16_t *h  = (const uint16_t *)((const char *)in+ScaleBytes<real>(mode,bytes));
+    if ( on_device ) {
+      accelerator_for(b,nblock,1,{
+	  DecompressBlock(mode,x,sc,h,b,n);
+      });
+    } else {
+      thread_for(b,nblock,{
+	  DecompressBlock(mode,x,sc,h,b,n);
+      });
+    }
+  }
+
+  ///////////////////////////////////////////////////////////////////
+  // Round trip error of an already compressed buffer; diagnostic only,
+  // runs on the host after copying both sides back.
+  ///////////////////////////////////////////////////////////////////
+  template<class real>
+  static void Measure(int mode,const void *in,const void *comp,uint64_t bytes,
+		      HaloCompressionStats &stats,int on_device=1)
+  {
+    uint64_t n      = Reals<real>(bytes);
+    uint64_t nblock = Blocks<real>(bytes);
+    uint64_t cbytes = CompressedBytes<real>(mode,bytes);
+    std::vector<real> x(n);
+    std::vector<real> y(n);
+    std::vector<char> c(cbytes);
+    if ( on_device ) {
+      acceleratorCopyFromDevice((void *)in,(void *)&x[0],bytes);
+      acceleratorCopyFromDevice((void *)comp,(void *)&c[0],cbytes);
+    } else {
+      memcpy((void *)&x[0],in,bytes);
+      memcpy((void *)&c[0],comp,cbytes);
+    }
+    Decompress<real>(mode,(void *)&c[0],(void *)&y[0],bytes,0);
+    for(uint64_t b=0;b<nblock;b++){
+      double e2=0.0;
+      double n2=0.0;
+      uint64_t s1 = std::min(n,(b+1)*HaloCompressionBlock);
+      for(uint64_t s=b*HaloCompressionBlock;s<s1;s++){
+	double d = (double)x[s]-(double)y[s];
+	e2 += d*d;
+	n2 += (double)x[s]*(double)x[s];
+      }
+      stats.err2 += e2;
+      stats.norm2+= n2;
+      if ( n2>0.0 ) stats.max_rel = std::max(stats.max_rel,std::sqrt(e2/n2));
+    }
+  }
+};
+
+NAMESPACE_END(Grid);
+
+#endif
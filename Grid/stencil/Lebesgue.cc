@@ -51,8 +51,19 @@ LebesgueOrder::IndexInteger LebesgueOrder::alignup(IndexInteger n){
 LebesgueOrder::LebesgueOrder(GridBase *_grid) 
 {
   grid = _grid;
-  if ( Block[0]==0) ZGraph();
-  else if ( Block[1]==0) NoBlocking();
+  _Block = Block;
+  Order();
+}
+LebesgueOrder::LebesgueOrder(GridBase *_grid,const std::vector<int> &_block)
+{
+  grid = _grid;
+  _Block = _block;
+  Order();
+}
+void LebesgueOrder::Order(void)
+{
+  if ( _Block[0]==0) ZGraph();
+  else if ( _Block[1]==0) NoBlocking();
   else CartesianBlocking();
 
   if (0) {
@@ -98,7 +109,7 @@ void LebesgueOrder::CartesianBlocking(void)
   IndexInteger ND = grid->_ndimension;
 
   assert(ND==4);
-  assert(ND==Block.size());
+  assert(ND==_Block.size());
 
   Coordinate dims(ND);
   Coordinate xo(ND,0);
@@ -116,7 +127,7 @@ void LebesgueOrder::IterateO(int ND,int dim,
 			     Coordinate & xi,
 			     Coordinate &dims)
 {
-  for(xo[dim]=0;xo[dim]<dims[dim];xo[dim]+=Block[dim]){
+  for(xo[dim]=0;xo[dim]<dims[dim];xo[dim]+=_Block[dim]){
     if ( dim > 0 ) {
       IterateO(ND,dim-1,xo,xi,dims);
     } else {
@@ -132,7 +143,7 @@ void LebesgueOrder::IterateI(int ND,
 			     Coordinate &dims)
 {
   Coordinate x(ND);
-  for(xi[dim]=0;xi[dim]<std::min(dims[dim]-xo[dim],Block[dim]);xi[dim]++){
+  for(xi[dim]=0;xi[dim]<std::min(dims[dim]-xo[dim],_Block[dim]);xi[dim]++){
     if ( dim > 0 ) {
       IterateI(ND,dim-1,xo,xi,dims);
     } else {
@@ -43,6 +43,7 @@ public:
 
 public:
   LebesgueOrder(GridBase *_grid);
+  LebesgueOrder(GridBase *_grid,const std::vector<int> &_block);
 
   inline IndexInteger Reorder(IndexInteger ss) { 
     return _LebesgueReorder[ss] ;
@@ -58,6 +59,8 @@ public:
   // Cartesian stencil blocking strategy
   /////////////////////////////////
   static std::vector<int> Block;
+  std::vector<int> _Block;  // Blocking in use by this ordering; defaults to Block
+  void Order(void);
   void NoBlocking(void);
   void CartesianBlocking(void);
   void IterateO(int ND,int dim,
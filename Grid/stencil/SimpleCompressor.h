@@ -106,6 +106,7 @@ class FaceGatherDirichlet
 template<class vobj,class FaceGather>
 class SimpleCompressorGather : public FaceGather {
 public:
+  static constexpr bool FaceCompression = true;
   void Point(int) {};
   accelerator_inline int  CommDatumSize(void) const { return sizeof(vobj); }
   accelerator_inline bool DecompressionStep(void) const { return false; }
@@ -45,6 +45,9 @@ void DslashGetCounts(uint64_t &dirichlet,uint64_t &partial,uint64_t &full)
   partial   = DslashPartialCount;
   full      = DslashFullCount;
 }
+int Stencil_halo_compression       = HaloCompressionNone;
+int Stencil_halo_compression_check = 0;
+
 void DslashLogFull(void)     { DslashFullCount++;}
 void DslashLogPartial(void)  { DslashPartialCount++;}
 void DslashLogDirichlet(void){ DslashDirichletCount++;}
@@ -30,6 +30,7 @@
 
 #define STENCIL_MAX (16)
 
+#include <Grid/stencil/HaloCompression.h>
 #include <Grid/stencil/SimpleCompressor.h>   // subdir aggregate
 #include <Grid/stencil/Lebesgue.h>   // subdir aggregate
 #include <Grid/stencil/GeneralLocalStencil.h>
@@ -217,6 +218,7 @@ public:
     Integer do_recv;
     Integer xbytes;
     Integer rbytes;
+    Integer compress; // face compression allowed by the compressor
   };
   struct Merge {
     static constexpr int Nsimd = vobj::Nsimd();
@@ -299,6 +301,134 @@ public:
   int u_comm_offset;
   int _unified_buffer_size;
 
+  ///////////////////////////////////////////////////////////
+  // Persistent comms (--comms-persistent). The packet list from
+  // the gather is registered with MPI once, and re-registered
+  // only if the pattern (buffers, ranks, sizes) ever changes.
+  ///////////////////////////////////////////////////////////
+  std::vector<CommsRequest_t> PersistentReqs;
+  std::vector<Packet>         PersistentPackets;
+  int                         PersistentRegistered=0;
+
+  bool PersistentPatternMatches(void)
+  {
+    if ( !PersistentRegistered ) return false;
+    if ( PersistentPackets.size() != Packets.size() ) return false;
+    for(int i=0;i<Packets.size();i++){
+      if ( PersistentPackets[i].send_buf  != Packets[i].send_buf  ) return false;
+      if ( PersistentPackets[i].recv_buf  != Packets[i].recv_buf  ) return false;
+      if ( PersistentPackets[i].to_rank   != Packets[i].to_rank   ) return false;
+      if ( PersistentPackets[i].from_rank != Packets[i].from_rank ) return false;
+      if ( PersistentPackets[i].do_send   != Packets[i].do_send   ) return false;
+      if ( PersistentPackets[i].do_recv   != Packets[i].do_recv   ) return false;
+      if ( PersistentPackets[i].xbytes    != Packets[i].xbytes    ) return false;
+      if ( PersistentPackets[i].rbytes    != Packets[i].rbytes    ) return false;
+    }
+    return true;
+  }
+  void PersistentRegister(void)
+  {
+    if ( PersistentPatternMatches() ) return;
+    PersistentFree();
+    for(int i=0;i<Packets.size();i++){
+      _grid->StencilSendToRecvFromPersistentInit(PersistentReqs,
+						 Packets[i].send_buf,
+						 Packets[i].to_rank,Packets[i].do_send,
+						 Packets[i].recv_buf,
+						 Packets[i].from_rank,Packets[i].do_recv,
+						 Packets[i].xbytes,Packets[i].rbytes,i);
+    }
+    PersistentPackets    = Packets;
+    PersistentRegistered = 1;
+  }
+  void PersistentFree(void)
+  {
+    if ( PersistentRegistered ) _grid->StencilPersistentFree(PersistentReqs);
+    PersistentPackets.resize(0);
+    PersistentRegistered = 0;
+  }
+
+  ///////////////////////////////////////////////////////////
+  // Face compression of off node packets (HaloCompression.h).
+  // Off node legs are redirected to compressed staging buffers
+  // before the send and expanded into the comms buffers after
+  // completion, so the gather and merge code is unchanged.
+  ///////////////////////////////////////////////////////////
+  typedef typename RealPart<typename cobj::scalar_type>::type FaceReal;
+  int                  HaloCompression=HaloCompressionNone; // collective: all ranks must agree
+  HaloCompressionStats HaloCompressionCounters;
+  std::vector<Packet>  FaceOriginalPackets;
+  commVector<char>     u_face_send_buf;
+  commVector<char>     u_face_recv_buf;
+
+  void SetHaloCompression(int mode) { HaloCompression = mode; }
+  void HaloCompressionReport(const std::string &name) const { HaloCompressionCounters.Report(name); }
+  void HaloCompressionZeroCounters(void) { HaloCompressionCounters.Zero(); }
+
+  int FaceOffNode(int rank)
+  {
+    if ( Stencil_force_mpi ) return 1;
+    return _grid->ShmBufferTranslate(rank,this->u_recv_buf_p)==NULL;
+  }
+  void FaceCompress(void)
+  {
+    FaceOriginalPackets.resize(0);
+    if ( HaloCompression==HaloCompressionNone ) return;
+    if ( !std::is_floating_point<FaceReal>::value ) return;
+
+    uint64_t xoff=0;
+    uint64_t roff=0;
+    std::vector<uint64_t> xoffs(Packets.size());
+    std::vector<uint64_t> roffs(Packets.size());
+    std::vector<int> xc(Packets.size(),0);
+    std::vector<int> rc(Packets.size(),0);
+    for(int i=0;i<Packets.size();i++){
+      if ( !Packets[i].compress ) continue;
+      xc[i] = Packets[i].do_send && Packets[i].xbytes && FaceOffNode(Packets[i].to_rank);
+      rc[i] = Packets[i].do_recv && Packets[i].rbytes && FaceOffNode(Packets[i].from_rank);
+      xoffs[i]=xoff;
+      roffs[i]=roff;
+      if (xc[i]) xoff+=HaloCompressor::Align(HaloCompressor::CompressedBytes<FaceReal>(HaloCompression,Packets[i].xbytes));
+      if (rc[i]) roff+=HaloCompressor::Align(HaloCompressor::CompressedBytes<FaceReal>(HaloCompression,Packets[i].rbytes));
+    }
+    if ( (xoff==0) && (roff==0) ) return;
+    // Grow only, never copy: persistent requests re-register if the staging moves
+    if ( u_face_send_buf.size() < xoff ) { commVector<char> tmp(xoff); u_face_send_buf.swap(tmp); }
+    if ( u_face_recv_buf.size() < roff ) { commVector<char> tmp(roff); u_face_recv_buf.swap(tmp); }
+
+    FaceOriginalPackets = Packets;
+    for(int i=0;i<Packets.size();i++){
+      if ( xc[i] ) {
+	void *comp = (void *)&u_face_send_buf[xoffs[i]];
+	HaloCompressor::Compress<FaceReal>(HaloCompression,Packets[i].send_buf,comp,Packets[i].xbytes);
+	if ( Stencil_halo_compression_check ) {
+	  HaloCompressor::Measure<FaceReal>(HaloCompression,Packets[i].send_buf,comp,Packets[i].xbytes,HaloCompressionCounters);
+	}
+	HaloCompressionCounters.calls++;
+	HaloCompressionCounters.raw_bytes += Packets[i].xbytes;
+	Packets[i].send_buf = comp;
+	Packets[i].xbytes   = HaloCompressor::CompressedBytes<FaceReal>(HaloCompression,Packets[i].xbytes);
+	HaloCompressionCounters.wire_bytes+= Packets[i].xbytes;
+      }
+      if ( rc[i] ) {
+	Packets[i].recv_buf = (void *)&u_face_recv_buf[roffs[i]];
+	Packets[i].rbytes   = HaloCompressor::CompressedBytes<FaceReal>(HaloCompression,Packets[i].rbytes);
+      }
+    }
+  }
+  void FaceDecompress(void)
+  {
+    if ( FaceOriginalPackets.size()==0 ) return;
+    for(int i=0;i<Packets.size();i++){
+      Packet &o = FaceOriginalPackets[i];
+      if ( Packets[i].recv_buf != o.recv_buf ) {
+	HaloCompressor::Decompress<FaceReal>(HaloCompression,Packets[i].recv_buf,o.recv_buf,o.rbytes);
+      }
+    }
+    Packets = FaceOriginalPackets;
+    FaceOriginalPackets.resize(0);
+  }
+
   ////////////////////////////////////////
   // Stencil query
   ////////////////////////////////////////
@@ -370,14 +500,26 @@ public:
     //    accelerator_barrier();     // All kernels should ALREADY be complete
     //    _grid->StencilBarrier();   // Everyone is here, so noone running slow and still using receive buffer
                                // But the HaloGather had a barrier too.
+    FaceCompress();
 #ifdef ACCELERATOR_AWARE_MPI
-    for(int i=0;i<Packets.size();i++){
-      _grid->StencilSendToRecvFromBegin(MpiReqs,
-					Packets[i].send_buf,
+    if ( Stencil_persistent_comms ) {
+      PersistentRegister();
+      for(int i=0;i<Packets.size();i++){
+	_grid->StencilSendToRecvFromShm(Packets[i].send_buf,
 					Packets[i].to_rank,Packets[i].do_send,
 					Packets[i].recv_buf,
-					Packets[i].from_rank,Packets[i].do_recv,
-					Packets[i].xbytes,Packets[i].rbytes,i);
+					Packets[i].xbytes);
+      }
+      _grid->StencilPersistentStart(PersistentReqs);
+    } else {
+      for(int i=0;i<Packets.size();i++){
+	_grid->StencilSendToRecvFromBegin(MpiReqs,
+					  Packets[i].send_buf,
+					  Packets[i].to_rank,Packets[i].do_send,
+					  Packets[i].recv_buf,
+					  Packets[i].from_rank,Packets[i].do_recv,
+					  Packets[i].xbytes,Packets[i].rbytes,i);
+      }
     }
 #else
 #warning "Using COPY VIA HOST BUFFERS IN STENCIL"
@@ -406,6 +548,10 @@ public:
 
   void CommunicateComplete(std::vector<std::vector<CommsRequest_t> > &reqs)
   {
+#ifdef ACCELERATOR_AWARE_MPI
+    if ( Stencil_persistent_comms ) _grid->StencilPersistentComplete(PersistentReqs); // requests stay registered
+    else
+#endif
     _grid->StencilSendToRecvFromComplete(MpiReqs,0); // MPI is done
     if   ( this->partialDirichlet ) DslashLogPartial();
     else if ( this->fullDirichlet ) DslashLogDirichlet();
@@ -427,6 +573,7 @@ public:
       if ( Packets[i].do_recv )
 	FlightRecorder::recvLog(Packets[i].recv_buf,Packets[i].rbytes,Packets[i].from_rank);
     }
+    FaceDecompress();
   }
   ////////////////////////////////////////////////////////////////////////
   // Blocking send and receive. Either sequential or parallel.
@@ -593,7 +740,7 @@ public:
   void AddPacket(void *xmit,void * rcv,
 		 Integer to, Integer do_send,
 		 Integer from, Integer do_recv,
-		 Integer xbytes,Integer rbytes){
+		 Integer xbytes,Integer rbytes,Integer compress=0){
     Packet p;
     p.send_buf = xmit;
     p.recv_buf = rcv;
@@ -603,6 +750,7 @@ public:
     p.do_recv  = do_recv;
     p.xbytes    = xbytes;
     p.rbytes    = rbytes;
+    p.compress  = compress;
     //    if (do_send) std::cout << GridLogMessage << " MPI packet to   "<<to<< " of size "<<xbytes<<std::endl;
     //    if (do_recv) std::cout << GridLogMessage << " MPI packet from "<<from<< " of size "<<xbytes<<std::endl;
     Packets.push_back(p);
@@ -732,6 +880,12 @@ public:
       }
     }
   }
+  ~CartesianStencil() { PersistentFree(); }
+
+  // The registered persistent requests are owned and freed here
+  CartesianStencil(const CartesianStencil &) = delete;
+  CartesianStencil & operator=(const CartesianStencil &) = delete;
+
   CartesianStencil(GridBase *grid,
 		   int npoints,
 		   int checkerboard,
@@ -1200,11 +1354,13 @@ public:
 	  ///////////////////////////////////////////////////////////
 	  int do_send = (comms_send|comms_partial_send) && (!shm_send );
 	  int do_recv = (comms_send|comms_partial_send) && (!shm_recv );
+	  // Partial dirichlet packets are already reduced precision
+	  int face_compress = CompressorFaceCompression<compressor>::value && !comms_partial_send && !comms_partial_recv;
 	  AddPacket((void *)&send_buf[comm_off],
 		    (void *)&recv_buf[comm_off],
 		    xmit_to_rank, do_send,
 		    recv_from_rank, do_recv,
-		    xbytes,rbytes);
+		    xbytes,rbytes,face_compress);
 	}
 
 	if ( (compress.DecompressionStep() && comms_recv) || comms_partial_recv ) {
@@ -1383,10 +1539,11 @@ public:
 		acceleratorMemSet(rp,0,bytes); // Zero prefill comms buffer to zero
 	      }
 	      int do_send = (comms_send|comms_partial_send) && (!shm_send );
+	      int face_compress = CompressorFaceCompression<compressor>::value && !comms_partial_send && !comms_partial_recv;
 	      AddPacket((void *)sp,(void *)rp,
 			xmit_to_rank,do_send,
 			recv_from_rank,do_send,
-			xbytes,rbytes);
+			xbytes,rbytes,face_compress);
 	    }
 
 	  } else {
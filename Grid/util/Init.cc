@@ -467,10 +467,18 @@ void Grid_init(int *argc,char ***argv)
     std::cout<<GridLogMessage<<"  --comms-concurrent : Asynchronous MPI calls; several dirs at a time "<<std::endl;    
     std::cout<<GridLogMessage<<"  --comms-sequential : Synchronous MPI calls; one dirs at a time "<<std::endl;    
     std::cout<<GridLogMessage<<"  --comms-overlap    : Overlap comms with compute "<<std::endl;    
+    std::cout<<GridLogMessage<<"  --comms-persistent : Register stencil halo exchanges once; restart with MPI_Startall "<<std::endl;    
+    std::cout<<GridLogMessage<<"  --comms-compression none|fp16|bf16 : Compress off node halos of staggered and coarse grid operators "<<std::endl;    
+    std::cout<<GridLogMessage<<"  --comms-compression-check : Measure the halo compression error (slow) "<<std::endl;    
+    std::cout<<GridLogMessage<<"  --comms-thread-multiple : Initialise MPI with MPI_THREAD_MULTIPLE (asynchronous checkpoints) "<<std::endl;    
     std::cout<<GridLogMessage<<std::endl;
     std::cout<<GridLogMessage<<"  --dslash-generic: Wilson kernel for generic Nc"<<std::endl;    
     std::cout<<GridLogMessage<<"  --dslash-unroll : Wilson kernel for Nc=3"<<std::endl;    
     std::cout<<GridLogMessage<<"  --dslash-asm    : Wilson kernel for AVX512"<<std::endl;    
+    std::cout<<GridLogMessage<<"  --dslash-autotune : time kernel, overlap and blocking choices per 5d geometry"<<std::endl;    
+    std::cout<<GridLogMessage<<"  --dslash-plan-cache file : file storing autotuned plans (WilsonKernelsPlans.xml)"<<std::endl;    
+    std::cout<<GridLogMessage<<std::endl;
+    std::cout<<GridLogMessage<<"  --io-chunk M    : lattice I/O pipelined in chunks of M megabytes; 0 for a single transfer"<<std::endl;    
     std::cout<<GridLogMessage<<std::endl;
     std::cout<<GridLogMessage<<"  --lebesgue      : Cache oblivious Lebesgue curve/Morton order/Z-graph stencil looping"<<std::endl;    
     std::cout<<GridLogMessage<<"  --cacheblocking n.m.o.p : Hypercuboidal cache blocking"<<std::endl;    
@@ -494,6 +502,12 @@ void Grid_init(int *argc,char ***argv)
     WilsonKernelsStatic::Opt=WilsonKernelsStatic::OptGeneric;
     StaggeredKernelsStatic::Opt=StaggeredKernelsStatic::OptGeneric;
   }
+  if( GridCmdOptionExists(*argv,*argv+*argc,"--dslash-autotune") ){
+    WilsonKernelsStatic::Autotune=1;
+  }
+  if( GridCmdOptionExists(*argv,*argv+*argc,"--dslash-plan-cache") ){
+    WilsonKernelsPlanCache::filename = GridCmdOptionPayload(*argv,*argv+*argc,"--dslash-plan-cache");
+  }
   if( GridCmdOptionExists(*argv,*argv+*argc,"--comms-overlap") ){
     WilsonKernelsStatic::Comms = WilsonKernelsStatic::CommsAndCompute;
     StaggeredKernelsStatic::Comms = StaggeredKernelsStatic::CommsAndCompute;
@@ -504,6 +518,27 @@ void Grid_init(int *argc,char ***argv)
   if( GridCmdOptionExists(*argv,*argv+*argc,"--comms-concurrent") ){
     CartesianCommunicator::SetCommunicatorPolicy(CartesianCommunicator::CommunicatorPolicyConcurrent);
   }
+  if( GridCmdOptionExists(*argv,*argv+*argc,"--comms-persistent") ){
+#ifndef ACCELERATOR_AWARE_MPI
+    std::cout << GridLogWarning << "'--comms-persistent' option used but Grid was"
+              << " compiled without accelerator aware MPI; halos are staged through"
+              << " host buffers and sent without persistent requests" << std::endl;
+#endif
+    Stencil_persistent_comms = true;
+  }
+  if( GridCmdOptionExists(*argv,*argv+*argc,"--comms-compression") ){
+    Stencil_halo_compression = HaloCompressor::Mode(GridCmdOptionPayload(*argv,*argv+*argc,"--comms-compression"));
+  }
+  if( GridCmdOptionExists(*argv,*argv+*argc,"--comms-compression-check") ){
+    Stencil_halo_compression_check = 1;
+  }
+  if( GridCmdOptionExists(*argv,*argv+*argc,"--io-chunk") ){
+    int MB;
+    arg= GridCmdOptionPayload(*argv,*argv+*argc,"--io-chunk");
+    GridCmdOptionInt(arg,MB);
+    assert(MB>=0);
+    BinaryIO::chunkBytes = (uint64_t)MB*1024*1024;
+  }
   if( GridCmdOptionExists(*argv,*argv+*argc,"--comms-sequential") ){
     CartesianCommunicator::SetCommunicatorPolicy(CartesianCommunicator::CommunicatorPolicySequential);
   }
@@ -68,6 +68,7 @@ int main (int argc, char ** argv)
   unsigned int                 nRelVol = (BENCH_IO_LMAX - 24)/2 + 1;
   std::vector<Eigen::MatrixXd> perf(BENCH_IO_NPASS, Eigen::MatrixXd::Zero(nVol, 4));
   std::vector<Eigen::VectorXd> avPerf(BENCH_IO_NPASS, Eigen::VectorXd::Zero(4));
+  Eigen::MatrixXd              stage = Eigen::MatrixXd::Zero(nVol, 4); // convert and wait % of Grid write, read
   std::vector<int>             latt;
 
   MSG << "Grid is setup to use " << threads << " threads" << std::endl;
@@ -112,6 +113,8 @@ int main (int argc, char ** argv)
       MSG << "-- Local volume " << l << "^4" << std::endl;
       writeBenchmark<LatticeFermion>(latt, filestem(l), limeWrite<LatticeFermion>);
       perf[i](volInd(l), gWrite) = BinaryIO::lastPerf.mbytesPerSecond;
+      stage(volInd(l), 0) += 100.*BinaryIO::lastPerf.convertTime/BinaryIO::lastPerf.time/BENCH_IO_NPASS;
+      stage(volInd(l), 1) += 100.*BinaryIO::lastPerf.waitTime/BinaryIO::lastPerf.time/BENCH_IO_NPASS;
     }
 
     MSG << SEP << std::endl;
@@ -124,6 +127,8 @@ int main (int argc, char ** argv)
       MSG << "-- Local volume " << l << "^4" << std::endl;
       readBenchmark<LatticeFermion>(latt, filestem(l), limeRead<LatticeFermion>);
       perf[i](volInd(l), gRead) = BinaryIO::lastPerf.mbytesPerSecond;
+      stage(volInd(l), 2) += 100.*BinaryIO::lastPerf.convertTime/BinaryIO::lastPerf.time/BENCH_IO_NPASS;
+      stage(volInd(l), 3) += 100.*BinaryIO::lastPerf.waitTime/BinaryIO::lastPerf.time/BENCH_IO_NPASS;
     }
 #endif
     avPerf[i].fill(0.);
@@ -175,6 +180,18 @@ int main (int argc, char ** argv)
                 rob(volInd(l), gRead), rob(volInd(l), gWrite));
   }
   MSG << std::endl;
+  MSG << "Stage breakdown of Grid I/O, in % of the I/O call (chunks of " << BinaryIO::chunkBytes/1024/1024 << " MB)." << std::endl;
+  MSG << "Convert is the fused byte swap and checksum pass; wait is time blocked on the file system." << std::endl;
+  MSG << std::endl;
+  grid_printf("%4s %12s %12s %12s %12s\n",
+              "L", "wr convert", "wr wait", "rd convert", "rd wait");
+  for (int l = BENCH_IO_LMIN; l <= BENCH_IO_LMAX; l += 2)
+  {
+    grid_printf("%4d %12.1f %12.1f %12.1f %12.1f\n",
+                l, stage(volInd(l), 0), stage(volInd(l), 1),
+                stage(volInd(l), 2), stage(volInd(l), 3));
+  }
+  MSG << std::endl;
   MSG << "Summary of results averaged over local volumes 24^4-" << BENCH_IO_LMAX << "^4 (all results in MB/s)." << std::endl;
   MSG << "Every second colum gives the standard deviation of the previous column." << std::endl;
   MSG << std::endl;
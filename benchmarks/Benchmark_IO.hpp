@@ -155,6 +155,16 @@ void stdRead(Field &vec, const std::string filestem)
   MSG << "Std I/O read: checksum overhead " << crcWatch.Elapsed() << std::endl;
 }
 
+// Stage breakdown of the last BinaryIO::IOobject call
+inline void stageReport(const std::string &what)
+{
+  auto &p = BinaryIO::lastPerf;
+
+  MSG << what << ": " << p.chunks << " chunks, total " << p.time/1.e3 << " ms = "
+      << "munge " << p.mungeTime/1.e3 << " ms, convert+checksum " << p.convertTime/1.e3 << " ms, waiting on I/O "
+      << p.waitTime/1.e3 << " ms, checksum reduction " << p.reduceTime/1.e3 << " ms" << std::endl;
+}
+
 template <typename Field>
 void limeWrite(const std::string filestem, Field &vec)
 {
@@ -164,6 +174,7 @@ void limeWrite(const std::string filestem, Field &vec)
   binWriter.open(filestem + ".lime.bin");
   binWriter.writeScidacFieldRecord(vec, record);
   binWriter.close();
+  stageReport("Grid I/O write");
 }
 
 template <typename Field>
@@ -175,6 +186,7 @@ void limeRead(Field &vec, const std::string filestem)
   binReader.open(filestem + ".lime.bin");
   binReader.readScidacFieldRecord(vec, record);
   binReader.close();
+  stageReport("Grid I/O read");
 }
 
 inline void makeGrid(std::shared_ptr<GridBase> &gPt, 
@@ -0,0 +1,142 @@
+ /*************************************************************************************
+    Grid physics library, www.github.com/paboyle/Grid
+    Source file: ./benchmarks/Benchmark_dwf_mrhs.cc
+    Copyright (C) 2015
+
+    Author: Peter Boyle <paboyle@ph.ed.ac.uk>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+    See the full license in the file "LICENSE" in the top level distribution directory
+    *************************************************************************************/
+    /*  END LEGAL */
+#include <Grid/Grid.h>
+
+using namespace std;
+using namespace Grid;
+
+int main (int argc, char ** argv)
+{
+  Grid_init(&argc,&argv);
+
+  int threads = GridThread::GetThreads();
+
+  int Ls=8;
+  int nrhs=12;
+  int ncall=100;
+  for(int i=0;i<argc;i++) {
+    if(std::string(argv[i]) == "-Ls"){
+      std::stringstream ss(argv[i+1]); ss >> Ls;
+    }
+    if(std::string(argv[i]) == "-nrhs"){
+      std::stringstream ss(argv[i+1]); ss >> nrhs;
+    }
+    if(std::string(argv[i]) == "-ncall"){
+      std::stringstream ss(argv[i+1]); ss >> ncall;
+    }
+  }
+
+  GridLogLayout();
+
+  long unsigned int single_site_flops = 8*Nc*(7+16*Nc);
+
+  GridCartesian         * UGrid   = SpaceTimeGrid::makeFourDimGrid(GridDefaultLatt(), GridDefaultSimd(Nd,vComplex::Nsimd()),GridDefaultMpi());
+  GridRedBlackCartesian * UrbGrid = SpaceTimeGrid::makeFourDimRedBlackGrid(UGrid);
+  GridCartesian         * FGrid   = SpaceTimeGrid::makeFiveDimGrid(Ls,UGrid);
+  GridRedBlackCartesian * FrbGrid = SpaceTimeGrid::makeFiveDimRedBlackGrid(Ls,UGrid);
+
+  GridParallelRNG          RNG4(UGrid);  RNG4.SeedUniqueString(std::string("The 4D RNG"));
+  GridParallelRNG          RNG5(FGrid);  RNG5.SeedUniqueString(std::string("The 5D RNG"));
+
+  LatticeGaugeField Umu(UGrid);
+  SU<Nc>::HotConfiguration(RNG4,Umu);
+
+  RealD mass=0.1;
+  RealD M5  =1.8;
+  DomainWallFermionD Dw(Umu,*FGrid,*FrbGrid,*UGrid,*UrbGrid,mass,M5);
+
+  GridRedBlackCartesian * SFrbGrid = Dw.MRHSRedBlackGrid(nrhs);
+
+  LatticeFermion src(FGrid);
+  std::vector<LatticeFermion> src_e(nrhs,FrbGrid);
+  std::vector<LatticeFermion> res_o(nrhs,FrbGrid);
+  std::vector<LatticeFermion> ref_o(nrhs,FrbGrid);
+  for(int r=0;r<nrhs;r++){
+    random(RNG5,src);
+    pickCheckerboard(Even,src_e[r],src);
+  }
+
+  LatticeFermion ssrc(SFrbGrid);
+  LatticeFermion sres(SFrbGrid);
+  Dw.ImportMRHS(src_e,ssrc);
+
+  RealD NP = UGrid->_Nprocessors;
+  RealD NN = UGrid->NodeCount();
+  RealD volume=Ls;
+  Coordinate latt4 = GridDefaultLatt();
+  for(int mu=0;mu<Nd;mu++) volume=volume*latt4[mu];
+  RealD flops = single_site_flops*volume*nrhs/2.0;
+
+  std::cout << GridLogMessage<< "*****************************************************************" <<std::endl;
+  std::cout << GridLogMessage<< "* Benchmarking DomainWallFermionD::DhopOE with "<<nrhs<<" right hand sides"<<std::endl;
+  std::cout << GridLogMessage<< "* Vol "<<latt4<<" Ls "<<Ls<<" threads "<<threads<<" ranks "<<NP<<std::endl;
+  std::cout << GridLogMessage<< "*****************************************************************" <<std::endl;
+
+  // One source at a time: gauge field streamed and halo exchanged nrhs times
+  for(int r=0;r<nrhs;r++) Dw.DhopOE(src_e[r],ref_o[r],DaggerNo);
+  FGrid->Barrier();
+  double t0=usecond();
+  for(int i=0;i<ncall;i++){
+    for(int r=0;r<nrhs;r++) Dw.DhopOE(src_e[r],ref_o[r],DaggerNo);
+  }
+  FGrid->Barrier();
+  double t1=usecond();
+  double single = (t1-t0)/ncall;
+
+  // Stacked sources: one gauge field pass, one halo exchange
+  Dw.DhopOEMRHS(ssrc,sres,DaggerNo);
+  FGrid->Barrier();
+  t0=usecond();
+  for(int i=0;i<ncall;i++){
+    Dw.DhopOEMRHS(ssrc,sres,DaggerNo);
+  }
+  FGrid->Barrier();
+  t1=usecond();
+  double stacked = (t1-t0)/ncall;
+
+  Dw.ExportMRHS(sres,res_o);
+  RealD maxerr=0.0;
+  for(int r=0;r<nrhs;r++){
+    LatticeFermion err(FrbGrid);
+    err = res_o[r]-ref_o[r];
+    maxerr = std::max(maxerr,norm2(err)/norm2(ref_o[r]));
+  }
+  std::cout << GridLogMessage << "Max relative deviation stacked vs single "<< maxerr<<std::endl;
+  assert(maxerr < 1.0e-10);
+
+  // Doubled gauge field bytes read per application of DhopOE
+  RealD gauge_bytes = 8.0*Nc*Nc*sizeof(Complex)*volume/Ls/2.0;
+
+  std::cout << GridLogMessage << "Single RHS x "<<nrhs<<" : "<<single <<" us "
+	    << flops/single<<" Mflop/s = "<< flops/single/NN<<" Mflop/s per node"<<std::endl;
+  std::cout << GridLogMessage << "Stacked RHS  x "<<nrhs<<" : "<<stacked<<" us "
+	    << flops/stacked<<" Mflop/s = "<< flops/stacked/NN<<" Mflop/s per node"<<std::endl;
+  std::cout << GridLogMessage << "Gauge field traffic single  "<< nrhs*gauge_bytes/1.0e6 <<" MB per sweep"<<std::endl;
+  std::cout << GridLogMessage << "Gauge field traffic stacked "<< gauge_bytes/1.0e6 <<" MB per sweep"<<std::endl;
+  std::cout << GridLogMessage << "Speedup "<< single/stacked<<std::endl;
+
+  Grid_finalize();
+  exit(0);
+}
@@ -126,6 +126,38 @@ int main (int argc, char ** argv)
 
   }
 
+  std::cout << GridLogMessage<< "*********************************************************" <<std::endl;
+  std::cout << GridLogMessage<< "* Benchmarking DomainWallFermionF::HaloExchangeOpt per-call vs persistent"<<std::endl;
+  std::cout << GridLogMessage<< "*********************************************************" <<std::endl;
+  {
+    bool saved = Stencil_persistent_comms;
+    typename DomainWallFermionF::Compressor compressor(0);
+    LatticeFermionF ref(FGrid);
+    LatticeFermionF res(FGrid);
+    LatticeFermionF err(FGrid);
+    double usec[2];
+    for(int persist=0;persist<2;persist++){
+      Stencil_persistent_comms = persist;
+      Dw.Stencil.HaloExchangeOpt(src,compressor);
+      FGrid->Barrier();
+      double t0=usecond();
+      for(int i=0;i<ncall;i++){
+	Dw.Stencil.HaloExchangeOpt(src,compressor);
+      }
+      FGrid->Barrier();
+      double t1=usecond();
+      usec[persist] = (t1-t0)/ncall;
+      Dw.Dhop(src,persist ? res : ref,DaggerNo);
+    }
+    Stencil_persistent_comms = saved;
+
+    err = res - ref;
+    std::cout<<GridLogMessage << "Per-call   exchange us /call = "<< usec[0]<<std::endl;
+    std::cout<<GridLogMessage << "Persistent exchange us /call = "<< usec[1]<<std::endl;
+    std::cout<<GridLogMessage << "Dhop deviation persistent vs per-call "<< norm2(err)<<std::endl;
+    assert(norm2(err)==0.0);
+  }
+
   Grid_finalize();
   exit(0);
 }
@@ -0,0 +1,111 @@
+    /*************************************************************************************
+
+    Grid physics library, www.github.com/paboyle/Grid
+
+    Source file: ./tests/IO/Test_hdf5_stream.cc
+
+    Copyright (C) 2015
+
+Author: Peter Boyle <paboyle@ph.ed.ac.uk>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+    See the full license in the file "LICENSE" in the top level distribution directory
+    *************************************************************************************/
+    /*  END LEGAL */
+#include <Grid/Grid.h>
+
+using namespace Grid;
+
+int main (int argc, char ** argv)
+{
+  Grid_init(&argc,&argv);
+
+#ifdef HAVE_HDF5
+  const size_t N0=3, N1=10, N2=7, blk=4;
+  std::vector<ComplexD> ref(N0*N1*N2);
+  for(size_t i=0;i<ref.size();i++) ref[i] = ComplexD(i,-2.0*i);
+
+  std::string file("stream_test.h5");
+  {
+    Hdf5Writer WR(file);
+
+    // Pre-sized dataset written in blocks, including ragged edge blocks
+    Hdf5DataSetStream<ComplexD> blocked(WR.getGroup(),"blocked",{N0,N1,N2},{1,blk,blk},6,true);
+    std::vector<ComplexD> buf;
+    for(size_t i1=0;i1<N1;i1+=blk){
+    for(size_t i2=0;i2<N2;i2+=blk){
+      size_t n1=std::min(blk,N1-i1), n2=std::min(blk,N2-i2);
+      buf.resize(N0*n1*n2);
+      for(size_t a=0;a<N0;a++){
+      for(size_t b=0;b<n1;b++){
+      for(size_t c=0;c<n2;c++){
+	buf[(a*n1+b)*n2+c] = ref[(a*N1+i1+b)*N2+i2+c];
+      }}}
+      blocked.writeBlock({0,i1,i2},{N0,n1,n2},&buf[0]);
+    }}
+    blocked.flush();
+
+    // Unlimited leading dimension, one slab per append
+    Hdf5DataSetStream<ComplexD> series(WR.getGroup(),"series",{0,N1,N2},{1,N1,N2});
+    series.append(&ref[0],1);
+    assert(series.size()==1);
+
+    // The same in a group
+    WR.push("run");
+    Hdf5DataSetStream<ComplexD> grouped(WR.getGroup(),"series",{0,N1,N2},{1,N1,N2});
+    grouped.append(&ref[0],1);
+    WR.pop();
+  }
+  {
+    // Reopen and continue appending
+    Hdf5Writer WR(file,true);
+    Hdf5DataSetStream<ComplexD> series(WR.getGroup(),"series",{0,N1,N2},{1,N1,N2});
+    assert(series.size()==1);
+    series.append(&ref[N1*N2],N0-1);
+    assert(series.size()==N0);
+
+    // The existing group is reopened, not created again
+    WR.push("run");
+    Hdf5DataSetStream<ComplexD> grouped(WR.getGroup(),"series",{0,N1,N2},{1,N1,N2});
+    assert(grouped.size()==1);
+    grouped.append(&ref[N1*N2],N0-1);
+    assert(grouped.size()==N0);
+    WR.pop();
+  }
+  {
+    Hdf5Reader RD(file);
+    auto check = [&](const std::string &name){
+      std::vector<ComplexD> data;
+      std::vector<size_t>   dim;
+      RD.readMultiDim(name,data,dim);
+      std::cout << GridLogMessage << name << " dims " << dim << std::endl;
+      assert(dim==std::vector<size_t>({N0,N1,N2}));
+      for(size_t i=0;i<ref.size();i++) assert(data[i]==ref[i]);
+    };
+    check("blocked");
+    check("series");
+    RD.push("run");
+    check("series");
+    RD.pop();
+  }
+  std::remove(file.c_str());
+  std::cout << GridLogMessage << "Hdf5DataSetStream OK" << std::endl;
+#else
+  std::cout << GridLogMessage << "Grid built without HDF5, nothing to test" << std::endl;
+#endif
+
+  Grid_finalize();
+}
@@ -0,0 +1,78 @@
+    /*************************************************************************************
+
+    Grid physics library, www.github.com/paboyle/Grid
+
+    Source file: ./tests/Test_deflated_guesser_batched.cc
+
+    Copyright (C) 2015
+
+Author: Peter Boyle <paboyle@ph.ed.ac.uk>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+    See the full license in the file "LICENSE" in the top level distribution directory
+    *************************************************************************************/
+    /*  END LEGAL */
+#include <Grid/Grid.h>
+
+using namespace Grid;
+
+int main (int argc, char ** argv)
+{
+  Grid_init(&argc,&argv);
+
+  GridCartesian * UGrid = SpaceTimeGrid::makeFourDimGrid(GridDefaultLatt(), GridDefaultSimd(Nd,vComplexD::Nsimd()),GridDefaultMpi());
+
+  GridParallelRNG RNG(UGrid);  RNG.SeedFixedIntegers(std::vector<int>({1,2,3,4}));
+
+  const int Nevec = 40;
+  const int nrhs  = 6;
+
+  std::vector<LatticeFermionD> evec(Nevec,UGrid);
+  std::vector<RealD>           eval(Nevec);
+  for(int i=0;i<Nevec;i++){
+    random(RNG,evec[i]);
+    eval[i] = 1.0+0.1*i;
+  }
+
+  std::vector<LatticeFermionD> src(nrhs,UGrid);
+  std::vector<LatticeFermionD> ref(nrhs,UGrid);
+  std::vector<LatticeFermionD> guess(nrhs,UGrid);
+  LatticeFermionD diff(UGrid);
+  for(int r=0;r<nrhs;r++) random(RNG,src[r]);
+
+  DeflatedGuesser<LatticeFermionD> Guesser(evec,eval);
+
+  // One source at a time
+  for(int r=0;r<nrhs;r++) Guesser(src[r],ref[r]);
+
+  // Streamed in batches, and with the whole basis packed and kept
+  std::vector<int> batches({16,Nevec});
+  for(auto b : batches){
+    Guesser.EvecBatch = b;
+    for(int pass=0;pass<2;pass++){
+      Guesser(src,guess);
+      for(int r=0;r<nrhs;r++){
+	RealD rel = std::sqrt(axpy_norm(diff,-1.0,ref[r],guess[r])/norm2(ref[r]));
+	std::cout << GridLogMessage << "batch "<<b<<" pass "<<pass<<" source "<<r<<" relative difference "<<rel<<std::endl;
+	assert(rel < 1.0e-12);
+      }
+    }
+  }
+
+  std::cout << GridLogMessage << "Batched DeflatedGuesser OK" << std::endl;
+
+  Grid_finalize();
+}
@@ -0,0 +1,92 @@
+    /*************************************************************************************
+
+    Grid physics library, www.github.com/paboyle/Grid
+
+    Source file: ./tests/core/Test_dwf_autotune.cc
+
+    Copyright (C) 2015
+
+Author: Peter Boyle <paboyle@ph.ed.ac.uk>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+    See the full license in the file "LICENSE" in the top level distribution directory
+    *************************************************************************************/
+    /*  END LEGAL */
+#include <Grid/Grid.h>
+
+using namespace std;
+using namespace Grid;
+
+int main (int argc, char ** argv)
+{
+  Grid_init(&argc,&argv);
+
+  const int Ls=8;
+  GridCartesian         * UGrid   = SpaceTimeGrid::makeFourDimGrid(GridDefaultLatt(), GridDefaultSimd(Nd,vComplex::Nsimd()),GridDefaultMpi());
+  GridCartesian         * FGrid   = SpaceTimeGrid::makeFiveDimGrid(Ls,UGrid);
+  GridRedBlackCartesian * UrbGrid = SpaceTimeGrid::makeFourDimRedBlackGrid(UGrid);
+  GridRedBlackCartesian * FrbGrid = SpaceTimeGrid::makeFiveDimRedBlackGrid(Ls,UGrid);
+
+  std::vector<int> seeds4({1,2,3,4});
+  std::vector<int> seeds5({5,6,7,8});
+
+  GridParallelRNG          RNG4(UGrid);  RNG4.SeedFixedIntegers(seeds4);
+  GridParallelRNG          RNG5(FGrid);  RNG5.SeedFixedIntegers(seeds5);
+
+  LatticeGaugeField Umu(UGrid); SU<Nc>::HotConfiguration(RNG4,Umu);
+  LatticeFermion src   (FGrid); random(RNG5,src);
+  LatticeFermion src_e (FrbGrid);
+  LatticeFermion ref   (FrbGrid);
+  LatticeFermion res   (FrbGrid);
+  LatticeFermion err   (FrbGrid);
+
+  pickCheckerboard(Even,src_e,src);
+
+  RealD mass=0.1;
+  RealD M5  =1.8;
+
+  std::cout<<GridLogMessage<<"=========================================================="<<std::endl;
+  std::cout<<GridLogMessage<<"= Reference Dhop with the default kernel selection"<<std::endl;
+  std::cout<<GridLogMessage<<"=========================================================="<<std::endl;
+  WilsonKernelsStatic::Autotune = 0;
+  DomainWallFermionD Dref(Umu,*FGrid,*FrbGrid,*UGrid,*UrbGrid,mass,M5);
+  Dref.DhopOE(src_e,ref,DaggerNo);
+
+  std::cout<<GridLogMessage<<"=========================================================="<<std::endl;
+  std::cout<<GridLogMessage<<"= Autotuned Dhop, plans written to "<<WilsonKernelsPlanCache::filename<<std::endl;
+  std::cout<<GridLogMessage<<"=========================================================="<<std::endl;
+  WilsonKernelsStatic::Autotune = 1;
+  DomainWallFermionD Dtuned(Umu,*FGrid,*FrbGrid,*UGrid,*UrbGrid,mass,M5);
+  Dtuned.DhopOE(src_e,res,DaggerNo);
+  err = res - ref;
+  std::cout<<GridLogMessage << "Autotuned norm diff "<< norm2(err)<<std::endl;
+  assert(norm2(err) < 1.0e-10*norm2(ref));
+
+  std::cout<<GridLogMessage<<"=========================================================="<<std::endl;
+  std::cout<<GridLogMessage<<"= Second operator must pick up the cached plan"<<std::endl;
+  std::cout<<GridLogMessage<<"=========================================================="<<std::endl;
+  DomainWallFermionD Dcached(Umu,*FGrid,*FrbGrid,*UGrid,*UrbGrid,mass,M5);
+  assert(Dcached.Plan.key   == Dtuned.Plan.key);
+  assert(Dcached.Plan.Opt   == Dtuned.Plan.Opt);
+  assert(Dcached.Plan.Comms == Dtuned.Plan.Comms);
+  assert(Dcached.Plan.Block == Dtuned.Plan.Block);
+  Dcached.DhopOE(src_e,res,DaggerNo);
+  err = res - ref;
+  std::cout<<GridLogMessage << "Cached plan norm diff "<< norm2(err)<<std::endl;
+  assert(norm2(err) < 1.0e-10*norm2(ref));
+
+  Grid_finalize();
+}
@@ -0,0 +1,186 @@
+    /*************************************************************************************
+
+    Grid physics library, www.github.com/paboyle/Grid
+
+    Source file: ./tests/core/Test_fft_pencil.cc
+
+    Copyright (C) 2023
+
+Author: Peter Boyle <paboyle@ph.ed.ac.uk>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+    See the full license in the file "LICENSE" in the top level distribution directory
+    *************************************************************************************/
+    /*  END LEGAL */
+#include <Grid/Grid.h>
+
+using namespace Grid;
+
+///////////////////////////////////////////////////////////////////////
+// The barrel shift FFT_dim that the pencil transpose replaced: every
+// node Cshifts the field round the row, assembles all the global pencils
+// through its sites and transforms them with an FFTW_ESTIMATE plan.
+///////////////////////////////////////////////////////////////////////
+template<class vobj>
+void BarrelFFT_dim(Lattice<vobj> &result,const Lattice<vobj> &source,int dim,int sign)
+{
+#ifdef HAVE_FFTW
+  GridCartesian *vgrid = (GridCartesian *)source.Grid();
+  int Nd = vgrid->_ndimension;
+  Coordinate processors = vgrid->_processors;
+  Coordinate layout(Nd,1);
+  GridCartesian sgrid(vgrid->_fdimensions,layout,processors,*vgrid);
+
+  int L = vgrid->_ldimensions[dim];
+  int G = vgrid->_fdimensions[dim];
+
+  Coordinate pencil_gd(vgrid->_fdimensions);
+  pencil_gd[dim] = G*processors[dim];
+  GridCartesian pencil_g(pencil_gd,layout,processors,*vgrid);
+  uint64_t lsites = sgrid.lSites();
+  uint64_t psites = pencil_g.lSites();
+
+  typedef typename vobj::scalar_object sobj;
+  typedef typename sobj::scalar_type   scalar;
+  typedef typename FFTW<scalar>::FFTW_scalar FFTW_scalar;
+  typedef typename FFTW<scalar>::FFTW_plan   FFTW_plan;
+
+  Lattice<sobj> pgbuf(&pencil_g);
+  autoView(pgbuf_v , pgbuf, CpuWrite);
+
+  int Ncomp = sizeof(sobj)/sizeof(scalar);
+  int Nlow  = 1;
+  for(int d=0;d<dim;d++) Nlow*=vgrid->_ldimensions[d];
+
+  int n[] = {G};
+  scalar div = (sign == FFT::backward) ? scalar(1.0/G) : scalar(1.0);
+
+  FFTW_scalar *buf = (FFTW_scalar *)&pgbuf_v[0];
+  FFTW_plan p = FFTW<scalar>::fftw_plan_many_dft(1,n,Ncomp,
+						 buf,n,Ncomp*Nlow,1,
+						 buf,n,Ncomp*Nlow,1,
+						 sign,FFTW_ESTIMATE);
+
+  result = source;
+  int pc = vgrid->_processor_coor[dim];
+  for(int q=0;q<processors[dim];q++) {
+    {
+      autoView(r_v,result,CpuRead);
+      thread_for(idx, lsites,{
+        Coordinate cbuf(Nd);
+        sobj s;
+	sgrid.LocalIndexToLocalCoor(idx,cbuf);
+	peekLocalSite(s,r_v,cbuf);
+	cbuf[dim]+=((pc+q) % processors[dim])*L;
+	pokeLocalSite(s,pgbuf_v,cbuf);
+      });
+    }
+    if (q != processors[dim] - 1) result = Cshift(result,dim,L);
+  }
+
+  thread_for(idx,psites,{
+    Coordinate cbuf(Nd);
+    pencil_g.LocalIndexToLocalCoor(idx, cbuf);
+    if ( cbuf[dim] == 0 ) {
+      FFTW_scalar *in = (FFTW_scalar *)&pgbuf_v[idx];
+      FFTW<scalar>::fftw_execute_dft(p,in,in);
+    }
+  });
+
+  {
+    autoView(result_v,result,CpuWrite);
+    thread_for(idx,lsites,{
+      Coordinate clbuf(Nd), cgbuf(Nd);
+      sobj s;
+      sgrid.LocalIndexToLocalCoor(idx,clbuf);
+      cgbuf = clbuf;
+      cgbuf[dim] = clbuf[dim]+L*pc;
+      peekLocalSite(s,pgbuf_v,cgbuf);
+      pokeLocalSite(s,result_v,clbuf);
+    });
+  }
+  result = result*div;
+
+  FFTW<scalar>::fftw_destroy_plan(p);
+#endif
+}
+
+template<class Field>
+void Compare(GridCartesian *grid,GridParallelRNG &RNG,const std::string &name,RealD tol)
+{
+  Field src(grid), pencil(grid), barrel(grid), diff(grid);
+  random(RNG,src);
+
+  FFT theFFT(grid);
+  for(int sign : {FFT::forward,FFT::backward}){
+    for(int mu=0;mu<Nd;mu++){
+      theFFT.FFT_dim(pencil,src,mu,sign);
+      BarrelFFT_dim(barrel,src,mu,sign);
+      diff = pencil - barrel;
+      RealD rel = std::sqrt(norm2(diff)/norm2(barrel));
+      std::cout << GridLogMessage << name << " dim "<<mu<<" sign "<<sign
+		<< " processors "<<grid->_processors[mu]<<" pencil vs barrel "<<rel<<std::endl;
+      assert(rel < tol);
+    }
+  }
+
+  // All dimensions, twice through the cached plans and row communicators
+  pencil = src;
+  barrel = src;
+  for(int mu=0;mu<Nd;mu++){
+    Field tmp(grid);
+    BarrelFFT_dim(tmp,barrel,mu,FFT::forward);
+    barrel = tmp;
+  }
+  theFFT.FFT_all_dim(pencil,src,FFT::forward);
+  theFFT.FFT_all_dim(pencil,src,FFT::forward);
+  diff = pencil - barrel;
+  RealD rel = std::sqrt(norm2(diff)/norm2(barrel));
+  std::cout << GridLogMessage << name << " all dims pencil vs barrel "<<rel<<std::endl;
+  assert(rel < tol);
+}
+
+// Run on several ranks per dimension, e.g. --mpi 1.2.2.2 or --mpi 2.1.1.4
+int main (int argc, char ** argv)
+{
+  Grid_init(&argc,&argv);
+
+  Coordinate mpi_layout  = GridDefaultMpi();
+  Coordinate simd_layout = GridDefaultSimd(Nd,vComplexD::Nsimd());
+  Coordinate simd_layoutF= GridDefaultSimd(Nd,vComplexF::Nsimd());
+
+  // Odd local extents so the orthogonal sites rarely split evenly over a row
+  Coordinate base({3,5,3,3});
+  Coordinate latt_size(Nd);
+  for(int d=0;d<Nd;d++){
+    latt_size[d] = base[d]*std::max(simd_layout[d],simd_layoutF[d])*mpi_layout[d];
+  }
+  std::cout << GridLogMessage << "Lattice "<<latt_size<<" on processors "<<mpi_layout<<std::endl;
+
+  GridCartesian GRID (latt_size,simd_layout ,mpi_layout);
+  GridCartesian GRIDF(latt_size,simd_layoutF,mpi_layout);
+
+  GridParallelRNG RNG (&GRID);  RNG.SeedFixedIntegers(std::vector<int>({1,2,3,4}));
+  GridParallelRNG RNGF(&GRIDF); RNGF.SeedFixedIntegers(std::vector<int>({5,6,7,8}));
+
+  Compare<LatticeComplexD>         (&GRID ,RNG ,"LatticeComplexD"         ,1.0e-12);
+  Compare<LatticeSpinColourVectorD>(&GRID ,RNG ,"LatticeSpinColourVectorD",1.0e-12);
+  Compare<LatticeComplexF>         (&GRIDF,RNGF,"LatticeComplexF"         ,1.0e-5);
+
+  std::cout << GridLogMessage << "Pencil FFT OK" << std::endl;
+
+  Grid_finalize();
+}
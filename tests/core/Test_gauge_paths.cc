@@ -0,0 +1,132 @@
+    /*************************************************************************************
+
+    Grid physics library, www.github.com/paboyle/Grid
+
+    Source file: ./tests/core/Test_gauge_paths.cc
+
+    Copyright (C) 2023
+
+Author: Peter Boyle <paboyle@ph.ed.ac.uk>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+    See the full license in the file "LICENSE" in the top level distribution directory
+    *************************************************************************************/
+    /*  END LEGAL */
+#include <Grid/Grid.h>
+
+using namespace Grid;
+
+int main (int argc, char ** argv)
+{
+  Grid_init(&argc,&argv);
+
+  Coordinate latt_size  = GridDefaultLatt();
+  Coordinate simd_layout= GridDefaultSimd(Nd,vComplexD::Nsimd());
+  Coordinate mpi_layout = GridDefaultMpi();
+  GridCartesian GRID(latt_size,simd_layout,mpi_layout);
+
+  GridParallelRNG   pRNG(&GRID);
+  pRNG.SeedFixedIntegers(std::vector<int>({45,12,81,9}));
+  LatticeGaugeField Umu(&GRID);
+  SU<Nc>::HotConfiguration(pRNG,Umu);
+
+  // Charge conjugation boundaries exercise the gauge aware halo exchange
+  typedef ConjugateGimplD Gimpl;
+  std::vector<int> conj_dirs(Nd,0); conj_dirs[0]=1; conj_dirs[3]=1;
+  Gimpl::setDirections(conj_dirs);
+
+  typedef WilsonLoops<Gimpl>::GaugeMat GaugeMat;
+
+  std::vector<GaugeMat> U(Nd,&GRID);
+  for(int mu=0;mu<Nd;mu++) U[mu] = PeekIndex<LorentzIndex>(Umu,mu);
+
+  ////////////////////////////////////////////////
+  // Staples and rectangle staples, one compiled set
+  ////////////////////////////////////////////////
+  std::cout << GridLogMessage << "Checking staples" << std::endl;
+  {
+    GaugePaths<Gimpl> paths;
+    for(int mu=0;mu<Nd;mu++){
+      paths.AddStaples(mu,mu,1.0);
+      paths.AddRectStaples(Nd+mu,mu,1.0);
+    }
+    std::vector<GaugeMat> out;
+    paths(out,U);
+
+    std::vector<GaugeMat> staple(Nd,&GRID), rect(Nd,&GRID);
+    WilsonLoops<Gimpl>::StapleAll(staple,U);
+    WilsonLoops<Gimpl>::RectStapleAll(rect,U);
+    for(int mu=0;mu<Nd;mu++){
+      RealD ns = norm2(out[mu]   -staple[mu]);
+      RealD nr = norm2(out[Nd+mu]-rect[mu]);
+      std::cout << GridLogMessage << "mu "<<mu<<" staple "<<ns<<" rect "<<nr<<std::endl;
+      assert(ns<1e-10);
+      assert(nr<1e-10);
+    }
+  }
+
+  ////////////////////////////////////////////////
+  // Cloverleaf for the MxN field strength
+  ////////////////////////////////////////////////
+  std::cout << GridLogMessage << "Checking cloverleaf" << std::endl;
+  {
+    int M=2, N=1;
+    GaugePaths<Gimpl> paths;
+    int o=0;
+    for(int mu=0;mu<Nd;mu++){
+      for(int nu=mu+1;nu<Nd;nu++){
+	paths.AddCloverleafMxN(o++,mu,nu,M,N,1.0);
+      }
+    }
+    std::vector<GaugeMat> out;
+    paths(out,U);
+
+    o=0;
+    for(int mu=0;mu<Nd;mu++){
+      for(int nu=mu+1;nu<Nd;nu++){
+	GaugeMat F(&GRID);
+	WilsonLoops<Gimpl>::CloverleafMxN(F,U[mu],U[nu],mu,nu,M,N);
+	RealD n = norm2(out[o++]-F);
+	std::cout << GridLogMessage << "mu "<<mu<<" nu "<<nu<<" "<<n<<std::endl;
+	assert(n<1e-10);
+      }
+    }
+  }
+
+  ////////////////////////////////////////////////
+  // Plaquette from closed loops
+  ////////////////////////////////////////////////
+  std::cout << GridLogMessage << "Checking plaquette" << std::endl;
+  {
+    GaugePaths<Gimpl> paths;
+    for(int mu=1;mu<Nd;mu++){
+      for(int nu=0;nu<mu;nu++){
+	paths.AddWilsonLoop(0,mu,nu,1,1,1.0);
+      }
+    }
+    std::vector<GaugeMat> out;
+    paths(out,U);
+    RealD plaq = TensorRemove(sum(trace(out[0]))).real();
+    plaq = plaq / GRID.gSites() / (Nd*(Nd-1)/2) / Nc;
+    RealD ref  = WilsonLoops<Gimpl>::avgPlaquette(Umu);
+    std::cout << GridLogMessage << "plaquette "<<plaq<<" reference "<<ref<<std::endl;
+    assert(std::fabs(plaq-ref)<1e-10);
+  }
+
+  std::cout << GridLogMessage << "GaugePaths OK" << std::endl;
+
+  Grid_finalize();
+}
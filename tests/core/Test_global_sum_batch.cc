@@ -0,0 +1,77 @@
+    /*************************************************************************************
+
+    Grid physics library, www.github.com/paboyle/Grid
+
+    Source file: ./tests/Test_global_sum_batch.cc
+
+    Copyright (C) 2015
+
+Author: Peter Boyle <paboyle@ph.ed.ac.uk>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+    See the full license in the file "LICENSE" in the top level distribution directory
+    *************************************************************************************/
+    /*  END LEGAL */
+#include <Grid/Grid.h>
+
+using namespace Grid;
+
+int main (int argc, char ** argv)
+{
+  Grid_init(&argc,&argv);
+
+  GridCartesian * UGrid = SpaceTimeGrid::makeFourDimGrid(GridDefaultLatt(), GridDefaultSimd(Nd,vComplexD::Nsimd()),GridDefaultMpi());
+
+  GridParallelRNG RNG(UGrid);  RNG.SeedFixedIntegers(std::vector<int>({1,2,3,4}));
+
+  LatticeFermionD a(UGrid); random(RNG,a);
+  LatticeFermionD b(UGrid); random(RNG,b);
+  LatticeFermionD c(UGrid); random(RNG,c);
+
+  // Blocking reference
+  ComplexD ab = innerProduct(a,b);
+  ComplexD bc = innerProduct(b,c);
+  RealD    na = norm2(a);
+
+  // Three reductions in one non-blocking message, overlapped with a shift
+  GlobalSumBatch red(UGrid);
+  int iab = innerProductBegin(red,a,b);
+  int ibc = innerProductBegin(red,b,c);
+  int ina = norm2Begin(red,a);
+  red.Begin();
+  LatticeFermionD d = Cshift(c,0,1);
+  red.Complete();
+
+  std::cout << GridLogMessage << "<a,b> " << ab << " batched " << red[iab] << std::endl;
+  std::cout << GridLogMessage << "<b,c> " << bc << " batched " << red[ibc] << std::endl;
+  std::cout << GridLogMessage << "|a|^2 " << na << " batched " << red[ina] << std::endl;
+
+  assert(abs(red[iab]-ab) <= 1.0e-12*abs(ab));
+  assert(abs(red[ibc]-bc) <= 1.0e-12*abs(bc));
+  assert(std::fabs(real(red[ina])-na) <= 1.0e-12*na);
+
+  // Reuse after Reset
+  red.Reset();
+  int ind = norm2Begin(red,d);
+  red.Sum();
+  RealD nd = norm2(d);
+  std::cout << GridLogMessage << "|d|^2 " << nd << " batched " << red[ind] << std::endl;
+  assert(std::fabs(real(red[ind])-nd) <= 1.0e-12*nd);
+
+  std::cout << GridLogMessage << "GlobalSumBatch OK" << std::endl;
+
+  Grid_finalize();
+}
@@ -0,0 +1,148 @@
+    /*************************************************************************************
+
+    Grid physics library, www.github.com/paboyle/Grid
+
+    Source file: ./tests/core/Test_halo_compression.cc
+
+    Copyright (C) 2015
+
+Author: Peter Boyle <paboyle@ph.ed.ac.uk>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+    See the full license in the file "LICENSE" in the top level distribution directory
+    *************************************************************************************/
+    /*  END LEGAL */
+#include <Grid/Grid.h>
+
+using namespace std;
+using namespace Grid;
+
+// Bounds on the relative error of one compressed face
+const RealD tol_fp16 = 2.0e-3;
+const RealD tol_bf16 = 1.0e-2;
+
+RealD Tolerance(int mode) { return (mode==HaloCompressionFP16) ? tol_fp16 : tol_bf16; }
+
+int main (int argc, char ** argv)
+{
+  Grid_init(&argc,&argv);
+
+  Coordinate latt_size   = GridDefaultLatt();
+  Coordinate simd_layout = GridDefaultSimd(Nd,vComplex::Nsimd());
+  Coordinate mpi_layout  = GridDefaultMpi();
+  GridCartesian               Grid(latt_size,simd_layout,mpi_layout);
+  GridRedBlackCartesian     RBGrid(&Grid);
+
+  // Only off node faces are compressed, so the halo checks need ranks, e.g. --mpi 1.1.1.2
+  std::cout<<GridLogMessage<<"Processor grid "<<mpi_layout<<std::endl;
+  assert(Grid.ProcessorCount()>1);
+
+  std::vector<int> seeds({1,2,3,4});
+  GridParallelRNG          pRNG(&Grid);
+  pRNG.SeedFixedIntegers(seeds);
+
+  std::vector<int> modes({HaloCompressionFP16,HaloCompressionBF16});
+
+  std::cout<<GridLogMessage<<"=========================================================="<<std::endl;
+  std::cout<<GridLogMessage<<"= Buffer round trip, including a wide dynamic range"<<std::endl;
+  std::cout<<GridLogMessage<<"=========================================================="<<std::endl;
+  {
+    const uint64_t n = 1000; // not a multiple of the block
+    std::vector<RealD> x(n), y(n);
+    GridSerialRNG sRNG; sRNG.SeedFixedIntegers(seeds);
+    for(uint64_t i=0;i<n;i++){
+      RealD r; random(sRNG,r);
+      x[i] = (r-0.5)*std::pow(10.0,(int)(i/HaloCompressionBlock)%12-6);
+    }
+    for(auto mode : modes){
+      uint64_t bytes  = n*sizeof(RealD);
+      uint64_t cbytes = HaloCompressor::CompressedBytes<RealD>(mode,bytes);
+      std::vector<char> c(cbytes);
+      HaloCompressor::Compress<RealD>  (mode,&x[0],&c[0],bytes,0);
+      HaloCompressor::Decompress<RealD>(mode,&c[0],&y[0],bytes,0);
+      HaloCompressionStats stats;
+      HaloCompressor::Measure<RealD>(mode,&x[0],&c[0],bytes,stats,0);
+      std::cout<<GridLogMessage<<HaloCompressor::Name(mode)<<" "<<bytes<<" -> "<<cbytes
+	       <<" bytes; relative error "<<std::sqrt(stats.err2/stats.norm2)
+	       <<" worst block "<<stats.max_rel<<std::endl;
+      assert(cbytes*3 < bytes);
+      assert(stats.max_rel < Tolerance(mode));
+      // fp16 error is relative to the largest element of the block sharing the scale
+      for(uint64_t b=0;b*HaloCompressionBlock<n;b++){
+	uint64_t s1 = std::min(n,(b+1)*HaloCompressionBlock);
+	RealD amax=0.0;
+	for(uint64_t i=b*HaloCompressionBlock;i<s1;i++) amax=std::max(amax,std::fabs(x[i]));
+	for(uint64_t i=b*HaloCompressionBlock;i<s1;i++) assert(std::fabs(y[i]-x[i]) <= Tolerance(mode)*amax);
+      }
+    }
+  }
+
+  std::cout<<GridLogMessage<<"=========================================================="<<std::endl;
+  std::cout<<GridLogMessage<<"= Staggered Dhop with compressed halos"<<std::endl;
+  std::cout<<GridLogMessage<<"=========================================================="<<std::endl;
+  {
+    typedef typename ImprovedStaggeredFermionD::FermionField FermionField;
+    typename ImprovedStaggeredFermionD::ImplParams params;
+
+    LatticeGaugeField Umu(&Grid); SU<Nc>::HotConfiguration(pRNG,Umu);
+    FermionField src(&Grid); random(pRNG,src);
+    FermionField ref(&Grid);
+    FermionField res(&Grid);
+    FermionField err(&Grid);
+
+    RealD mass=0.1;
+    RealD c1=9.0/8.0;
+    RealD c2=-1.0/24.0;
+    RealD u0=1.0;
+    ImprovedStaggeredFermionD Ds(Umu,Umu,Grid,RBGrid,mass,c1,c2,u0,params);
+    Ds.Dhop(src,ref,DaggerNo);
+
+    for(auto mode : modes){
+      Ds.Stencil.SetHaloCompression(mode);
+      Ds.Stencil.HaloCompressionZeroCounters();
+      Ds.Dhop(src,res,DaggerNo);
+      Ds.Stencil.SetHaloCompression(HaloCompressionNone);
+      err = res-ref;
+      RealD rel = std::sqrt(norm2(err)/norm2(ref));
+      std::cout<<GridLogMessage<<HaloCompressor::Name(mode)<<" Dhop relative deviation "<<rel<<std::endl;
+      Ds.Stencil.HaloCompressionReport(HaloCompressor::Name(mode));
+      assert(Ds.Stencil.HaloCompressionCounters.calls > 0);
+      assert(rel < Tolerance(mode));
+    }
+  }
+
+  std::cout<<GridLogMessage<<"=========================================================="<<std::endl;
+  std::cout<<GridLogMessage<<"= PaddedCell periodic exchange with compressed faces"<<std::endl;
+  std::cout<<GridLogMessage<<"=========================================================="<<std::endl;
+  {
+    PaddedCell Cell(1,&Grid);
+    LatticeComplexD in(&Grid); random(pRNG,in);
+    LatticeComplexD ref = Cell.ExchangePeriodic(in);
+    LatticeComplexD err(ref.Grid());
+    for(auto mode : modes){
+      Cell.HaloCompressionCounters.Zero();
+      LatticeComplexD res = Cell.ExchangePeriodic(in,mode);
+      assert(Cell.HaloCompressionCounters.calls > 0);
+      err = res-ref;
+      RealD rel = std::sqrt(norm2(err)/norm2(ref));
+      std::cout<<GridLogMessage<<HaloCompressor::Name(mode)<<" padded exchange relative deviation "<<rel<<std::endl;
+      assert(rel < Tolerance(mode));
+      Cell.HaloCompressionCounters.Report("PaddedCell "+HaloCompressor::Name(mode));
+    }
+  }
+
+  Grid_finalize();
+}
@@ -0,0 +1,78 @@
+    /*************************************************************************************
+
+    Grid physics library, www.github.com/paboyle/Grid
+
+    Source file: ./tests/Test_linear_combination.cc
+
+    Copyright (C) 2015
+
+Author: Peter Boyle <paboyle@ph.ed.ac.uk>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+    See the full license in the file "LICENSE" in the top level distribution directory
+    *************************************************************************************/
+    /*  END LEGAL */
+#include <Grid/Grid.h>
+
+using namespace Grid;
+
+int main (int argc, char ** argv)
+{
+  Grid_init(&argc,&argv);
+
+  GridCartesian * UGrid = SpaceTimeGrid::makeFourDimGrid(GridDefaultLatt(), GridDefaultSimd(Nd,vComplexD::Nsimd()),GridDefaultMpi());
+
+  GridParallelRNG RNG(UGrid);  RNG.SeedFixedIntegers(std::vector<int>({1,2,3,4}));
+
+  LatticeFermionD x(UGrid); random(RNG,x);
+  LatticeFermionD p(UGrid); random(RNG,p);
+  LatticeFermionD r(UGrid); random(RNG,r);
+  LatticeFermionD diff(UGrid);
+
+  RealD a=0.3, b=-1.7;
+
+  // Reference by separate passes: x = x + a p ; p = r + b p
+  LatticeFermionD x_ref = x + a*p;
+  LatticeFermionD p_ref = r + b*p;
+  RealD    xx_ref = norm2(x_ref);
+  ComplexD rp_ref = innerProduct(r,p_ref);
+
+  // Fused, in place: x reads p before p is overwritten
+  std::vector<std::pair<int,int> > prods;
+  prods.push_back(std::make_pair(0,0)); // |x|^2
+  prods.push_back(std::make_pair(4,1)); // <r,p>
+  std::vector<ComplexD> red;
+  linearCombination(std::vector<LatticeFermionD *>({&x,&p}),
+		    std::vector<const LatticeFermionD *>({&x,&p,&r}),
+		    std::vector<RealD>({1.0,a  ,0.0,
+		                        0.0,b  ,1.0}),
+		    prods,red);
+
+  diff = x - x_ref; RealD dx = norm2(diff);
+  diff = p - p_ref; RealD dp = norm2(diff);
+  std::cout << GridLogMessage << "x diff " << dx << " p diff " << dp << std::endl;
+  std::cout << GridLogMessage << "|x|^2 " << xx_ref << " fused " << red[0] << std::endl;
+  std::cout << GridLogMessage << "<r,p> " << rp_ref << " fused " << red[1] << std::endl;
+
+  assert(dx <= 1.0e-24*xx_ref);
+  assert(dp <= 1.0e-24*norm2(p_ref));
+  assert(std::fabs(real(red[0])-xx_ref) <= 1.0e-12*xx_ref);
+  assert(abs(red[1]-rp_ref) <= 1.0e-12*abs(rp_ref));
+
+  std::cout << GridLogMessage << "linearCombination OK" << std::endl;
+
+  Grid_finalize();
+}
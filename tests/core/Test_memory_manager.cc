@@ -31,6 +31,7 @@ using namespace std;
 using namespace Grid;
 
 void  MemoryTest(GridCartesian         * FGrid,int N);
+void  ChurnTest(GridCartesian         * FGrid);
 
 int main (int argc, char ** argv)
 {
@@ -47,6 +48,9 @@ int main (int argc, char ** argv)
     MemoryManager::Print();
     AUDIT();
   }
+
+  ChurnTest(UGrid);
+
   Grid_finalize();
 }
 
@@ -108,3 +112,93 @@ void  MemoryTest(GridCartesian         * FGrid, int N)
   }
 
 }
+
+//////////////////////////////////////////////////////////////////////
+// Allocation churn: temporaries created and destroyed in a loop, as in
+// solver iterations, with a spread of sizes so that near-miss requests
+// land in a shared size class.
+//////////////////////////////////////////////////////////////////////
+void  ChurnTest(GridCartesian         * FGrid)
+{
+  const int Nloop = 1000;
+
+  std::cout << "============================"<<std::endl;
+  std::cout << "Allocation churn"<<std::endl;
+  std::cout << "============================"<<std::endl;
+
+  LatticeComplexD a(FGrid); a = ComplexD(1.0);
+  LatticeComplexD b(FGrid); b = ComplexD(2.0);
+
+  // Expression temporaries
+  {
+    MemoryPoolStats s0 = MemoryManager::HostPoolStats();
+    double t0=usecond();
+    for(int i=0;i<Nloop;i++){
+      LatticeComplexD c(FGrid);
+      c = a*b + a - b;
+      assert(i>0 || TensorRemove(sum(c)) == ComplexD(FGrid->gSites()));
+    }
+    double t1=usecond();
+    MemoryPoolStats s1 = MemoryManager::HostPoolStats();
+    std::cout << GridLogMessage<<"Lattice temporaries  : "<<(t1-t0)/Nloop<<" us/iteration; pool hits "
+	      <<s1.hits-s0.hits<<" misses "<<s1.misses-s0.misses<<std::endl;
+  }
+
+  // Host and device buffers of varying size, interleaved lifetimes
+  for(int type=0;type<2;type++){
+    std::vector<void *> ptr(8,(void *)NULL);
+    std::vector<size_t> len(8,0);
+    MemoryPoolStats s0 = type ? MemoryManager::DevicePoolStats() : MemoryManager::HostPoolStats();
+    double t0=usecond();
+    for(int i=0;i<Nloop;i++){
+      int slot = i%ptr.size();
+      if ( ptr[slot] ) {
+	if ( type ) MemoryManager::AcceleratorFree(ptr[slot],len[slot]);
+	else        MemoryManager::CpuFree        (ptr[slot],len[slot]);
+      }
+      len[slot] = (slot%2) ? 64+16*(i%64)                 // small objects
+	                   : (1<<20) + 4096*(random()%16);  // large, sizes within a class or two
+      ptr[slot] = type ? MemoryManager::AcceleratorAllocate(len[slot])
+	               : MemoryManager::CpuAllocate        (len[slot]);
+      assert(ptr[slot]!=NULL);
+      if ( !type ) memset(ptr[slot],i&0xFF,len[slot]);
+    }
+    for(int slot=0;slot<ptr.size();slot++){
+      if ( type ) MemoryManager::AcceleratorFree(ptr[slot],len[slot]);
+      else        MemoryManager::CpuFree        (ptr[slot],len[slot]);
+    }
+    double t1=usecond();
+    MemoryPoolStats s1 = type ? MemoryManager::DevicePoolStats() : MemoryManager::HostPoolStats();
+    std::cout << GridLogMessage<<(type ? "Device" : "Host  ")<<" buffer churn  : "<<(t1-t0)/Nloop<<" us/allocation; pool hits "
+	      <<s1.hits-s0.hits<<" misses "<<s1.misses-s0.misses<<std::endl;
+
+    // The pool stays within its limits
+    std::cout << GridLogMessage<<"  cached blocks "<<s1.entries<<" (limit "<<s1.maxEntries<<")"
+	      <<" empty slabs "<<s1.emptySlabs<<" (limit "<<s1.maxEmptySlabs<<")"<<std::endl;
+    assert(s1.entries    <= s1.maxEntries);
+    assert(s1.emptySlabs <= s1.maxEmptySlabs);
+    assert(s1.emptySlabs <= s1.slabs);
+
+#ifdef ALLOCATION_CACHE
+    // Freed blocks are reused: the last large block freed comes straight
+    // back, and small objects come from the cached slabs
+    if ( s1.maxEntries > 0 && s1.maxEmptySlabs > 0 ) {
+      assert(s1.hits > s0.hits);
+      size_t big   = len[ptr.size()-2];
+      size_t small = len[ptr.size()-1];
+      void *p = type ? MemoryManager::AcceleratorAllocate(big) : MemoryManager::CpuAllocate(big);
+      void *q = type ? MemoryManager::AcceleratorAllocate(small) : MemoryManager::CpuAllocate(small);
+      MemoryPoolStats s2 = type ? MemoryManager::DevicePoolStats() : MemoryManager::HostPoolStats();
+      assert(p==ptr[ptr.size()-2]);
+      assert(s2.hits   == s1.hits+2);
+      assert(s2.misses == s1.misses);
+      if ( type ) { MemoryManager::AcceleratorFree(p,big); MemoryManager::AcceleratorFree(q,small); }
+      else        { MemoryManager::CpuFree        (p,big); MemoryManager::CpuFree        (q,small); }
+    }
+#endif
+  }
+
+  MemoryManager::PrintPoolStats();
+  MemoryStatus stat = MemoryManager::GetFootprint();
+  std::cout << GridLogMessage<<"High water host "<<stat.HostAllocMaxBytes<<" device "<<stat.DeviceAllocMaxBytes<<" bytes"<<std::endl;
+}
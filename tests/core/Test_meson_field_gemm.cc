@@ -0,0 +1,116 @@
+    /*************************************************************************************
+
+    Grid physics library, www.github.com/paboyle/Grid
+
+    Source file: ./tests/core/Test_meson_field_gemm.cc
+
+    Copyright (C) 2015
+
+Author: Peter Boyle <paboyle@ph.ed.ac.uk>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+    See the full license in the file "LICENSE" in the top level distribution directory
+    *************************************************************************************/
+    /*  END LEGAL */
+#include <Grid/Grid.h>
+
+using namespace Grid;
+
+typedef WilsonImplD FImpl;
+typedef FImpl::FermionField FermionField;
+typedef FImpl::ComplexField ComplexField;
+
+int main (int argc, char ** argv)
+{
+  Grid_init(&argc,&argv);
+
+  GridCartesian * UGrid = SpaceTimeGrid::makeFourDimGrid(GridDefaultLatt(), GridDefaultSimd(Nd,vComplexD::Nsimd()),GridDefaultMpi());
+  int Nt = UGrid->GlobalDimensions()[Tp];
+
+  GridParallelRNG RNG(UGrid);  RNG.SeedFixedIntegers(std::vector<int>({1,2,3,4}));
+
+  const int Nw = 7;
+  const int Nv = 5;
+  const int blockSize = 3;
+  std::vector<FermionField> w(Nw,UGrid);
+  std::vector<FermionField> v(Nv,UGrid);
+  for(int i=0;i<Nw;i++) gaussian(RNG,w[i]);
+  for(int j=0;j<Nv;j++) gaussian(RNG,v[j]);
+
+  std::vector<Gamma::Algebra> gammas({Gamma::Algebra::Gamma5,
+				      Gamma::Algebra::GammaX,
+				      Gamma::Algebra::GammaT,
+				      Gamma::Algebra::GammaYGamma5,
+				      Gamma::Algebra::SigmaXZ});
+
+  std::vector<std::vector<int> > moms({{0,0,0},{1,0,0},{0,-1,1}});
+  std::vector<ComplexField> phases(moms.size(),UGrid);
+  ComplexField coor(UGrid);
+  ComplexD ci(0.0,1.0);
+  for(int m=0;m<moms.size();m++){
+    phases[m] = Zero();
+    for(int mu=0;mu<3;mu++){
+      LatticeCoordinate(coor,mu);
+      phases[m] = phases[m] + (2.0*M_PI*moms[m][mu]/UGrid->GlobalDimensions()[mu])*coor;
+    }
+    phases[m] = exp(ci*phases[m]);
+  }
+
+  // Reference: site loop kernel on the whole matrix
+  Eigen::Tensor<ComplexD,5,Eigen::RowMajor> ref(moms.size(),gammas.size(),Nt,Nw,Nv);
+  RealD t=-usecond();
+  A2Autils<FImpl>::MesonField(ref,&w[0],&v[0],gammas,phases,Tp);
+  t+=usecond();
+  std::cout << GridLogMessage << "A2Autils::MesonField "<<t<<" us"<<std::endl;
+
+  A2AMesonField<FImpl> MF(UGrid,Tp,gammas,phases);
+
+  t=-usecond();
+  Eigen::Tensor<ComplexD,5,Eigen::RowMajor> mat(moms.size(),gammas.size(),Nt,Nw,Nv);
+  MF(mat,&w[0],&v[0]);
+  t+=usecond();
+  std::cout << GridLogMessage << "A2AMesonField "<<t<<" us"<<std::endl;
+
+  RealD nref=0.0, ndiff=0.0;
+  for(int m=0;m<moms.size();m++){
+  for(int g=0;g<gammas.size();g++){
+  for(int tt=0;tt<Nt;tt++){
+  for(int i=0;i<Nw;i++){
+  for(int j=0;j<Nv;j++){
+    nref += norm(ref(m,g,tt,i,j));
+    ndiff+= norm(ref(m,g,tt,i,j)-mat(m,g,tt,i,j));
+  }}}}}
+  std::cout << GridLogMessage << "|ref|^2 "<<nref<<" |ref-gemm|^2 "<<ndiff<<std::endl;
+  assert(ndiff <= 1.0e-24*nref);
+
+  // Blocked and streamed: each block matches its piece of the reference
+  int nblock=0;
+  MF.Stream(w,v,blockSize,[&](const A2AMesonField<FImpl>::Block &block,int i0,int j0){
+    for(int m=0;m<block.dimension(0);m++){
+    for(int g=0;g<block.dimension(1);g++){
+    for(int tt=0;tt<block.dimension(2);tt++){
+    for(int i=0;i<block.dimension(3);i++){
+    for(int j=0;j<block.dimension(4);j++){
+      assert(abs(block(m,g,tt,i,j)-ref(m,g,tt,i0+i,j0+j)) <= 1.0e-10*std::sqrt(nref));
+    }}}}}
+    nblock++;
+  });
+  assert(nblock == ((Nw+blockSize-1)/blockSize)*((Nv+blockSize-1)/blockSize));
+
+  std::cout << GridLogMessage << "A2AMesonField OK" << std::endl;
+
+  Grid_finalize();
+}
@@ -0,0 +1,148 @@
+    /*************************************************************************************
+
+    Grid physics library, www.github.com/paboyle/Grid
+
+    Source file: ./tests/core/Test_rng_counter.cc
+
+    Copyright (C) 2015
+
+Author: Peter Boyle <paboyle@ph.ed.ac.uk>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+    See the full license in the file "LICENSE" in the top level distribution directory
+    *************************************************************************************/
+    /*  END LEGAL */
+#include <Grid/Grid.h>
+
+using namespace Grid;
+
+int main (int argc, char ** argv)
+{
+  Grid_init(&argc,&argv);
+
+  Coordinate latt_size   = GridDefaultLatt();
+  Coordinate simd_layout = GridDefaultSimd(Nd,vComplexD::Nsimd());
+  Coordinate mpi_layout  = GridDefaultMpi();
+
+  // Same lattice, SIMD lanes laid out over the opposite dimensions
+  Coordinate simd_flip(Nd);
+  for(int d=0;d<Nd;d++) simd_flip[d] = simd_layout[Nd-1-d];
+
+  GridCartesian Grid    (latt_size,simd_layout,mpi_layout);
+  GridCartesian GridFlip(latt_size,simd_flip  ,mpi_layout);
+
+  std::vector<int> seeds({1,2,3,4});
+  GridParallelRNG pRNG    (&Grid);     pRNG.SeedCounterIntegers(seeds);
+  GridParallelRNG pRNGflip(&GridFlip); pRNGflip.SeedCounterIntegers(seeds);
+
+  RealD vol = Grid.gSites();
+
+  ////////////////////////////////////////////////
+  // Decomposition independence
+  ////////////////////////////////////////////////
+  LatticeColourMatrixD U(&Grid);     gaussian(pRNG,U);
+  LatticeColourMatrixD Uflip(&GridFlip); gaussian(pRNGflip,Uflip);
+  {
+    std::vector<ColourMatrixD> a, b;
+    unvectorizeToLexOrdArray(a,U);
+    unvectorizeToLexOrdArray(b,Uflip);
+    RealD diff=0.0;
+    for(int s=0;s<a.size();s++) diff += norm2(a[s]-b[s]);
+    std::cout << GridLogMessage << "SIMD layout "<<simd_layout<<" vs "<<simd_flip<<" difference "<<diff<<std::endl;
+    assert(diff==0.0);
+  }
+
+  ////////////////////////////////////////////////
+  // Bitwise agreement with the sitmo engine at the origin
+  ////////////////////////////////////////////////
+  {
+    std::vector<uint64_t> state;
+    pRNG.GetCounterState(state);
+    LatticeComplexD c(&Grid); random(pRNG,c);  // fill number state[4]
+
+    sitmo::prng_engine eng;
+    eng.set_key(state[0],state[1],state[2],state[3]);
+    eng.set_counter(0,state[4],0,0);
+    uint64_t lo = eng();
+    uint64_t hi = eng();
+    RealD ref = ((lo | (hi<<32))>>11)*(1.0/9007199254740992.0);
+
+    TComplexD c0;
+    peekSite(c0,c,Coordinate(Nd,0));
+    std::cout << GridLogMessage << "origin "<<real(TensorRemove(c0))<<" sitmo "<<ref<<std::endl;
+    assert(real(TensorRemove(c0))==ref);
+
+    // Restoring the state replays the stream
+    LatticeComplexD d(&Grid);
+    pRNG.SetCounterState(state);
+    random(pRNG,d);
+    assert(norm2(c-d)==0.0);
+  }
+
+  ////////////////////////////////////////////////
+  // Checkpoint restart through the RNG file
+  ////////////////////////////////////////////////
+  {
+    std::string file("ckpoint_rng_counter");
+    GridSerialRNG sRNG; sRNG.SeedFixedIntegers(seeds);
+    uint32_t nersc_csum, scidac_csuma, scidac_csumb;
+    BinaryIO::writeRNG(sRNG,pRNG,file,0,nersc_csum,scidac_csuma,scidac_csumb);
+    LatticeComplexD c(&Grid); gaussian(pRNG,c);
+
+    // Restore into a generator in per-site mode, as a restarted job has
+    GridParallelRNG pRNGrestart(&Grid); pRNGrestart.SeedFixedIntegers(std::vector<int>({9,9,9,9}));
+    BinaryIO::readRNG(sRNG,pRNGrestart,file,0,nersc_csum,scidac_csuma,scidac_csumb);
+    assert(pRNGrestart.CounterBased());
+    LatticeComplexD d(&Grid); gaussian(pRNGrestart,d);
+    std::cout << GridLogMessage << "restart difference "<<norm2(c-d)<<std::endl;
+    assert(norm2(c-d)==0.0);
+
+    // Per-site generator files still restore per-site mode
+    GridParallelRNG pRNGsite(&Grid); pRNGsite.SeedFixedIntegers(seeds);
+    BinaryIO::writeRNG(sRNG,pRNGsite,file,0,nersc_csum,scidac_csuma,scidac_csumb);
+    gaussian(pRNGsite,c);
+    BinaryIO::readRNG(sRNG,pRNGrestart,file,0,nersc_csum,scidac_csuma,scidac_csumb);
+    assert(!pRNGrestart.CounterBased());
+    gaussian(pRNGrestart,d);
+    assert(norm2(c-d)==0.0);
+    if ( Grid.IsBoss() ) std::remove(file.c_str());
+  }
+
+  ////////////////////////////////////////////////
+  // Moments
+  ////////////////////////////////////////////////
+  {
+    RealD ncomp = 2.0*Nc*Nc;
+    RealD var = norm2(U)/(vol*ncomp);
+    std::cout << GridLogMessage << "gaussian variance "<<var<<std::endl;
+    assert(std::fabs(var-1.0) < 0.05);
+
+    LatticeComplexD c(&Grid); random(pRNG,c);
+    ComplexD mean = TensorRemove(sum(c))/vol;
+    std::cout << GridLogMessage << "uniform mean "<<mean<<std::endl;
+    assert(std::fabs(real(mean)-0.5) < 0.05);
+    assert(std::fabs(imag(mean)-0.5) < 0.05);
+
+    LatticeFermionD eta(&Grid); z2(pRNG,eta);
+    RealD nz = norm2(eta);
+    std::cout << GridLogMessage << "Z2 norm "<<nz<<" expect "<<vol*2.0*Ns*Nc<<std::endl;
+    assert(nz==vol*2.0*Ns*Nc);
+  }
+
+  std::cout << GridLogMessage << "Counter based RNG OK" << std::endl;
+
+  Grid_finalize();
+}
@@ -0,0 +1,117 @@
+    /*************************************************************************************
+
+    Grid physics library, www.github.com/paboyle/Grid
+
+    Source file: ./tests/core/Test_sliceSum_batched.cc
+
+    Copyright (C) 2015
+
+Author: Peter Boyle <paboyle@ph.ed.ac.uk>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+    See the full license in the file "LICENSE" in the top level distribution directory
+    *************************************************************************************/
+    /*  END LEGAL */
+#include <Grid/Grid.h>
+
+using namespace Grid;
+
+int main (int argc, char ** argv)
+{
+  Grid_init(&argc,&argv);
+
+  GridCartesian * UGrid = SpaceTimeGrid::makeFourDimGrid(GridDefaultLatt(), GridDefaultSimd(Nd,vComplexD::Nsimd()),GridDefaultMpi());
+
+  GridParallelRNG RNG(UGrid);  RNG.SeedFixedIntegers(std::vector<int>({1,2,3,4}));
+
+  const int nfield = 6;
+  std::vector<LatticeSpinColourMatrixD> fields(nfield,UGrid);
+  for(int f=0;f<nfield;f++) gaussian(RNG,fields[f]);
+
+  // Momentum phases exp(i p.x) for a few spatial momenta
+  std::vector<std::vector<int> > moms({{0,0,0},{1,0,0},{0,1,1},{1,-1,2}});
+  std::vector<LatticeComplexD> phases(moms.size(),UGrid);
+  LatticeComplexD coor(UGrid);
+  ComplexD ci(0.0,1.0);
+  for(int m=0;m<moms.size();m++){
+    phases[m] = Zero();
+    for(int mu=0;mu<3;mu++){
+      LatticeCoordinate(coor,mu);
+      RealD k = 2.0*M_PI*moms[m][mu]/UGrid->GlobalDimensions()[mu];
+      phases[m] = phases[m] + k*coor;
+    }
+    phases[m] = exp(ci*phases[m]);
+  }
+
+  for(int orthog=0;orthog<Nd;orthog++){
+
+    std::cout << GridLogMessage << "Orthog. dir. = " << orthog << std::endl;
+
+    // Batched against one field at a time
+    std::vector<std::vector<SpinColourMatrixD> > batched;
+    RealD t=-usecond();
+    sliceSum(fields,batched,orthog);
+    t+=usecond();
+    std::cout << GridLogMessage << "batched sliceSum of "<<nfield<<" fields "<<t<<" us"<<std::endl;
+
+    t=-usecond();
+    for(int f=0;f<nfield;f++){
+      std::vector<SpinColourMatrixD> ref;
+      sliceSum(fields[f],ref,orthog);
+      assert(ref.size()==batched[f].size());
+      for(int s=0;s<ref.size();s++){
+	SpinColourMatrixD diff = ref[s]-batched[f][s];
+	assert(norm2(diff) <= 1.0e-20*norm2(ref[s]));
+      }
+    }
+    t+=usecond();
+    std::cout << GridLogMessage << "per field sliceSum "<<t<<" us"<<std::endl;
+
+    // Momentum projection applied on the fly
+    std::vector<std::vector<SpinColourMatrixD> > projected;
+    sliceSum(fields,phases,projected,orthog);
+    assert(projected.size()==nfield*moms.size());
+    for(int f=0;f<nfield;f++){
+      for(int m=0;m<moms.size();m++){
+	LatticeSpinColourMatrixD pf(UGrid);
+	pf = phases[m]*fields[f];
+	std::vector<SpinColourMatrixD> ref;
+	sliceSum(pf,ref,orthog);
+	for(int s=0;s<ref.size();s++){
+	  SpinColourMatrixD diff = ref[s]-projected[m+moms.size()*f][s];
+	  assert(norm2(diff) <= 1.0e-20*norm2(ref[s]));
+	}
+      }
+    }
+
+    // Slice inner products
+    std::vector<LatticeSpinColourMatrixD> rhs(fields.begin()+1,fields.end());
+    std::vector<LatticeSpinColourMatrixD> lhs(fields.begin(),fields.end()-1);
+    std::vector<std::vector<ComplexD> > ips;
+    sliceInnerProductVector(ips,lhs,rhs,orthog);
+    for(int i=0;i<lhs.size();i++){
+      std::vector<ComplexD> ref;
+      sliceInnerProductVector(ref,lhs[i],rhs[i],orthog);
+      for(int s=0;s<ref.size();s++){
+	assert(abs(ref[s]-ips[i][s]) <= 1.0e-10*abs(ref[s]));
+      }
+    }
+  }
+
+  std::cout << GridLogMessage << "Batched sliceSum OK" << std::endl;
+
+  Grid_finalize();
+}
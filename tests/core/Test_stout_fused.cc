@@ -0,0 +1,181 @@
+    /*************************************************************************************
+
+    Grid physics library, www.github.com/paboyle/Grid
+
+    Source file: ./tests/core/Test_stout_fused.cc
+
+    Copyright (C) 2023
+
+Author: Peter Boyle <paboyle@ph.ed.ac.uk>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+    See the full license in the file "LICENSE" in the top level distribution directory
+    *************************************************************************************/
+    /*  END LEGAL */
+#include <Grid/Grid.h>
+
+using namespace Grid;
+
+// Change in the smeared action over a step of 2 eps along P, against the
+// force at the midpoint; the difference is O(eps^3)
+template<class Gimpl>
+RealD ForceTest(Action<typename Gimpl::GaugeField> &action,SmearedConfiguration<Gimpl> &smU,
+		const typename Gimpl::GaugeField &Umu,typename Gimpl::GaugeField &P,RealD eps)
+{
+  typedef typename Gimpl::GaugeField     GaugeField;
+  typedef typename Gimpl::GaugeLinkField GaugeLinkField;
+  GridBase *grid = Umu.Grid();
+
+  GaugeField U = Umu;
+  smU.set_Field(U);
+  RealD S1 = action.S(smU);
+
+  Gimpl::update_field(P,U,eps);
+  smU.set_Field(U);
+  GaugeField UdSdU(grid);
+  action.deriv(smU,UdSdU);
+  UdSdU = Ta(UdSdU);
+
+  Gimpl::update_field(P,U,eps);
+  smU.set_Field(U);
+  RealD S2 = action.S(smU);
+
+  LatticeComplex dS(grid); dS = Zero();
+  for(int mu=0;mu<Nd;mu++){
+    GaugeLinkField UdSdUmu = PeekIndex<LorentzIndex>(UdSdU,mu);
+    GaugeLinkField Pmu     = PeekIndex<LorentzIndex>(P,mu);
+    dS = dS - trace(Pmu*UdSdUmu)*eps*2.0*HMC_MOMENTUM_DENOMINATOR;
+  }
+  ComplexD dSpred = sum(dS);
+  RealD diff = S2-S1-dSpred.real();
+  std::cout << GridLogMessage << "dS "<<S2-S1<<" predicted "<<dSpred.real()<<" diff "<<diff<<std::endl;
+  return std::fabs(diff/dSpred.real());
+}
+
+int main (int argc, char ** argv)
+{
+  Grid_init(&argc,&argv);
+
+  Coordinate latt_size  = GridDefaultLatt();
+  Coordinate simd_layout= GridDefaultSimd(Nd,vComplexD::Nsimd());
+  Coordinate mpi_layout = GridDefaultMpi();
+  GridCartesian GRID(latt_size,simd_layout,mpi_layout);
+
+  GridParallelRNG   pRNG(&GRID);
+  pRNG.SeedFixedIntegers(std::vector<int>({45,12,81,9}));
+  LatticeGaugeField Umu(&GRID);
+  SU<Nc>::HotConfiguration(pRNG,Umu);
+
+  typedef PeriodicGimplR Gimpl;
+  typedef Gimpl::GaugeField     GaugeField;
+  typedef Gimpl::GaugeLinkField GaugeLinkField;
+
+  RealD rho = 0.1;
+  Smear_Stout<Gimpl> Stout(rho);
+
+  ////////////////////////////////////////////////
+  // Cayley-Hamilton exponential against Taylor series
+  ////////////////////////////////////////////////
+  std::cout << GridLogMessage << "Checking exponential" << std::endl;
+  {
+    GaugeField C(&GRID);
+    Stout.BaseSmear(C,Umu);
+    for(int mu=0;mu<Nd;mu++){
+      GaugeLinkField U  = PeekIndex<LorentzIndex>(Umu,mu);
+      GaugeLinkField Cm = PeekIndex<LorentzIndex>(C,mu);
+      GaugeLinkField iQ = Ta(Cm*adj(U));
+      GaugeLinkField e_iQ(&GRID);
+      Stout.exponentiate_iQ(e_iQ,iQ);
+      GaugeLinkField ref = expMat(iQ,1.0,24);
+      RealD n = norm2(e_iQ-ref);
+      std::cout << GridLogMessage << "mu "<<mu<<" "<<n<<std::endl;
+      assert(n<1e-10);
+    }
+    // Small Q takes the series branches of the coefficients
+    GaugeLinkField iQ(&GRID);
+    SU<Nc>::GaussianFundamentalLieAlgebraMatrix(pRNG,iQ,1.0e-4);
+    GaugeLinkField e_iQ(&GRID);
+    Stout.exponentiate_iQ(e_iQ,iQ);
+    GaugeLinkField ref = expMat(iQ,1.0,24);
+    RealD n = norm2(e_iQ-ref);
+    std::cout << GridLogMessage << "small Q "<<n<<std::endl;
+    assert(n<1e-10);
+  }
+
+  ////////////////////////////////////////////////
+  // Fused smearing against the lattice wide expression
+  ////////////////////////////////////////////////
+  std::cout << GridLogMessage << "Checking smearing" << std::endl;
+  {
+    GaugeField Usmr(&GRID), C(&GRID);
+    Stout.smear(Usmr,C,Umu);
+    for(int mu=0;mu<Nd;mu++){
+      GaugeLinkField U  = PeekIndex<LorentzIndex>(Umu,mu);
+      GaugeLinkField Cm = PeekIndex<LorentzIndex>(C,mu);
+      GaugeLinkField iQ = Ta(Cm*adj(U));
+      GaugeLinkField ref = expMat(iQ,1.0,24)*U;
+      RealD n = norm2(PeekIndex<LorentzIndex>(Usmr,mu)-ref);
+      std::cout << GridLogMessage << "mu "<<mu<<" "<<n<<std::endl;
+      assert(n<1e-10);
+    }
+  }
+
+  ////////////////////////////////////////////////
+  // Force with and without the staple cache
+  ////////////////////////////////////////////////
+  std::cout << GridLogMessage << "Checking staple cache" << std::endl;
+  {
+    int Nsmear = 3;
+    SmearedConfiguration<Gimpl> Plain (&GRID,Nsmear,Stout);
+    SmearedConfiguration<Gimpl> Cached(&GRID,Nsmear,Stout);
+    SmearedConfiguration<Gimpl> Late  (&GRID,Nsmear,Stout);
+    Cached.CacheStaples(true);
+    Plain.set_Field(Umu);
+    Cached.set_Field(Umu);
+    Late.set_Field(Umu);
+    Late.CacheStaples(true); // after the field is attached
+
+    GaugeField P(&GRID);
+    GaugeLinkField Pmu(&GRID);
+    for(int mu=0;mu<Nd;mu++){
+      SU<Nc>::GaussianFundamentalLieAlgebraMatrix(pRNG,Pmu);
+      PokeIndex<LorentzIndex>(P,Pmu,mu);
+    }
+    GaugeField F0 = P, F1 = P, F2 = P;
+    Plain.smeared_force(F0);
+    Cached.smeared_force(F1);
+    Late.smeared_force(F2);
+    RealD n = norm2(F0-F1);
+    RealD l = norm2(F0-F2);
+    std::cout << GridLogMessage << "force difference "<<n<<" cache enabled late "<<l<<" norm "<<norm2(F0)<<std::endl;
+    assert(n<1e-10*norm2(F0));
+    assert(l<1e-10*norm2(F0));
+
+    // The cached force is the derivative of the smeared action
+    WilsonGaugeActionR Plaq(6.0);
+    Plaq.is_smeared = true;
+    std::cout << GridLogMessage << "Checking cached force against the action" << std::endl;
+    RealD rel  = ForceTest<Gimpl>(Plaq,Cached,Umu,P,0.01);
+    RealD rel2 = ForceTest<Gimpl>(Plaq,Cached,Umu,P,0.005);
+    std::cout << GridLogMessage << "relative difference "<<rel<<" at half the step "<<rel2<<std::endl;
+    assert(rel<1e-3);
+    assert(rel2<rel/3.0);
+  }
+
+  std::cout << GridLogMessage << "Fused stout OK" << std::endl;
+
+  Grid_finalize();
+}
@@ -0,0 +1,198 @@
+    /*************************************************************************************
+
+    Grid physics library, www.github.com/paboyle/Grid
+
+    Source file: ./tests/debug/Test_general_coarse_setup_reuse.cc
+
+    Copyright (C) 2023
+
+Author: Peter Boyle <paboyle@ph.ed.ac.uk>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+    See the full license in the file "LICENSE" in the top level distribution directory
+    *************************************************************************************/
+    /*  END LEGAL */
+#include <Grid/Grid.h>
+#include <Grid/lattice/PaddedCell.h>
+#include <Grid/stencil/GeneralLocalStencil.h>
+
+using namespace std;
+using namespace Grid;
+
+///////////////////////
+// Tells little dirac op to use MdagM as the .Op()
+///////////////////////
+template<class Field>
+class HermOpAdaptor : public LinearOperatorBase<Field>
+{
+  LinearOperatorBase<Field> & wrapped;
+public:
+  HermOpAdaptor(LinearOperatorBase<Field> &wrapme) : wrapped(wrapme)  {};
+  void OpDiag (const Field &in, Field &out) {    assert(0);  }
+  void OpDir  (const Field &in, Field &out,int dir,int disp) {    assert(0);  }
+  void OpDirAll  (const Field &in, std::vector<Field> &out){    assert(0);  };
+  void Op     (const Field &in, Field &out){
+    wrapped.HermOp(in,out);
+  }
+  void AdjOp     (const Field &in, Field &out){
+    wrapped.HermOp(in,out);
+  }
+  void HermOpAndNorm(const Field &in, Field &out,RealD &n1,RealD &n2){    assert(0);  }
+  void HermOp(const Field &in, Field &out){
+    wrapped.HermOp(in,out);
+  }
+};
+
+int main (int argc, char ** argv)
+{
+  Grid_init(&argc,&argv);
+
+  const int Ls=4;
+
+  GridCartesian         * UGrid   = SpaceTimeGrid::makeFourDimGrid(GridDefaultLatt(),
+								   GridDefaultSimd(Nd,vComplex::Nsimd()),
+								   GridDefaultMpi());
+  GridRedBlackCartesian * UrbGrid = SpaceTimeGrid::makeFourDimRedBlackGrid(UGrid);
+
+  GridCartesian         * FGrid   = SpaceTimeGrid::makeFiveDimGrid(Ls,UGrid);
+  GridRedBlackCartesian * FrbGrid = SpaceTimeGrid::makeFiveDimRedBlackGrid(Ls,UGrid);
+
+  // Construct a coarsened grid
+  Coordinate clatt = GridDefaultLatt();
+  for(int d=0;d<clatt.size();d++){
+    clatt[d] = clatt[d]/4;
+  }
+  GridCartesian *Coarse4d =  SpaceTimeGrid::makeFourDimGrid(clatt,
+							    GridDefaultSimd(Nd,vComplex::Nsimd()),
+							    GridDefaultMpi());;
+  GridCartesian *Coarse5d =  SpaceTimeGrid::makeFiveDimGrid(1,Coarse4d);
+
+  std::vector<int> seeds4({1,2,3,4});
+  std::vector<int> seeds4b({11,12,13,14});
+  std::vector<int> seeds5({5,6,7,8});
+  std::vector<int> cseeds({5,6,7,8});
+  GridParallelRNG          RNG5(FGrid);   RNG5.SeedFixedIntegers(seeds5);
+  GridParallelRNG          RNG4(UGrid);   RNG4.SeedFixedIntegers(seeds4);
+  GridParallelRNG          CRNG(Coarse5d);CRNG.SeedFixedIntegers(cseeds);
+
+  LatticeGaugeField Umu(UGrid);
+  SU<Nc>::HotConfiguration(RNG4,Umu);
+
+  RealD mass=0.1;
+  RealD M5=1.8;
+  DomainWallFermionD Ddwf(Umu,*FGrid,*FrbGrid,*UGrid,*UrbGrid,mass,M5);
+  MdagMLinearOperator<DomainWallFermionD,LatticeFermion> HermDefOp(Ddwf);
+  HermOpAdaptor<LatticeFermionD> HOA(HermDefOp);
+
+  const int nbasis = 8;
+  const int cb = 0 ;
+  const std::string stem("setup_reuse");
+  typedef Aggregation<vSpinColourVector,vTComplex,nbasis> Subspace;
+  typedef GeneralCoarsenedMatrix<vSpinColourVector,vTComplex,nbasis> LittleDiracOperator;
+  typedef LittleDiracOperator::CoarseVector CoarseVector;
+
+  RealD Lo  = 0.0;
+  RealD tol = 1.0e-3;
+  int maxit = 50;
+
+  ///////////////////////////////////////////////////
+  // Setup on the first field, saved to disk
+  ///////////////////////////////////////////////////
+  Subspace Aggregates(Coarse5d,FGrid,cb);
+  Aggregates.CreateSubspaceRandom(RNG5);
+  Aggregates.RefineSubspace(HermDefOp,Lo,tol,maxit);
+  Aggregates.SetReference(HermDefOp);
+  Aggregates.SaveSubspace(stem);
+
+  NextToNearestStencilGeometry5D geom(Coarse5d);
+  LittleDiracOperator LittleDiracOp(geom,FGrid,Coarse5d);
+  LittleDiracOp.CoarsenOperator(HOA,Aggregates);
+  LittleDiracOp.SaveOperator(stem+".op");
+
+  ///////////////////////////////////////////////////
+  // Round trip
+  ///////////////////////////////////////////////////
+  std::cout<<GridLogMessage << "Checking subspace and operator read back"<< std::endl;
+  Subspace Loaded(Coarse5d,FGrid,cb);
+  Loaded.LoadSubspace(stem);
+  assert(Loaded.rayleigh.size()==nbasis);
+  for(int b=0;b<nbasis;b++){
+    LatticeFermion diff(FGrid);
+    diff = Loaded.subspace[b] - Aggregates.subspace[b];
+    assert(norm2(diff)==0.0);
+    assert(Loaded.rayleigh[b]==Aggregates.rayleigh[b]);
+  }
+
+  LittleDiracOperator LoadedOp(geom,FGrid,Coarse5d);
+  LoadedOp.LoadOperator(stem+".op");
+  CoarseVector c_src (Coarse5d); random(CRNG,c_src);
+  CoarseVector c_res (Coarse5d);
+  CoarseVector c_ref (Coarse5d);
+  LittleDiracOp.M(c_src,c_ref);
+  LoadedOp.M(c_src,c_res);
+  c_res = c_res - c_ref;
+  std::cout<<GridLogMessage << "Loaded operator difference "<<norm2(c_res)<<std::endl;
+  assert(norm2(c_res)==0.0);
+
+  ///////////////////////////////////////////////////
+  // Update on the same field refines nothing
+  ///////////////////////////////////////////////////
+  std::cout<<GridLogMessage << "Checking update on the same field"<< std::endl;
+  int nstale = Loaded.UpdateSubspace(HermDefOp,Lo,tol,maxit);
+  assert(nstale==0);
+
+  ///////////////////////////////////////////////////
+  // Update on a new field matches the same refinement
+  // applied to the in-memory subspace
+  ///////////////////////////////////////////////////
+  std::cout<<GridLogMessage << "Checking update on a new field"<< std::endl;
+  RNG4.SeedFixedIntegers(seeds4b);
+  SU<Nc>::HotConfiguration(RNG4,Umu);
+  DomainWallFermionD Ddwf2(Umu,*FGrid,*FrbGrid,*UGrid,*UrbGrid,mass,M5);
+  MdagMLinearOperator<DomainWallFermionD,LatticeFermion> HermDefOp2(Ddwf2);
+
+  RealD drift = 0.1;
+  std::vector<int> stale = Aggregates.StaleVectors(HermDefOp2,drift);
+  if ( stale.size() ) {
+    Aggregates.RefineSubspace(HermDefOp2,Lo,tol,maxit,stale);
+    Aggregates.SetReference(HermDefOp2);
+  }
+
+  nstale = Loaded.UpdateSubspace(HermDefOp2,Lo,tol,maxit,drift);
+  std::cout<<GridLogMessage << nstale << " stale vectors on the new field"<< std::endl;
+  assert(nstale==stale.size());
+  assert(nstale>0);
+  for(int b=0;b<nbasis;b++){
+    LatticeFermion diff(FGrid);
+    diff = Loaded.subspace[b] - Aggregates.subspace[b];
+    RealD rel = norm2(diff)/norm2(Aggregates.subspace[b]);
+    std::cout<<GridLogMessage << "subspace ["<<b<<"] updated vs in-memory "<<rel<<std::endl;
+    assert(rel < 1.0e-20);
+    assert(std::fabs(Loaded.rayleigh[b]-Aggregates.rayleigh[b]) <= 1.0e-10*Aggregates.rayleigh[b]);
+  }
+
+  FGrid->Barrier();
+  if ( FGrid->IsBoss() ) {
+    for(std::string ext : {".subspace",".xml",".op",".op.xml"}){
+      std::remove((stem+ext).c_str());
+    }
+  }
+
+  std::cout<<GridLogMessage << "Setup reuse OK"<< std::endl;
+
+  Grid_finalize();
+  return 0;
+}
@@ -0,0 +1,251 @@
+/*************************************************************************************
+
+Grid physics library, www.github.com/paboyle/Grid
+
+Source file: ./tests/hmc/Test_hmc_IntegratorTuner.cc
+
+Copyright (C) 2023
+
+Author: Peter Boyle <paboyle@ph.ed.ac.uk>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+See the full license in the file "LICENSE" in the top level distribution
+directory
+*************************************************************************************/
+/*  END LEGAL */
+#include <Grid/Grid.h>
+
+using namespace Grid;
+
+typedef PeriodicGimplR    Gimpl;
+typedef Gimpl::Field      Field;
+typedef NoSmearing<Gimpl> Smearing;
+
+// Synthetic integrator exposing what IntegratorStepTuner reads: per level
+// force counts, times and norms, link update counts and times. Levels nest
+// as in MinimumNorm2, at half the step over the multiplier.
+struct MockForce {
+  int   deriv_num;
+  RealD deriv_us;
+  RealD norm;
+  RealD deriv_norm_average(void) { return norm; }
+};
+struct MockLevel {
+  int multiplier;
+  std::vector<MockForce *> actions;
+};
+struct MockIntegrator {
+  IntegratorParameters   Params;
+  int                    levels;
+  std::vector<MockLevel> as;
+  std::vector<MockLevel> LevelForces;
+  RealD update_U_us;
+  RealD update_U_num;
+
+  int integrator_order(void) { return 2; }
+  RealD step_size(int level)
+  {
+    RealD eps = Params.trajL/Params.MDsteps * 2.0;
+    for (int l = 0; l <= level; ++l) eps /= 2.0 * as[l].multiplier;
+    return eps;
+  }
+  void set_steps(int MDsteps, const std::vector<int> &multipliers)
+  {
+    Params.MDsteps = MDsteps;
+    for (int level = 1; level < levels; ++level) as[level].multiplier = multipliers[level];
+  }
+};
+
+// Model of the tuner with known answers
+const RealD kappa_true = 0.37;
+const std::vector<RealD> ForceNorm({2.0,12.0});   // force norm per level
+const std::vector<RealD> ForceCost({900.0,35.0}); // us per force evaluation
+const RealD cost_U = 4.0;                         // us per link update
+
+RealD Model(int n,const std::vector<int> &mult,RealD trajL)
+{
+  RealD h = trajL/n, model = 0.0;
+  for(int l=0;l<ForceNorm.size();l++){
+    h /= mult[l];
+    if ( l > 0 ) h /= 2.0;
+    RealD Fh = ForceNorm[l]*h*h;
+    model += Fh*Fh;
+  }
+  return model;
+}
+RealD Cost(int n,const std::vector<int> &mult)
+{
+  RealD nsteps = n, total = 0.0;
+  for(int l=0;l<ForceNorm.size();l++){
+    nsteps *= mult[l];
+    total  += ForceCost[l]*nsteps;
+  }
+  return total + cost_U*nsteps;
+}
+
+// One trajectory at the integrator's current steps; dH^2 follows the model exactly
+RealD Trajectory(MockIntegrator &I,std::vector<MockForce> &forces)
+{
+  std::vector<int> mult(I.levels);
+  int nsteps = I.Params.MDsteps;
+  for(int l=0;l<I.levels;l++){
+    mult[l]   = I.as[l].multiplier;
+    nsteps   *= mult[l];
+    forces[l].deriv_num = nsteps;
+    forces[l].deriv_us  = ForceCost[l]*nsteps;
+    forces[l].norm      = ForceNorm[l];
+  }
+  I.update_U_num = nsteps;
+  I.update_U_us  = cost_U*nsteps;
+  return std::sqrt(kappa_true*Model(I.Params.MDsteps,mult,I.Params.trajL));
+}
+
+// Force independent of the links, so every kick of a level has the same
+// size up to its step
+class ConstantForceAction : public Action<Field> {
+public:
+  Field Force;
+  ConstantForceAction(const Field &_Force) : Force(_Force) {};
+  void refresh(const Field &U, GridSerialRNG &sRNG, GridParallelRNG &pRNG) {};
+  RealD S(const Field &U) { return 0.0; };
+  void deriv(const Field &U, Field &dSdU) { dSdU = Force; };
+  std::string action_name() { return std::string("ConstantForceAction"); };
+  std::string LogParameters() { return std::string("No parameters"); };
+};
+
+// The largest kick on each level over its step_size must be the same
+// fraction on every level, ie step_size follows the integrator's nesting
+template<class Integrator>
+void CheckStepSize(GridCartesian *UGrid,ActionSet<Field,NoHirep> &Actions,RealD kick)
+{
+  Smearing S;
+  IntegratorParameters MD(3,1.0);
+  Integrator MDynamics(UGrid,MD,Actions,S);
+
+  GridSerialRNG   sRNG; sRNG.SeedFixedIntegers(std::vector<int>({1,2,3,4}));
+  GridParallelRNG pRNG(UGrid); pRNG.SeedFixedIntegers(std::vector<int>({5,6,7,8}));
+  Field U(UGrid);
+  SU<Nc>::ColdConfiguration(pRNG,U);
+
+  MDynamics.reset_timer();
+  MDynamics.refresh(U,sRNG,pRNG);
+  MDynamics.integrate(U);
+
+  for(int level=0;level<Actions.size();level++){
+    auto force = MDynamics.LevelForces[level].actions.at(0);
+    RealD dt = force->Fdt_max_sum/force->deriv_max_sum/HMC_MOMENTUM_DENOMINATOR;
+    RealD h  = MDynamics.step_size(level);
+    std::cout << GridLogMessage << MDynamics.integrator_name()<<" level "<<level
+	      <<" step_size "<<h<<" largest kick "<<dt<<" ratio "<<dt/h<<" expect "<<kick<<std::endl;
+    assert(std::fabs(dt/h/kick-1.0) < 1.0e-6);
+  }
+}
+
+int main(int argc, char **argv)
+{
+  Grid_init(&argc, &argv);
+
+  ////////////////////////////////////////////
+  // Step sizes of the real integrators, three levels
+  ////////////////////////////////////////////
+  GridCartesian *UGrid = SpaceTimeGrid::makeFourDimGrid(GridDefaultLatt(),
+							 GridDefaultSimd(Nd,vComplex::Nsimd()),
+							 GridDefaultMpi());
+  {
+    GridSerialRNG   sRNG; sRNG.SeedFixedIntegers(std::vector<int>({11,12,13,14}));
+    GridParallelRNG pRNG(UGrid); pRNG.SeedFixedIntegers(std::vector<int>({15,16,17,18}));
+    Field F(UGrid);
+    Gimpl::generate_momenta(F,sRNG,pRNG);
+
+    ConstantForceAction Outer(F), Middle(F), Inner(F);
+    ActionLevel<Field> Level1(1), Level2(2), Level3(3);
+    Level1.push_back(&Outer);
+    Level2.push_back(&Middle);
+    Level3.push_back(&Inner);
+    ActionSet<Field,NoHirep> Actions;
+    Actions.push_back(Level1);
+    Actions.push_back(Level2);
+    Actions.push_back(Level3);
+
+    // Largest kick of each: the merged eps of LeapFrog, the middle
+    // (1-2 lambda) eps of the others
+    CheckStepSize<LeapFrog           <Gimpl,Smearing> >(UGrid,Actions,1.0);
+    CheckStepSize<MinimumNorm2       <Gimpl,Smearing> >(UGrid,Actions,1.0-2.0*0.1931833275037836);
+    CheckStepSize<ForceGradient      <Gimpl,Smearing> >(UGrid,Actions,2.0/3.0);
+    CheckStepSize<CachedForceGradient<Gimpl,Smearing> >(UGrid,Actions,2.0/3.0);
+  }
+
+  ////////////////////////////////////////////
+  // Target <dH^2> inverts P_acc = erfc( sqrt(<dH^2>/2)/2 )
+  ////////////////////////////////////////////
+  for(RealD acc : {0.5,0.7,0.8,0.9,0.95}){
+    RealD T = IntegratorStepTuner<MockIntegrator>::TargetDeltaH2(acc);
+    RealD P = std::erfc(std::sqrt(T/2.0)/2.0);
+    std::cout << GridLogMessage << "acceptance "<<acc<<" target <dH^2> "<<T<<" recovers "<<P<<std::endl;
+    assert(std::fabs(P-acc) < 1.0e-10);
+  }
+
+  ////////////////////////////////////////////
+  // Two level integrator, recorded at two step sizes
+  ////////////////////////////////////////////
+  std::vector<MockForce> forces(2);
+  MockIntegrator I;
+  I.Params = IntegratorParameters(6,1.0);
+  I.levels = 2;
+  I.as.resize(2);
+  I.as[0].multiplier = 1;
+  I.as[1].multiplier = 3;
+  for(int l=0;l<2;l++) I.as[l].actions.push_back(&forces[l]);
+  I.LevelForces = I.as;
+
+  IntegratorTuneParameters TuneParams(0.8,4,64,16);
+  IntegratorStepTuner<MockIntegrator> Tuner(TuneParams);
+  for(int traj=0;traj<TuneParams.RoundLength;traj++){
+    if ( traj == TuneParams.RoundLength/2 ) I.set_steps(10,std::vector<int>({1,2}));
+    RealD dH = Trajectory(I,forces);
+    Tuner.Record(I,dH);
+  }
+
+  RealD kappa = Tuner.Kappa();
+  std::cout << GridLogMessage << "kappa fit "<<kappa<<" true "<<kappa_true<<std::endl;
+  assert(std::fabs(kappa/kappa_true-1.0) < 1.0e-12);
+
+  ////////////////////////////////////////////
+  // Tuned steps against an exhaustive search
+  ////////////////////////////////////////////
+  RealD T = IntegratorStepTuner<MockIntegrator>::TargetDeltaH2(TuneParams.TargetAcceptance);
+  RealD best = 0.0;
+  for(int n=1;n<=TuneParams.MaxMDsteps;n++){
+    for(int m=1;m<=TuneParams.MaxMultiplier;m++){
+      std::vector<int> mult({1,m});
+      if ( kappa_true*Model(n,mult,1.0) > T ) continue;
+      RealD c = Cost(n,mult);
+      if ( best==0.0 || c < best ) best = c;
+    }
+  }
+  std::vector<int> mult({1,I.as[1].multiplier});
+  RealD model = kappa_true*Model(I.Params.MDsteps,mult,1.0);
+  RealD c     = Cost(I.Params.MDsteps,mult);
+  std::cout << GridLogMessage << "tuned MDsteps "<<I.Params.MDsteps<<" multiplier "<<I.as[1].multiplier
+	    << " <dH^2> "<<model<<" target "<<T<<" cost "<<c<<" optimum "<<best<<std::endl;
+  assert(model <= T);
+  assert(std::fabs(c/best-1.0) < 1.0e-12);
+  assert(std::erfc(std::sqrt(model/2.0)/2.0) >= TuneParams.TargetAcceptance);
+
+  std::cout << GridLogMessage << "IntegratorStepTuner OK" << std::endl;
+
+  Grid_finalize();
+}
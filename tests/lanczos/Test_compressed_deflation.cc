@@ -0,0 +1,128 @@
+    /*************************************************************************************
+
+    Grid physics library, www.github.com/paboyle/Grid
+
+    Source file: ./tests/Test_compressed_deflation.cc
+
+    Copyright (C) 2015
+
+Author: Peter Boyle <paboyle@ph.ed.ac.uk>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+    See the full license in the file "LICENSE" in the top level distribution directory
+    *************************************************************************************/
+    /*  END LEGAL */
+#include <Grid/Grid.h>
+
+using namespace Grid;
+
+// Compressed storage of a local coherence eigenspace against the full
+// precision LocalCoherenceDeflatedGuesser. A synthetic block orthonormal
+// basis and random coarse vectors stand in for the Lanczos output.
+int main (int argc, char ** argv)
+{
+  Grid_init(&argc,&argv);
+
+  const int nbasis = 8;
+  const int Nevec  = 16;
+
+  Coordinate latt   = GridDefaultLatt();
+  Coordinate blocks({2,2,2,2});
+  Coordinate clatt  = latt;
+  for(int d=0;d<Nd;d++) clatt[d] = latt[d]/blocks[d];
+
+  GridCartesian * FGrid   = SpaceTimeGrid::makeFourDimGrid(latt, GridDefaultSimd(Nd,vComplexD::Nsimd()),GridDefaultMpi());
+  GridCartesian * FGrid_f = SpaceTimeGrid::makeFourDimGrid(latt, GridDefaultSimd(Nd,vComplexF::Nsimd()),GridDefaultMpi());
+  GridCartesian * CGrid   = SpaceTimeGrid::makeFourDimGrid(clatt,GridDefaultSimd(Nd,vComplexD::Nsimd()),GridDefaultMpi());
+  GridCartesian * CGrid_f = SpaceTimeGrid::makeFourDimGrid(clatt,GridDefaultSimd(Nd,vComplexF::Nsimd()),GridDefaultMpi());
+
+  typedef iVector<vTComplexD,nbasis> CoarseSiteD;
+  typedef Lattice<CoarseSiteD>       CoarseFieldD;
+  typedef CompressedLocalCoherenceEigenvectors<vSpinColourVectorF,vTComplexF,nbasis> Compressed;
+
+  GridParallelRNG RNG(FGrid);  RNG.SeedFixedIntegers(std::vector<int>({1,2,3,4}));
+  GridParallelRNG CRNG(CGrid); CRNG.SeedFixedIntegers(std::vector<int>({5,6,7,8}));
+
+  std::vector<LatticeFermionD> subspace(nbasis,FGrid);
+  for(int v=0;v<nbasis;v++) random(RNG,subspace[v]);
+  {
+    LatticeComplexD ip(CGrid);
+    blockOrthogonalise(ip,subspace);
+    blockOrthogonalise(ip,subspace);
+  }
+
+  std::vector<CoarseFieldD> evec(Nevec,CGrid);
+  std::vector<RealD>        eval(Nevec);
+  for(int i=0;i<Nevec;i++){
+    random(CRNG,evec[i]);
+    evec[i] = evec[i]*(1.0/std::sqrt(norm2(evec[i])));
+    eval[i] = 1.0+0.1*i;
+  }
+
+  LatticeFermionD src(FGrid);   random(RNG,src);
+  LatticeFermionD ref(FGrid);
+  LatticeFermionD guess(FGrid);
+  LatticeFermionD diff(FGrid);
+
+  LocalCoherenceDeflatedGuesser<LatticeFermionD,CoarseFieldD> Guesser(subspace,evec,eval);
+  Guesser(src,ref);
+  RealD nref = norm2(ref);
+
+  // fp32 and fp16 basis
+  for(int half=0;half<2;half++){
+    Compressed evecs(FGrid_f,CGrid_f,half);
+    evecs.Compress(subspace,evec,eval);
+
+    CompressedLocalCoherenceDeflatedGuesser<LatticeFermionD,Compressed> CGuesser(evecs);
+    CGuesser(src,guess);
+
+    RealD rel = std::sqrt(axpy_norm(diff,-1.0,ref,guess)/nref);
+    std::cout << GridLogMessage << (half ? "fp16":"fp32") << " basis: relative difference to full precision guess " << rel << std::endl;
+    assert(rel < (half ? 1.0e-2 : 1.0e-5));
+  }
+
+  // Parallel write and read back
+  {
+    Compressed evecs(FGrid_f,CGrid_f);
+    evecs.Compress(subspace,evec,eval);
+    evecs.Write("compressed_deflation");
+
+    Compressed evecs_in(FGrid_f,CGrid_f);
+    evecs_in.Read("compressed_deflation",subspace[0].Checkerboard());
+    assert(evecs_in.Nevec()==Nevec);
+
+    LatticeFermionD guess_in(FGrid);
+    CompressedLocalCoherenceDeflatedGuesser<LatticeFermionD,Compressed> CGuesser(evecs);
+    CompressedLocalCoherenceDeflatedGuesser<LatticeFermionD,Compressed> CGuesser_in(evecs_in);
+    CGuesser(src,guess);
+    CGuesser_in(src,guess_in);
+
+    RealD rel = std::sqrt(axpy_norm(diff,-1.0,guess,guess_in)/norm2(guess));
+    std::cout << GridLogMessage << "Read back: relative difference " << rel << std::endl;
+    assert(rel < 1.0e-6);
+
+    FGrid->Barrier();
+    if ( FGrid->IsBoss() ) {
+      for(std::string ext : {".basis",".coarse",".xml"}){
+	std::remove((std::string("compressed_deflation")+ext).c_str());
+      }
+    }
+  }
+
+  std::cout << GridLogMessage << "CompressedLocalCoherenceEigenvectors OK" << std::endl;
+
+  Grid_finalize();
+}
@@ -369,6 +369,7 @@ int main (int argc, char ** argv)
 						     IRBLdiagonaliseWithEigen);
 //						     IRBLdiagonaliseWithLAPACK);
   IRBL.split_test=1;
+  IRBL.blas_ortho=1;
   
   std::vector<RealD> eval(JP.Nm);
   
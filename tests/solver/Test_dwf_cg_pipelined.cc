@@ -0,0 +1,119 @@
+    /*************************************************************************************
+
+    Grid physics library, www.github.com/paboyle/Grid
+
+    Source file: ./tests/Test_dwf_cg_pipelined.cc
+
+    Copyright (C) 2015
+
+Author: Peter Boyle <paboyle@ph.ed.ac.uk>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+    See the full license in the file "LICENSE" in the top level distribution directory
+    *************************************************************************************/
+    /*  END LEGAL */
+#include <Grid/Grid.h>
+
+using namespace Grid;
+
+// Pipelined against regular CG on the DWF Schur system. The pipelined solver
+// pays off when the global sums dominate, ie. at small local volume:
+//   mpirun -np 16 Test_dwf_cg_pipelined --grid 16.16.16.16 --mpi 2.2.2.2
+int main (int argc, char ** argv)
+{
+  Grid_init(&argc,&argv);
+
+  const int Ls=12;
+
+  GridCartesian         * UGrid   = SpaceTimeGrid::makeFourDimGrid(GridDefaultLatt(), GridDefaultSimd(Nd,vComplexD::Nsimd()),GridDefaultMpi());
+  GridRedBlackCartesian * UrbGrid = SpaceTimeGrid::makeFourDimRedBlackGrid(UGrid);
+  GridCartesian         * FGrid   = SpaceTimeGrid::makeFiveDimGrid(Ls,UGrid);
+  GridRedBlackCartesian * FrbGrid = SpaceTimeGrid::makeFiveDimRedBlackGrid(Ls,UGrid);
+
+  GridCartesian         * UGrid_f   = SpaceTimeGrid::makeFourDimGrid(GridDefaultLatt(), GridDefaultSimd(Nd,vComplexF::Nsimd()),GridDefaultMpi());
+  GridRedBlackCartesian * UrbGrid_f = SpaceTimeGrid::makeFourDimRedBlackGrid(UGrid_f);
+  GridCartesian         * FGrid_f   = SpaceTimeGrid::makeFiveDimGrid(Ls,UGrid_f);
+  GridRedBlackCartesian * FrbGrid_f = SpaceTimeGrid::makeFiveDimRedBlackGrid(Ls,UGrid_f);
+
+  std::vector<int> seeds4({1,2,3,4});
+  std::vector<int> seeds5({5,6,7,8});
+  GridParallelRNG          RNG5(FGrid);  RNG5.SeedFixedIntegers(seeds5);
+  GridParallelRNG          RNG4(UGrid);  RNG4.SeedFixedIntegers(seeds4);
+
+  LatticeFermionD    src(FGrid); random(RNG5,src);
+  LatticeGaugeFieldD Umu(UGrid);
+  LatticeGaugeFieldF Umu_f(UGrid_f);
+
+  SU<Nc>::HotConfiguration(RNG4,Umu);
+  precisionChange(Umu_f,Umu);
+
+  RealD mass=0.1;
+  RealD M5=1.8;
+  DomainWallFermionD Ddwf(Umu,*FGrid,*FrbGrid,*UGrid,*UrbGrid,mass,M5);
+  DomainWallFermionF Ddwf_f(Umu_f,*FGrid_f,*FrbGrid_f,*UGrid_f,*UrbGrid_f,mass,M5);
+
+  LatticeFermionD    src_o(FrbGrid);
+  LatticeFermionD result_o(FrbGrid);
+  LatticeFermionD result_o_2(FrbGrid);
+  LatticeFermionD diff_o(FrbGrid);
+  pickCheckerboard(Odd,src_o,src);
+  result_o.Checkerboard() = Odd;
+  result_o_2.Checkerboard() = Odd;
+
+  SchurDiagMooeeOperator<DomainWallFermionD,LatticeFermionD> HermOpEO(Ddwf);
+  SchurDiagMooeeOperator<DomainWallFermionF,LatticeFermionF> HermOpEO_f(Ddwf_f);
+
+  double t1,t2;
+
+  std::cout << GridLogMessage << "::::::::::::: Starting regular CG" << std::endl;
+  ConjugateGradient<LatticeFermionD> CG(1.0e-8,10000);
+  result_o = Zero();
+  t1=usecond();
+  CG(HermOpEO,src_o,result_o);
+  t2=usecond();
+  std::cout << GridLogMessage << " CG           iterations " << CG.IterationsToComplete
+	    << " time " << (t2-t1)/1.0e6 << " s" << std::endl;
+
+  std::cout << GridLogMessage << "::::::::::::: Starting pipelined CG" << std::endl;
+  PipelinedConjugateGradient<LatticeFermionD> PCG(1.0e-8,10000);
+  result_o_2 = Zero();
+  t1=usecond();
+  PCG(HermOpEO,src_o,result_o_2);
+  t2=usecond();
+  std::cout << GridLogMessage << " PipelinedCG  iterations " << PCG.IterationsToComplete
+	    << " time " << (t2-t1)/1.0e6 << " s" << std::endl;
+
+  RealD diff = axpy_norm(diff_o, -1.0, result_o, result_o_2) / norm2(result_o);
+  std::cout << GridLogMessage << "::::::::::::: Relative diff between pipelined and regular CG: " << diff << std::endl;
+  assert(PCG.TrueResidual < 1.0e-7);
+
+  std::cout << GridLogMessage << "::::::::::::: Starting mixed CG with pipelined inner solver" << std::endl;
+  PipelinedConjugateGradient<LatticeFermionF> PCG_f(1.0e-4,10000,false);
+  MixedPrecisionConjugateGradient<LatticeFermionD,LatticeFermionF> mCG(1.0e-8, 10000, 50, FrbGrid_f, HermOpEO_f, HermOpEO);
+  mCG.useInnerSolver(PCG_f);
+  result_o_2 = Zero();
+  t1=usecond();
+  mCG(src_o,result_o_2);
+  t2=usecond();
+  std::cout << GridLogMessage << " MixedPipelinedCG inner iterations " << mCG.TotalInnerIterations
+	    << " time " << (t2-t1)/1.0e6 << " s" << std::endl;
+
+  diff = axpy_norm(diff_o, -1.0, result_o, result_o_2) / norm2(result_o);
+  std::cout << GridLogMessage << "::::::::::::: Relative diff between mixed pipelined and regular CG: " << diff << std::endl;
+  assert(mCG.TrueResidual < 1.0e-7);
+
+  Grid_finalize();
+}
@@ -0,0 +1,121 @@
+    /*************************************************************************************
+
+    Grid physics library, www.github.com/paboyle/Grid
+
+    Source file: ./tests/Test_dwf_hdcg_multilevel.cc
+
+    Copyright (C) 2015
+
+Author: Peter Boyle <paboyle@ph.ed.ac.uk>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+    See the full license in the file "LICENSE" in the top level distribution directory
+    *************************************************************************************/
+    /*  END LEGAL */
+#include <Grid/Grid.h>
+
+using namespace Grid;
+
+// Two level HDCG on the DWF Schur operator, parameters round tripped
+// through XML, against red-black CG.
+int main (int argc, char ** argv)
+{
+  Grid_init(&argc,&argv);
+
+  const int Ls=8;
+
+  GridCartesian         * UGrid   = SpaceTimeGrid::makeFourDimGrid(GridDefaultLatt(), GridDefaultSimd(Nd,vComplexD::Nsimd()),GridDefaultMpi());
+  GridRedBlackCartesian * UrbGrid = SpaceTimeGrid::makeFourDimRedBlackGrid(UGrid);
+  GridCartesian         * FGrid   = SpaceTimeGrid::makeFiveDimGrid(Ls,UGrid);
+  GridRedBlackCartesian * FrbGrid = SpaceTimeGrid::makeFiveDimRedBlackGrid(Ls,UGrid);
+
+  std::vector<int> seeds4({1,2,3,4});
+  std::vector<int> seeds5({5,6,7,8});
+  GridParallelRNG          RNG5(FGrid);  RNG5.SeedFixedIntegers(seeds5);
+  GridParallelRNG          RNG4(UGrid);  RNG4.SeedFixedIntegers(seeds4);
+
+  LatticeGaugeFieldD Umu(UGrid);
+  SU<Nc>::HotConfiguration(RNG4,Umu);
+
+  RealD mass=0.01;
+  RealD M5=1.8;
+  DomainWallFermionD Ddwf(Umu,*FGrid,*FrbGrid,*UGrid,*UrbGrid,mass,M5);
+  SchurDiagMooeeOperator<DomainWallFermionD,LatticeFermionD> HermOpEO(Ddwf);
+
+  MultiLevelHDCGParams Params;
+  {
+    HDCGLevelParams L0;
+    L0.blockSize      = std::vector<int>({Ls,2,2,2,2});
+    L0.hops           = 4;
+    L0.subspace_lo    = 0.01;
+    L0.subspace_hi    = 60.0;
+    L0.subspace_order = 500;
+    L0.smoother_lo    = 0.5;
+    L0.smoother_hi    = 60.0;
+    L0.smoother_order = 10;
+    L0.tol            = 1.0e-8;
+    L0.maxit          = 500;
+
+    Params.levels         = std::vector<HDCGLevelParams>({L0});
+    Params.coarsest_tol   = 1.0e-2;
+    Params.coarsest_maxit = 1000;
+    Params.coarsest_agglomerate = 256; // gather the coarse grid when run on many ranks
+  }
+  {
+    XmlWriter WR("HDCG.xml");
+    write(WR,"MultiLevelHDCGParams",Params);
+  }
+  MultiLevelHDCGParams ParamsIn;
+  {
+    XmlReader RD("HDCG.xml");
+    read(RD,"MultiLevelHDCGParams",ParamsIn);
+  }
+  assert(ParamsIn==Params);
+  std::cout << GridLogMessage << ParamsIn << std::endl;
+
+  MultiLevelHDCG<vSpinColourVector,vTComplex,24> HDCG(HermOpEO,FrbGrid,ParamsIn,0,Odd);
+  HDCG.Setup(RNG5);
+
+  LatticeFermionD src(FGrid); random(RNG5,src);
+  LatticeFermionD src_o(FrbGrid);
+  LatticeFermionD result_o(FrbGrid);
+  LatticeFermionD result_o_2(FrbGrid);
+  LatticeFermionD diff_o(FrbGrid);
+  pickCheckerboard(Odd,src_o,src);
+  result_o.Checkerboard()   = Odd;
+  result_o_2.Checkerboard() = Odd;
+
+  std::cout << GridLogMessage << "::::::::::::: Starting multilevel HDCG" << std::endl;
+  result_o = Zero();
+  double t1=usecond();
+  HDCG(src_o,result_o);
+  double t2=usecond();
+  std::cout << GridLogMessage << " Multilevel HDCG time " << (t2-t1)/1.0e6 << " s" << std::endl;
+
+  std::cout << GridLogMessage << "::::::::::::: Starting red black CG" << std::endl;
+  ConjugateGradient<LatticeFermionD> CG(1.0e-8,30000);
+  result_o_2 = Zero();
+  t1=usecond();
+  CG(HermOpEO,src_o,result_o_2);
+  t2=usecond();
+  std::cout << GridLogMessage << " CG iterations " << CG.IterationsToComplete << " time " << (t2-t1)/1.0e6 << " s" << std::endl;
+
+  RealD diff = std::sqrt(axpy_norm(diff_o, -1.0, result_o, result_o_2) / norm2(result_o_2));
+  std::cout << GridLogMessage << "::::::::::::: Relative diff between multilevel HDCG and CG: " << diff << std::endl;
+  assert(diff < 1.0e-6);
+
+  Grid_finalize();
+}